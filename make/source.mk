@@ -54,6 +54,7 @@ COMMON_SRC = \
             io/usb_cdc_hid.c \
             io/usb_msc.c \
             msp/msp_serial.c \
+            msp/msp_stream.c \
             scheduler/scheduler.c \
             sensors/adcinternal.c \
             sensors/battery.c \
@@ -65,6 +66,7 @@ COMMON_SRC = \
             drivers/camera_control.c \
             drivers/accgyro/gyro_sync.c \
             drivers/pwm_esc_detect.c \
+            drivers/dshot.c \
             drivers/pwm_output.c \
             drivers/rx/rx_spi.c \
             drivers/rx/rx_xn297.c \
@@ -72,6 +74,7 @@ COMMON_SRC = \
             drivers/serial_softserial.c \
             fc/fc_core.c \
             fc/fc_rc.c \
+            fc/loop_state.c \
             fc/rc_adjustments.c \
             fc/rc_controls.c \
             fc/rc_modes.c \
@@ -82,6 +85,7 @@ COMMON_SRC = \
             flight/mixer.c \
             flight/mixer_tricopter.c \
             flight/pid.c \
+            flight/rpm_filter.c \
             flight/servos.c \
             flight/servos_tricopter.c \
             interface/cli.c \
@@ -109,6 +113,8 @@ COMMON_SRC = \
             sensors/boardalignment.c \
             sensors/compass.c \
             sensors/gyro.c \
+            sensors/gyro_bias.c \
+            sensors/gyro_combine.c \
             sensors/gyroanalyse.c \
             sensors/initialisation.c \
             blackbox/blackbox.c \
@@ -146,6 +152,7 @@ COMMON_SRC = \
             sensors/barometer.c \
             sensors/rangefinder.c \
             telemetry/telemetry.c \
+            telemetry/telemetry_scheduler.c \
             telemetry/crsf.c \
             telemetry/srxl.c \
             telemetry/frsky_hub.c \
@@ -181,6 +188,7 @@ SIZE_OPTIMISED_SRC  := ""
 ifneq ($(TARGET),$(filter $(TARGET),$(F1_TARGETS)))
 SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             common/encoding.c \
+            common/explog_approx.c \
             common/filter.c \
             common/maths.c \
             common/typeconversion.c \
@@ -206,6 +214,7 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             drivers/bus_spi.c \
             drivers/exti.c \
             drivers/io.c \
+            drivers/dshot.c \
             drivers/pwm_output.c \
             drivers/rcc.c \
             drivers/serial.c \
@@ -215,11 +224,13 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             fc/fc_core.c \
             fc/fc_tasks.c \
             fc/fc_rc.c \
+            fc/loop_state.c \
             fc/rc_controls.c \
             fc/runtime_config.c \
             flight/imu.c \
             flight/mixer.c \
             flight/pid.c \
+            flight/rpm_filter.c \
             rx/ibus.c \
             rx/rx.c \
             rx/rx_spi.c \
@@ -234,6 +245,8 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             sensors/acceleration.c \
             sensors/boardalignment.c \
             sensors/gyro.c \
+            sensors/gyro_bias.c \
+            sensors/gyro_combine.c \
             sensors/gyroanalyse.c \
             $(CMSIS_SRC) \
             $(DEVICE_STDPERIPH_SRC) \
@@ -287,6 +300,7 @@ SIZE_OPTIMISED_SRC := $(SIZE_OPTIMISED_SRC) \
             io/transponder_ir.c \
             io/usb_cdc_hid.c \
             msp/msp_serial.c \
+            msp/msp_stream.c \
             cms/cms.c \
             cms/cms_menu_blackbox.c \
             cms/cms_menu_builtin.c \
@@ -54,6 +54,7 @@
 #include "fc/config.h"
 #include "fc/controlrate_profile.h"
 #include "fc/fc_rc.h"
+#include "fc/loop_state.h"
 #include "fc/rc_controls.h"
 #include "fc/rc_modes.h"
 #include "fc/runtime_config.h"
@@ -999,31 +1000,34 @@ static void loadMainState(timeUs_t currentTimeUs)
 #ifndef UNIT_TEST
     blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
 
+    // logged right after the PID loop published it, so this is the loop that just ran
+    static loopState_t state;
+    loopStateRead(&state);
+
     blackboxCurrent->time = currentTimeUs;
 
     for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
-        blackboxCurrent->axisPID_P[i] = pidData[i].P;
-        blackboxCurrent->axisPID_I[i] = pidData[i].I;
-        blackboxCurrent->axisPID_D[i] = pidData[i].D;
-        blackboxCurrent->axisPID_F[i] = pidData[i].F;
-        blackboxCurrent->gyroADC[i] = lrintf(gyro.gyroADCf[i]);
-        blackboxCurrent->accADC[i] = lrintf(acc.accADC[i]);
+        blackboxCurrent->axisPID_P[i] = state.pidData[i].P;
+        blackboxCurrent->axisPID_I[i] = state.pidData[i].I;
+        blackboxCurrent->axisPID_D[i] = state.pidData[i].D;
+        blackboxCurrent->axisPID_F[i] = state.pidData[i].F;
+        blackboxCurrent->gyroADC[i] = lrintf(state.gyroADCf[i]);
+        blackboxCurrent->accADC[i] = lrintf(state.accADC[i]);
 #ifdef USE_MAG
-        blackboxCurrent->magADC[i] = lrintf(mag.magADC[i]);
+        blackboxCurrent->magADC[i] = lrintf(state.magADC[i]);
 #endif
     }
 
     for (int i = 0; i < 4; i++) {
-        blackboxCurrent->rcCommand[i] = rcCommand[i];
+        blackboxCurrent->rcCommand[i] = state.rcCommand[i];
     }
 
     for (int i = 0; i < DEBUG16_VALUE_COUNT; i++) {
-        blackboxCurrent->debug[i] = debug[i];
+        blackboxCurrent->debug[i] = state.debug[i];
     }
 
-    const int motorCount = getMotorCount();
-    for (int i = 0; i < motorCount; i++) {
-        blackboxCurrent->motor[i] = motor[i];
+    for (int i = 0; i < state.motorCount; i++) {
+        blackboxCurrent->motor[i] = state.motor[i];
     }
 
     blackboxCurrent->vbatLatest = getBatteryVoltageLatest();
@@ -76,4 +76,6 @@ const char * const debugModeNames[DEBUG_COUNT] = {
     "RC_SMOOTHING_RATE",
     "ANTI_GRAVITY",
     "IMU",
+    "RX_LATENCY",
+    "RPM_FILTER",
 };
@@ -94,6 +94,8 @@ typedef enum {
     DEBUG_RC_SMOOTHING_RATE,
     DEBUG_ANTI_GRAVITY,
     DEBUG_IMU,
+    DEBUG_RX_LATENCY,
+    DEBUG_RPM_FILTER,
     DEBUG_COUNT
 } debugType_e;
 
@@ -30,6 +30,10 @@ Stripped down for BF use
 #include <math.h>
 #include <stdint.h>
 
+#include "maths.h"
+
+#if defined(FAST_MATH) || defined(VERY_FAST_MATH)
+
 /* Workaround a lack of optimization in gcc */
 float exp_cst1 = 2139095040.f;
 float exp_cst2 = 0.f;
@@ -97,3 +101,4 @@ float pow_approx(float a, float b)
 {
     return exp_approx(b * log_approx(a));
 }
+#endif
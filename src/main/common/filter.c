@@ -98,6 +98,127 @@ FAST_CODE float slewFilterApply(slewFilter_t *filter, float input)
     return filter->state;
 }
 
+// Sliding median (Hardle and Steiger). heap[0] holds the median, heap[-1], heap[-2].. a max heap of
+// the smaller half and heap[1], heap[2].. a min heap of the larger half. The children of i are 2i and
+// 2i + 1, or 2i - 1 on the max heap side, so i / 2 is the parent on both sides.
+
+void medianFilterInit(medianFilter_t *filter, uint8_t windowSize, float *buf)
+{
+    filter->values = buf;
+    filter->heapIndex = (int8_t *)(buf + windowSize);
+    filter->heap = (uint8_t *)(filter->heapIndex + windowSize) + windowSize / 2;
+    filter->windowSize = windowSize;
+    filter->next = 0;
+    filter->count = 0;
+
+    // the first samples fill the median, then the heaps in turn: 0, -1, 1, -2, 2..
+    for (int i = 0; i < windowSize; i++) {
+        filter->heapIndex[i] = ((i + 1) / 2) * ((i & 1) ? -1 : 1);
+        filter->heap[filter->heapIndex[i]] = i;
+    }
+}
+
+static bool medianFilterLess(const medianFilter_t *filter, int i, int j)
+{
+    return filter->values[filter->heap[i]] < filter->values[filter->heap[j]];
+}
+
+// swaps heap entries i and j if the sample at i is less than the one at j
+static bool medianFilterOrder(medianFilter_t *filter, int i, int j)
+{
+    if (!medianFilterLess(filter, i, j)) {
+        return false;
+    }
+    const uint8_t sample = filter->heap[i];
+    filter->heap[i] = filter->heap[j];
+    filter->heap[j] = sample;
+    filter->heapIndex[filter->heap[i]] = i;
+    filter->heapIndex[filter->heap[j]] = j;
+    return true;
+}
+
+// moves the parent of child i down the min heap until it is in order
+static void medianFilterMinSortDown(medianFilter_t *filter, int i)
+{
+    const int minCount = (filter->count - 1) / 2;
+    for (; i <= minCount; i *= 2) {
+        if (i > 1 && i < minCount && medianFilterLess(filter, i + 1, i)) {
+            i++;
+        }
+        if (!medianFilterOrder(filter, i, i / 2)) {
+            break;
+        }
+    }
+}
+
+static void medianFilterMaxSortDown(medianFilter_t *filter, int i)
+{
+    const int maxCount = filter->count / 2;
+    for (; i >= -maxCount; i *= 2) {
+        if (i < -1 && i > -maxCount && medianFilterLess(filter, i, i - 1)) {
+            i--;
+        }
+        if (!medianFilterOrder(filter, i / 2, i)) {
+            break;
+        }
+    }
+}
+
+// moves entry i up its heap, returns true if it became the median
+static bool medianFilterMinSortUp(medianFilter_t *filter, int i)
+{
+    while (i > 0 && medianFilterOrder(filter, i, i / 2)) {
+        i /= 2;
+    }
+    return i == 0;
+}
+
+static bool medianFilterMaxSortUp(medianFilter_t *filter, int i)
+{
+    while (i < 0 && medianFilterOrder(filter, i / 2, i)) {
+        i /= 2;
+    }
+    return i == 0;
+}
+
+/*
+ * Replaces the oldest sample with input and returns the median of the window, the mean of the two
+ * middle samples while the window holds an even number of them.
+ */
+FAST_CODE float medianFilterApply(medianFilter_t *filter, float input)
+{
+    const bool filling = filter->count < filter->windowSize;
+    const int i = filter->heapIndex[filter->next];
+    const float previous = filter->values[filter->next];
+
+    filter->values[filter->next] = input;
+    filter->next = filter->next + 1 < filter->windowSize ? filter->next + 1 : 0;
+    filter->count += filling;
+
+    if (i > 0) {
+        if (!filling && input > previous) {
+            medianFilterMinSortDown(filter, i * 2);
+        } else if (medianFilterMinSortUp(filter, i)) {
+            medianFilterMaxSortDown(filter, -1);
+        }
+    } else if (i < 0) {
+        if (!filling && input < previous) {
+            medianFilterMaxSortDown(filter, i * 2);
+        } else if (medianFilterMaxSortUp(filter, i)) {
+            medianFilterMinSortDown(filter, 1);
+        }
+    } else {
+        medianFilterMaxSortDown(filter, -1);
+        medianFilterMinSortDown(filter, 1);
+    }
+
+    const float median = filter->values[filter->heap[0]];
+    if (filter->count & 1) {
+        return median;
+    }
+    return 0.5f * (median + filter->values[filter->heap[-1]]);
+}
+
 // get notch filter Q given center frequency (f0) and lower cutoff frequency (f1)
 // Q = f0 / (f2 - f1) ; f2 = f0^2 / f1
 float filterGetNotchQ(float centerFreq, float cutoffFreq) {
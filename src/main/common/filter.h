@@ -49,6 +49,22 @@ typedef struct laggedMovingAverage_s {
     bool primed;
 } laggedMovingAverage_t;
 
+/*
+ * Sliding window median. The samples in the window are kept in two heaps that meet at the median,
+ * so each new sample costs O(log windowSize) compares instead of sorting the window again.
+ */
+typedef struct medianFilter_s {
+    float *values;      // samples in arrival order
+    int8_t *heapIndex;  // where each sample is in the heaps
+    uint8_t *heap;      // sample numbers, heap[0] is the median, max heap at negative and min heap at positive indices
+    uint8_t windowSize;
+    uint8_t next;       // sample to replace next
+    uint8_t count;      // samples so far, up to windowSize
+} medianFilter_t;
+
+// size of the float buffer a median filter over windowSize (up to 255) samples needs
+#define MEDIAN_FILTER_BUFFER_SIZE(windowSize)   ((windowSize) + ((windowSize) + 1) / 2)
+
 typedef enum {
     FILTER_PT1 = 0,
     FILTER_BIQUAD,
@@ -108,5 +124,8 @@ float pt1FilterApply(pt1Filter_t *filter, float input);
 void slewFilterInit(slewFilter_t *filter, float slewLimit, float threshold);
 float slewFilterApply(slewFilter_t *filter, float input);
 
+void medianFilterInit(medianFilter_t *filter, uint8_t windowSize, float *buf);
+float medianFilterApply(medianFilter_t *filter, float input);
+
 void fastKalmanInit(fastKalman_t *filter, float q, uint32_t w, int axis, float updateRate);
 float fastKalmanUpdate(fastKalman_t *filter, float input);
@@ -31,8 +31,8 @@
 // Chebyshev http://stackoverflow.com/questions/345085/how-do-trigonometric-functions-work/345117#345117
 // Thanks for ledvinap for making such accuracy possible! See: https://github.com/cleanflight/cleanflight/issues/940#issuecomment-110323384
 // https://github.com/Crashpilot1000/HarakiriWebstore1/blob/master/src/mw.c#L1235
-// sin_approx maximum absolute error = 2.305023e-06
-// cos_approx maximum absolute error = 2.857298e-06
+// sin_approx maximum absolute error = 1.072884e-06
+// cos_approx maximum absolute error = 1.549721e-06
 #define sinPolyCoef3 -1.666568107e-1f
 #define sinPolyCoef5  8.312366210e-3f
 #define sinPolyCoef7 -1.849218155e-4f
@@ -43,15 +43,19 @@
 #define sinPolyCoef7 -1.980661520e-4f                                          // Double: -1.980661520135080504411629636078917643846e-4
 #define sinPolyCoef9  2.600054768e-6f                                          // Double:  2.600054767890361277123254766503271638682e-6
 #endif
+// 2 * PI split in two so that subtracting whole turns is exact for the first part (Cody-Waite)
+#define TWO_PI_HIGH     6.28125f
+#define TWO_PI_LOW      1.9353071795864769e-3f
+
 float sin_approx(float x)
 {
     int32_t xint = x;
     if (xint < -32 || xint > 32) return 0.0f;                               // Stop here on error input (5 * 360 Deg)
-    while (x >  M_PIf) x -= (2.0f * M_PIf);                                 // always wrap input angle to -PI..PI
-    while (x < -M_PIf) x += (2.0f * M_PIf);
-    if (x >  (0.5f * M_PIf)) x =  (0.5f * M_PIf) - (x - (0.5f * M_PIf));   // We just pick -90..+90 Degree
-    else if (x < -(0.5f * M_PIf)) x = -(0.5f * M_PIf) - ((0.5f * M_PIf) + x);
-    float x2 = x * x;
+    // whole turns are taken off at once rather than in a loop
+    const float turns = (float)(int32_t)(x * (0.5f / M_PIf) + copysignf(0.5f, x));
+    x = (x - turns * TWO_PI_HIGH) - turns * TWO_PI_LOW;                     // wrap input angle to -PI..PI
+    x = copysignf(MIN(fabsf(x), M_PIf - fabsf(x)), x);                      // We just pick -90..+90 Degree
+    const float x2 = x * x;
     return x + x * x2 * (sinPolyCoef3 + x2 * (sinPolyCoef5 + x2 * (sinPolyCoef7 + x2 * sinPolyCoef9)));
 }
 
@@ -64,27 +68,24 @@ float cos_approx(float x)
 // Polynomial coefficients by Andor (http://www.dsprelated.com/showthread/comp.dsp/21872-1.php) optimized by Ledvinap to save one multiplication
 // Max absolute error 0,000027 degree
 // atan2_approx maximum absolute error = 7.152557e-07 rads (4.098114e-05 degree)
+#define atanPolyCoef1  3.14551665884836e-07f
+#define atanPolyCoef2  0.99997356613987f
+#define atanPolyCoef3  0.14744007058297684f
+#define atanPolyCoef4  0.3099814292351353f
+#define atanPolyCoef5  0.05030176425872175f
+#define atanPolyCoef6  0.1471039133652469f
+#define atanPolyCoef7  0.6444640676891548f
+
 float atan2_approx(float y, float x)
 {
-    #define atanPolyCoef1  3.14551665884836e-07f
-    #define atanPolyCoef2  0.99997356613987f
-    #define atanPolyCoef3  0.14744007058297684f
-    #define atanPolyCoef4  0.3099814292351353f
-    #define atanPolyCoef5  0.05030176425872175f
-    #define atanPolyCoef6  0.1471039133652469f
-    #define atanPolyCoef7  0.6444640676891548f
-
-    float res, absX, absY;
-    absX = fabsf(x);
-    absY = fabsf(y);
-    res  = MAX(absX, absY);
-    if (res) res = MIN(absX, absY) / res;
-    else res = 0.0f;
+    const float absX = fabsf(x);
+    const float absY = fabsf(y);
+    // FLT_MIN keeps 0 / 0 at 0 without a branch
+    float res = MIN(absX, absY) / MAX(MAX(absX, absY), 1.17549435e-38f);
     res = -((((atanPolyCoef5 * res - atanPolyCoef4) * res - atanPolyCoef3) * res - atanPolyCoef2) * res - atanPolyCoef1) / ((atanPolyCoef7 * res + atanPolyCoef6) * res + 1.0f);
-    if (absY > absX) res = (M_PIf / 2.0f) - res;
-    if (x < 0) res = M_PIf - res;
-    if (y < 0) res = -res;
-    return res;
+    res = absY > absX ? (M_PIf / 2.0f) - res : res;
+    res = x < 0 ? M_PIf - res : res;
+    return y < 0 ? -res : res;
 }
 
 // http://http.developer.nvidia.com/Cg/acos.html
@@ -100,6 +101,17 @@ float acos_approx(float x)
     else
         return result;
 }
+
+// Initial guess from the bit pattern (Lomont), refined by two Newton-Raphson steps
+// invSqrt_approx maximum relative error = 4.7e-06
+float invSqrt_approx(float x)
+{
+    union { float f; int32_t i; } u = { .f = x };
+    u.i = 0x5f375a86 - (u.i >> 1);
+    u.f *= 1.5f - 0.5f * x * u.f * u.f;
+    u.f *= 1.5f - 0.5f * x * u.f * u.f;
+    return u.f;
+}
 #endif
 
 int gcd(int num, int denom)
@@ -407,14 +419,16 @@ void quaternionMultiply(quaternion *l, quaternion *r, quaternion *o) {
 }
 
 void quaternionNormalize(quaternion *q) {
-    float modulus = quaternionModulus(q);
-    if (modulus == 0) {
+    const float norm = quaternionNorm(q);
+    if (norm == 0) {
         // normalization not possible
     } else {
-        q->w /= modulus;
-        q->x /= modulus;
-        q->y /= modulus;
-        q->z /= modulus;
+        // one reciprocal square root and four multiplications instead of a square root and four divisions
+        const float scale = invSqrt_approx(norm);
+        q->w *= scale;
+        q->x *= scale;
+        q->y *= scale;
+        q->z *= scale;
     }
 }
 
@@ -123,24 +123,27 @@ float quickMedianFilter5f(float * v);
 float quickMedianFilter7f(float * v);
 float quickMedianFilter9f(float * v);
 
+// Maximum errors against libm, checked by maths_unittest
 #if defined(FAST_MATH) || defined(VERY_FAST_MATH)
-float sin_approx(float x);
-float cos_approx(float x);
-float atan2_approx(float y, float x);
-float acos_approx(float x);
+float sin_approx(float x);                  // absolute 1.1e-6 (VERY_FAST_MATH), returns 0 for |x| > 32
+float cos_approx(float x);                  // absolute 1.6e-6 (VERY_FAST_MATH), returns 0 for |x| > 32
+float atan2_approx(float y, float x);       // absolute 7.2e-7 rad
+float acos_approx(float x);                 // absolute 6.8e-5 rad
 #define tan_approx(x)       (sin_approx(x) / cos_approx(x))
-float exp_approx(float val);
-float log_approx(float val);
-float pow_approx(float a, float b);
+float invSqrt_approx(float x);              // relative 4.7e-6 for x > 0
+float exp_approx(float val);                // relative 1.3e-5 for results between FLT_MIN and FLT_MAX
+float log_approx(float val);                // absolute 2.3e-5 for val > 0
+float pow_approx(float a, float b);         // a ^ b, exp_approx(b * log_approx(a))
 #else
 #define sin_approx(x)   sinf(x)
 #define cos_approx(x)   cosf(x)
 #define atan2_approx(y,x)   atan2f(y,x)
 #define acos_approx(x)      acosf(x)
 #define tan_approx(x)       tanf(x)
+#define invSqrt_approx(x)   (1.0f / sqrtf(x))
 #define exp_approx(x)       expf(x)
 #define log_approx(x)       logf(x)
-#define pow_approx(a, b)    powf(b, a)
+#define pow_approx(a, b)    powf(a, b)
 #endif
 
 void arraySubInt32(int32_t *dest, int32_t *array1, int32_t *array2, int count);
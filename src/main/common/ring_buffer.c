@@ -0,0 +1,203 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "common/ring_buffer.h"
+
+/*
+ * Each side reads its own index plainly and the other side's index with acquire semantics, then
+ * publishes its own index with release semantics. That orders the data copy before the index
+ * update on the writing side and after the index read on the reading side. On a single core MCU
+ * this costs a DMB at most; on the host it is what makes the threaded use correct.
+ */
+#define RING_LOAD_ACQUIRE(p)        __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define RING_STORE_RELEASE(p, v)    __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+bool ringBufferInit(ringBuffer_t *rb, uint8_t *buffer, uint32_t size)
+{
+    if (size == 0 || (size & (size - 1))) {
+        return false;
+    }
+    rb->buffer = buffer;
+    rb->mask = size - 1;
+    rb->head = 0;
+    rb->tail = 0;
+    return true;
+}
+
+void ringBufferClear(ringBuffer_t *rb)
+{
+    rb->head = 0;
+    rb->tail = 0;
+}
+
+uint32_t ringBufferSize(const ringBuffer_t *rb)
+{
+    return rb->mask + 1;
+}
+
+uint32_t ringBufferUsed(const ringBuffer_t *rb)
+{
+    return RING_LOAD_ACQUIRE(&rb->head) - RING_LOAD_ACQUIRE(&rb->tail);
+}
+
+uint32_t ringBufferFree(const ringBuffer_t *rb)
+{
+    return ringBufferSize(rb) - ringBufferUsed(rb);
+}
+
+bool ringBufferIsEmpty(const ringBuffer_t *rb)
+{
+    return ringBufferUsed(rb) == 0;
+}
+
+bool ringBufferPushByte(ringBuffer_t *rb, uint8_t byte)
+{
+    const uint32_t head = rb->head;
+    if (head - RING_LOAD_ACQUIRE(&rb->tail) > rb->mask) {
+        return false;
+    }
+    rb->buffer[head & rb->mask] = byte;
+    RING_STORE_RELEASE(&rb->head, head + 1);
+    return true;
+}
+
+/*
+ * Copies up to len bytes in, returns how many fitted.
+ */
+uint32_t ringBufferPush(ringBuffer_t *rb, const void *data, uint32_t len)
+{
+    const uint32_t head = rb->head;
+    const uint32_t space = ringBufferSize(rb) - (head - RING_LOAD_ACQUIRE(&rb->tail));
+    if (len > space) {
+        len = space;
+    }
+
+    const uint32_t offset = head & rb->mask;
+    const uint32_t first = ringBufferSize(rb) - offset;
+    if (len <= first) {
+        memcpy(rb->buffer + offset, data, len);
+    } else {
+        memcpy(rb->buffer + offset, data, first);
+        memcpy(rb->buffer, (const uint8_t *)data + first, len - first);
+    }
+    RING_STORE_RELEASE(&rb->head, head + len);
+    return len;
+}
+
+/*
+ * Zero copy write: points data at the largest contiguous free span and returns its length.
+ * Fill it and then call ringBufferCommit() with the number of bytes actually written.
+ */
+uint32_t ringBufferReserve(ringBuffer_t *rb, uint8_t **data)
+{
+    const uint32_t head = rb->head;
+    const uint32_t space = ringBufferSize(rb) - (head - RING_LOAD_ACQUIRE(&rb->tail));
+    const uint32_t offset = head & rb->mask;
+    const uint32_t contiguous = ringBufferSize(rb) - offset;
+
+    *data = rb->buffer + offset;
+    return space < contiguous ? space : contiguous;
+}
+
+void ringBufferCommit(ringBuffer_t *rb, uint32_t len)
+{
+    RING_STORE_RELEASE(&rb->head, rb->head + len);
+}
+
+bool ringBufferPopByte(ringBuffer_t *rb, uint8_t *byte)
+{
+    const uint32_t tail = rb->tail;
+    if (RING_LOAD_ACQUIRE(&rb->head) == tail) {
+        return false;
+    }
+    *byte = rb->buffer[tail & rb->mask];
+    RING_STORE_RELEASE(&rb->tail, tail + 1);
+    return true;
+}
+
+/*
+ * Copies up to len bytes out, returns how many were available.
+ */
+uint32_t ringBufferPop(ringBuffer_t *rb, void *data, uint32_t len)
+{
+    const uint32_t tail = rb->tail;
+    const uint32_t used = RING_LOAD_ACQUIRE(&rb->head) - tail;
+    if (len > used) {
+        len = used;
+    }
+
+    const uint32_t offset = tail & rb->mask;
+    const uint32_t first = ringBufferSize(rb) - offset;
+    if (len <= first) {
+        memcpy(data, rb->buffer + offset, len);
+    } else {
+        memcpy(data, rb->buffer + offset, first);
+        memcpy((uint8_t *)data + first, rb->buffer, len - first);
+    }
+    RING_STORE_RELEASE(&rb->tail, tail + len);
+    return len;
+}
+
+/*
+ * Zero copy read: points data at the oldest contiguous run of bytes and returns its length.
+ * Call ringBufferConsume() once they have been used.
+ */
+uint32_t ringBufferPeek(const ringBuffer_t *rb, const uint8_t **data)
+{
+    const uint32_t tail = rb->tail;
+    const uint32_t used = RING_LOAD_ACQUIRE(&rb->head) - tail;
+    const uint32_t offset = tail & rb->mask;
+    const uint32_t contiguous = ringBufferSize(rb) - offset;
+
+    *data = rb->buffer + offset;
+    return used < contiguous ? used : contiguous;
+}
+
+/*
+ * As ringBufferPeek(), but also returns the part that wrapped around to the start of the buffer.
+ * Returns the total number of bytes in both spans.
+ */
+uint32_t ringBufferPeekSpans(const ringBuffer_t *rb, const uint8_t *data[2], uint32_t len[2])
+{
+    const uint32_t tail = rb->tail;
+    const uint32_t used = RING_LOAD_ACQUIRE(&rb->head) - tail;
+    const uint32_t offset = tail & rb->mask;
+    const uint32_t contiguous = ringBufferSize(rb) - offset;
+
+    data[0] = rb->buffer + offset;
+    data[1] = rb->buffer;
+    if (used <= contiguous) {
+        len[0] = used;
+        len[1] = 0;
+    } else {
+        len[0] = contiguous;
+        len[1] = used - contiguous;
+    }
+    return used;
+}
+
+void ringBufferConsume(ringBuffer_t *rb, uint32_t len)
+{
+    RING_STORE_RELEASE(&rb->tail, rb->tail + len);
+}
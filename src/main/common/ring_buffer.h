@@ -0,0 +1,61 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Single producer / single consumer byte ring.
+ *
+ * The size must be a power of two. head and tail are free running counters, so every byte of the
+ * buffer is usable and the fill level is simply head - tail. Only the producer writes head and
+ * only the consumer writes tail, which makes it safe to use between an ISR and the main loop or
+ * between two threads without a lock.
+ */
+typedef struct ringBuffer_s {
+    uint8_t *buffer;
+    uint32_t mask;
+    uint32_t head;      // next byte to write, producer owned
+    uint32_t tail;      // next byte to read, consumer owned
+} ringBuffer_t;
+
+bool ringBufferInit(ringBuffer_t *rb, uint8_t *buffer, uint32_t size);
+// only valid while neither side is using the ring
+void ringBufferClear(ringBuffer_t *rb);
+
+uint32_t ringBufferSize(const ringBuffer_t *rb);
+uint32_t ringBufferUsed(const ringBuffer_t *rb);
+uint32_t ringBufferFree(const ringBuffer_t *rb);
+bool ringBufferIsEmpty(const ringBuffer_t *rb);
+
+// producer side
+bool ringBufferPushByte(ringBuffer_t *rb, uint8_t byte);
+uint32_t ringBufferPush(ringBuffer_t *rb, const void *data, uint32_t len);
+uint32_t ringBufferReserve(ringBuffer_t *rb, uint8_t **data);
+void ringBufferCommit(ringBuffer_t *rb, uint32_t len);
+
+// consumer side
+bool ringBufferPopByte(ringBuffer_t *rb, uint8_t *byte);
+uint32_t ringBufferPop(ringBuffer_t *rb, void *data, uint32_t len);
+uint32_t ringBufferPeek(const ringBuffer_t *rb, const uint8_t **data);
+uint32_t ringBufferPeekSpans(const ringBuffer_t *rb, const uint8_t *data[2], uint32_t len[2]);
+void ringBufferConsume(ringBuffer_t *rb, uint32_t len);
@@ -42,6 +42,8 @@ extern uint8_t __config_end;
 #endif
 
 static uint16_t eepromConfigSize;
+static const uint8_t *configLogTail;     // first byte after the last valid record
+static bool configLogTailErased;         // records can be appended at configLogTail without erasing
 
 typedef enum {
     CR_CLASSICATION_SYSTEM   = 0,
@@ -50,33 +52,38 @@ typedef enum {
 
 #define CR_CLASSIFICATION_MASK  (0x3)
 #define CRC_START_VALUE         0xFFFF
-#define CRC_CHECK_VALUE         0x1D0F  // pre-calculated value of CRC that includes the CRC itself
+
+// Records are padded to the flash programming word so that each append starts on a fresh word.
+#define CR_ALIGN(size)          (((size) + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1))
+
+// The config area holds an append-only log of PG records behind a header.
+// Saving appends a record only for the PGs that changed since they were last stored, the newest
+// record of a PG wins when loading. When the log runs out of space it is compacted, i.e. the area
+// is erased and every PG is written once under a new generation.
 
 // Header for the saved copy.
 typedef struct {
     uint8_t eepromConfigVersion;
     uint8_t magic_be;           // magic number, should be 0xBE
+    uint16_t generation;        // incremented every time the log is compacted
 } PG_PACKED configHeader_t;
 
 // Header for each stored PG.
 typedef struct {
     // split up.
-    uint16_t size;
+    uint16_t size;              // size of header and PG, excluding padding
     pgn_t pgn;
     uint8_t version;
 
     // lower 2 bits used to indicate system or profile number, see CR_CLASSIFICATION_MASK
     uint8_t flags;
 
+    uint16_t generation;        // must match the header, older records are leftovers of a previous log
+    uint16_t crc;               // covers the fields above and the PG, detects interrupted appends
+
     uint8_t pg[];
 } PG_PACKED configRecord_t;
 
-// Footer for the saved copy.
-typedef struct {
-    uint16_t terminator;
-} PG_PACKED configFooter_t;
-// checksum is appended just after footer. It is not included in footer to make checksum calculation consistent
-
 // Used to check the compiler packing at build time.
 typedef struct {
     uint8_t byte;
@@ -90,14 +97,54 @@ void initEEPROM(void)
     BUILD_BUG_ON(offsetof(packingTest_t, word) != 1);
     BUILD_BUG_ON(sizeof(packingTest_t) != 5);
 
-    BUILD_BUG_ON(sizeof(configFooter_t) != 2);
-    BUILD_BUG_ON(sizeof(configRecord_t) != 6);
+    BUILD_BUG_ON(sizeof(configHeader_t) != 4);
+    BUILD_BUG_ON(sizeof(configRecord_t) != 10);
+}
+
+static const configHeader_t *configHeader(void)
+{
+    return (const configHeader_t *)&__config_start;
+}
+
+static uint16_t configRecordCrc(const configRecord_t *record, const uint8_t *pg, uint16_t pgSize)
+{
+    uint16_t crc = crc16_ccitt_update(CRC_START_VALUE, record, offsetof(configRecord_t, crc));
+    return crc16_ccitt_update(crc, pg, pgSize);
+}
+
+// return the record stored at p, or NULL if there is no valid record of this generation
+static const configRecord_t *configRecordAt(const uint8_t *p, uint16_t generation)
+{
+    const configRecord_t *record = (const configRecord_t *)p;
+
+    if (p + sizeof(*record) > &__config_end
+        || record->size < sizeof(*record)
+        || p + record->size > &__config_end
+        || record->generation != generation) {
+        return NULL;
+    }
+    if (record->crc != configRecordCrc(record, record->pg, record->size - sizeof(*record))) {
+        return NULL;
+    }
+    return record;
+}
+
+static bool isConfigLogErasedAt(const uint8_t *p, int size)
+{
+    if (p + size > &__config_end) {
+        return false;
+    }
+    for (int i = 0; i < size; i++) {
+        if (p[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
 }
 
 bool isEEPROMVersionValid(void)
 {
-    const uint8_t *p = &__config_start;
-    const configHeader_t *header = (const configHeader_t *)p;
+    const configHeader_t *header = configHeader();
 
     if (header->eepromConfigVersion != EEPROM_CONF_VERSION) {
         return false;
@@ -109,48 +156,29 @@ bool isEEPROMVersionValid(void)
 // Scan the EEPROM config. Returns true if the config is valid.
 bool isEEPROMStructureValid(void)
 {
-    const uint8_t *p = &__config_start;
-    const configHeader_t *header = (const configHeader_t *)p;
+    const configHeader_t *header = configHeader();
+
+    configLogTail = NULL;
+    configLogTailErased = false;
+    eepromConfigSize = 0;
 
     if (header->magic_be != 0xBE) {
         return false;
     }
 
-    uint16_t crc = CRC_START_VALUE;
-    crc = crc16_ccitt_update(crc, header, sizeof(*header));
-    p += sizeof(*header);
-
-    for (;;) {
-        const configRecord_t *record = (const configRecord_t *)p;
-
-        if (record->size == 0) {
-            // Found the end.  Stop scanning.
-            break;
-        }
-        if (p + record->size >= &__config_end
-            || record->size < sizeof(*record)) {
-            // Too big or too small.
-            return false;
-        }
-
-        crc = crc16_ccitt_update(crc, p, record->size);
-
-        p += record->size;
+    const uint8_t *p = &__config_start + sizeof(*header);
+    const configRecord_t *record;
+    while ((record = configRecordAt(p, header->generation))) {
+        p += CR_ALIGN(record->size);
     }
 
-    const configFooter_t *footer = (const configFooter_t *)p;
-    crc = crc16_ccitt_update(crc, footer, sizeof(*footer));
-    p += sizeof(*footer);
-
-    // include stored CRC in the CRC calculation
-    const uint16_t *storedCrc = (const uint16_t *)p;
-    crc = crc16_ccitt_update(crc, storedCrc, sizeof(*storedCrc));
-    p += sizeof(storedCrc);
-
+    // Anything but erased flash after the last record is an interrupted append,
+    // the log has to be compacted before it can be appended to again.
+    configLogTail = p;
+    configLogTailErased = isConfigLogErasedAt(p, sizeof(uint32_t));
     eepromConfigSize = p - &__config_start;
 
-    // CRC has the property that if the CRC itself is included in the calculation the resulting CRC will have constant value
-    return crc == CRC_CHECK_VALUE;
+    return p > &__config_start + sizeof(*header);
 }
 
 uint16_t getEEPROMConfigSize(void)
@@ -158,26 +186,21 @@ uint16_t getEEPROMConfigSize(void)
     return eepromConfigSize;
 }
 
-// find config record for reg + classification (profile info) in EEPROM
+// find the newest config record for reg + classification (profile info) in EEPROM
 // return NULL when record is not found
-// this function assumes that EEPROM content is valid
+// this function assumes that EEPROM content is valid and has been scanned by isEEPROMStructureValid
 static const configRecord_t *findEEPROM(const pgRegistry_t *reg, configRecordFlags_e classification)
 {
-    const uint8_t *p = &__config_start;
-    p += sizeof(configHeader_t);             // skip header
-    while (true) {
+    const configRecord_t *found = NULL;
+    const uint8_t *p = &__config_start + sizeof(configHeader_t);             // skip header
+    while (p < configLogTail) {
         const configRecord_t *record = (const configRecord_t *)p;
-        if (record->size == 0
-            || p + record->size >= &__config_end
-            || record->size < sizeof(*record))
-            break;
         if (pgN(reg) == record->pgn
             && (record->flags & CR_CLASSIFICATION_MASK) == classification)
-            return record;
-        p += record->size;
+            found = record;
+        p += CR_ALIGN(record->size);
     }
-    // record not found
-    return NULL;
+    return found;
 }
 
 // Initialize all PG records from EEPROM.
@@ -204,8 +227,92 @@ bool loadEEPROM(void)
     return success;
 }
 
+// true if the newest stored record of the PG matches its RAM contents
+static bool isConfigRecordCurrent(const pgRegistry_t *reg)
+{
+    const configRecord_t *rec = findEEPROM(reg, CR_CLASSICATION_SYSTEM);
+
+    return rec
+        && rec->version == pgVersion(reg)
+        && rec->size - sizeof(*rec) == pgSize(reg)
+        && memcmp(rec->pg, reg->address, pgSize(reg)) == 0;
+}
+
+static void writeConfigRecord(config_streamer_t *streamer, const pgRegistry_t *reg, uint16_t generation)
+{
+    const uint16_t regSize = pgSize(reg);
+    configRecord_t record = {
+        .size = sizeof(configRecord_t) + regSize,
+        .pgn = pgN(reg),
+        .version = pgVersion(reg),
+        .flags = 0,
+        .generation = generation,
+    };
+
+    record.flags |= CR_CLASSICATION_SYSTEM;
+    record.crc = configRecordCrc(&record, reg->address, regSize);
+    config_streamer_write(streamer, (uint8_t *)&record, sizeof(record));
+    config_streamer_write(streamer, reg->address, regSize);
+    // pad, so the next record starts on a word that has not been programmed yet
+    config_streamer_flush(streamer);
+}
+
+// Append records for the changed PGs to the log. Returns false if the log has to be compacted instead.
+static bool appendSettingsToEEPROM(void)
+{
+    if (!isEEPROMVersionValid() || !isEEPROMStructureValid() || !configLogTailErased) {
+        return false;
+    }
+
+    int appendSize = 0;
+    PG_FOREACH(reg) {
+        if (!isConfigRecordCurrent(reg)) {
+            appendSize += CR_ALIGN(sizeof(configRecord_t) + pgSize(reg));
+        }
+    }
+    if (appendSize == 0) {
+        return true;
+    }
+    // the area past the tail was erased by the last compaction, unless the flash was written by something else
+    if (appendSize > &__config_end - configLogTail || !isConfigLogErasedAt(configLogTail, appendSize)) {
+        return false;
+    }
+
+    config_streamer_t streamer;
+    config_streamer_init(&streamer);
+
+    // The tail was checked to be blank. It may start a page, and on F4/F7 erasing that
+    // page would erase the whole config sector, so the streamer must not erase anything.
+    streamer.erased = true;
+    config_streamer_start(&streamer, (uintptr_t)configLogTail, &__config_end - configLogTail);
+
+    const uint16_t generation = configHeader()->generation;
+    PG_FOREACH(reg) {
+        if (!isConfigRecordCurrent(reg)) {
+            writeConfigRecord(&streamer, reg, generation);
+        }
+    }
+
+    if (config_streamer_finish(&streamer) != 0 || !isEEPROMStructureValid()) {
+        return false;
+    }
+
+    // verify that every PG made it into the log
+    PG_FOREACH(reg) {
+        if (!isConfigRecordCurrent(reg)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Compact the log: erase the config area and write every PG under a new generation.
 static bool writeSettingsToEEPROM(void)
 {
+    const configHeader_t *oldHeader = configHeader();
+    const uint16_t generation = oldHeader->magic_be == 0xBE ? oldHeader->generation + 1 : 0;
+
     config_streamer_t streamer;
     config_streamer_init(&streamer);
 
@@ -214,40 +321,14 @@ static bool writeSettingsToEEPROM(void)
     configHeader_t header = {
         .eepromConfigVersion =  EEPROM_CONF_VERSION,
         .magic_be =             0xBE,
+        .generation =           generation,
     };
 
     config_streamer_write(&streamer, (uint8_t *)&header, sizeof(header));
-    uint16_t crc = CRC_START_VALUE;
-    crc = crc16_ccitt_update(crc, (uint8_t *)&header, sizeof(header));
     PG_FOREACH(reg) {
-        const uint16_t regSize = pgSize(reg);
-        configRecord_t record = {
-            .size = sizeof(configRecord_t) + regSize,
-            .pgn = pgN(reg),
-            .version = pgVersion(reg),
-            .flags = 0
-        };
-
-        record.flags |= CR_CLASSICATION_SYSTEM;
-        config_streamer_write(&streamer, (uint8_t *)&record, sizeof(record));
-        crc = crc16_ccitt_update(crc, (uint8_t *)&record, sizeof(record));
-        config_streamer_write(&streamer, reg->address, regSize);
-        crc = crc16_ccitt_update(crc, reg->address, regSize);
+        writeConfigRecord(&streamer, reg, generation);
     }
 
-    configFooter_t footer = {
-        .terminator = 0,
-    };
-
-    config_streamer_write(&streamer, (uint8_t *)&footer, sizeof(footer));
-    crc = crc16_ccitt_update(crc, (uint8_t *)&footer, sizeof(footer));
-
-    // include inverted CRC in big endian format in the CRC
-    const uint16_t invertedBigEndianCrc = ~(((crc & 0xFF) << 8) | (crc >> 8));
-    config_streamer_write(&streamer, (uint8_t *)&invertedBigEndianCrc, sizeof(crc));
-
-    config_streamer_flush(&streamer);
-
     const bool success = config_streamer_finish(&streamer) == 0;
 
     return success;
@@ -255,8 +336,8 @@ static bool writeSettingsToEEPROM(void)
 
 void writeConfigToEEPROM(void)
 {
-    bool success = false;
-    // write it
+    bool success = appendSettingsToEEPROM();
+    // compact it
     for (int attempt = 0; attempt < 3 && !success; attempt++) {
         if (writeSettingsToEEPROM()) {
             success = true;
@@ -76,6 +76,7 @@ void config_streamer_start(config_streamer_t *c, uintptr_t base, int size)
     // base must start at FLASH_PAGE_SIZE boundary
     c->address = base;
     c->size = size;
+    c->end = base + size;
     if (!c->unlocked) {
 #if defined(STM32F7)
         HAL_FLASH_Unlock();
@@ -231,7 +232,7 @@ static int write_word(config_streamer_t *c, uint32_t value)
         return c->err;
     }
 #if defined(STM32F7)
-    if (c->address % FLASH_PAGE_SIZE == 0) {
+    if (c->address % FLASH_PAGE_SIZE == 0 && !c->erased) {
         FLASH_EraseInitTypeDef EraseInitStruct = {
             .TypeErase     = FLASH_TYPEERASE_SECTORS,
             .VoltageRange  = FLASH_VOLTAGE_RANGE_3, // 2.7-3.6V
@@ -249,7 +250,7 @@ static int write_word(config_streamer_t *c, uint32_t value)
         return -2;
     }
 #else
-    if (c->address % FLASH_PAGE_SIZE == 0) {
+    if (c->address % FLASH_PAGE_SIZE == 0 && !c->erased) {
 #if defined(STM32F4)
         const FLASH_Status status = FLASH_EraseSector(getFLASHSectorForEEPROM(), VoltageRange_3); //0x08080000 to 0x080A0000
 #else
@@ -298,6 +299,19 @@ int config_streamer_flush(config_streamer_t *c)
 
 int config_streamer_finish(config_streamer_t *c)
 {
+#if !defined(STM32F4) && !defined(STM32F7)
+    // Pages are only erased as writing reaches them, erase the rest of the range too
+    // so nothing of an older image is left behind the new one.
+    // F4/F7 erase the whole config sector with the first page already.
+    if (c->err == 0 && !c->erased) {
+        for (uintptr_t page = (c->address + FLASH_PAGE_SIZE - 1) & ~(uintptr_t)(FLASH_PAGE_SIZE - 1); page < c->end; page += FLASH_PAGE_SIZE) {
+            if (FLASH_ErasePage(page) != FLASH_COMPLETE) {
+                c->err = -1;
+                break;
+            }
+        }
+    }
+#endif
     if (c->unlocked) {
 #if defined(STM32F7)
         HAL_FLASH_Lock();
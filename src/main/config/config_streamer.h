@@ -29,6 +29,7 @@
 typedef struct config_streamer_s {
     uintptr_t address;
     int size;
+    uintptr_t end;
     union {
         uint8_t b[4];
         uint32_t w;
@@ -36,6 +37,7 @@ typedef struct config_streamer_s {
     int at;
     int err;
     bool unlocked;
+    bool erased;    // the range already reads back erased, so pages are never erased before writing
 } config_streamer_t;
 
 void config_streamer_init(config_streamer_t *c);
@@ -57,6 +57,7 @@
 volatile uint16_t imufCurrentVersion = IMUF_FIRMWARE_MIN_VERSION;
 FAST_RAM_ZERO_INIT volatile uint32_t isImufCalibrating;
 FAST_RAM_ZERO_INIT volatile imuFrame_t imufQuat;
+FAST_RAM_ZERO_INIT volatile uint32_t imufQuatSequence;
 FAST_RAM_ZERO_INIT gyroDev_t *imufDev;
 
 #ifdef USE_HAL_F7_CRC
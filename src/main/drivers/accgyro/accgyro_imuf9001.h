@@ -227,6 +227,7 @@ typedef enum gpioState
 } gpioState_t;
 
 extern volatile imuFrame_t imufQuat;
+extern volatile uint32_t imufQuatSequence;     // bumped after every quaternion frame written to imufQuat
 volatile uint32_t isImufCalibrating;
 
 extern void initImuf9001(void);
@@ -256,6 +256,7 @@ FAST_CODE void mpuGyroDmaSpiReadFinish(gyroDev_t * gyro)
         imufQuat.x       = imufData.quaternionX;
         imufQuat.y       = imufData.quaternionY;
         imufQuat.z       = imufData.quaternionZ;
+        imufQuatSequence++;
     }
 #else
     acc.dev.ADCRaw[X]   = (int16_t)((dmaRxBuffer[1] << 8)  | dmaRxBuffer[2]);
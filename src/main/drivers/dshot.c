@@ -0,0 +1,144 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * DShot / ProShot packet encoding into timer DMA buffers and decoding of bidirectional DShot
+ * replies, kept free of any hardware access so the bit patterns can be checked on the host.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_DSHOT
+
+#include "drivers/dshot.h"
+
+// DMA symbols for the 8 bits of every byte value, MSB first
+#define DSHOT_SYMBOL(byte, bit) (((byte) & (0x80 >> (bit))) ? MOTOR_BIT_1 : MOTOR_BIT_0)
+#define DSHOT_SYMBOLS_1(b)      { DSHOT_SYMBOL(b, 0), DSHOT_SYMBOL(b, 1), DSHOT_SYMBOL(b, 2), DSHOT_SYMBOL(b, 3), \
+                                  DSHOT_SYMBOL(b, 4), DSHOT_SYMBOL(b, 5), DSHOT_SYMBOL(b, 6), DSHOT_SYMBOL(b, 7) }
+#define DSHOT_SYMBOLS_4(b)      DSHOT_SYMBOLS_1(b), DSHOT_SYMBOLS_1((b) + 1), DSHOT_SYMBOLS_1((b) + 2), DSHOT_SYMBOLS_1((b) + 3)
+#define DSHOT_SYMBOLS_16(b)     DSHOT_SYMBOLS_4(b), DSHOT_SYMBOLS_4((b) + 4), DSHOT_SYMBOLS_4((b) + 8), DSHOT_SYMBOLS_4((b) + 12)
+#define DSHOT_SYMBOLS_64(b)     DSHOT_SYMBOLS_16(b), DSHOT_SYMBOLS_16((b) + 16), DSHOT_SYMBOLS_16((b) + 32), DSHOT_SYMBOLS_16((b) + 48)
+
+static const uint8_t dshotSymbols[256][8] = {
+    DSHOT_SYMBOLS_64(0), DSHOT_SYMBOLS_64(64), DSHOT_SYMBOLS_64(128), DSHOT_SYMBOLS_64(192)
+};
+
+// 11 bit value, telemetry request bit and the xor of the three nibbles as checksum
+FAST_CODE uint16_t dshotEncodePacket(uint16_t value, bool requestTelemetry)
+{
+    const uint16_t packet = (value << 1) | (requestTelemetry ? 1 : 0);
+    const uint16_t csum = (packet ^ (packet >> 4) ^ (packet >> 8)) & 0xf;
+
+    return (packet << 4) | csum;
+}
+
+FAST_CODE uint8_t dshotLoadDmaBuffer(uint32_t *dmaBuffer, int stride, uint16_t packet)
+{
+    const uint8_t *high = dshotSymbols[packet >> 8];
+    const uint8_t *low = dshotSymbols[packet & 0xff];
+
+    for (int i = 0; i < 8; i++) {
+        dmaBuffer[i * stride] = high[i];
+        dmaBuffer[(i + 8) * stride] = low[i];
+    }
+
+    return DSHOT_DMA_BUFFER_SIZE;
+}
+
+FAST_CODE uint8_t proshotLoadDmaBuffer(uint32_t *dmaBuffer, int stride, uint16_t packet)
+{
+    for (int i = 0; i < 4; i++) {
+        dmaBuffer[i * stride] = PROSHOT_BASE_SYMBOL + ((packet & 0xF000) >> 12) * PROSHOT_BIT_WIDTH;  // Most significant nibble first
+        packet <<= 4;   // Shift 4 bits
+    }
+
+    return PROSHOT_DMA_BUFFER_SIZE;
+}
+
+#define GCR_INVALID 0xff
+
+// GCR quintet to nibble
+static const uint8_t gcrDecode[32] = {
+    GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID,
+    GCR_INVALID, 0x9,         0xa,         0xb,         GCR_INVALID, 0xd,         0xe,         0xf,
+    GCR_INVALID, GCR_INVALID, 0x2,         0x3,         GCR_INVALID, 0x5,         0x6,         0x7,
+    GCR_INVALID, 0x0,         0x8,         0x1,         GCR_INVALID, 0x4,         0xc,         GCR_INVALID,
+};
+
+/*
+ * Decodes a bidirectional DShot reply from the timer captures of its edges, the first one being the
+ * falling edge of the start bit. Every edge is a 1 in the GCR code and the line holds its level for
+ * the 0s in between. Returns eRPM / 100, or DSHOT_TELEMETRY_INVALID if the reply is corrupt.
+ */
+FAST_CODE uint16_t dshotDecodeTelemetry(const uint32_t *edges, int count)
+{
+    uint32_t value = 0;
+    int bits = 0;
+
+    for (int i = 1; i < count && bits < 21; i++) {
+        // captures come from 16 or 32 bit timers, the reply is much shorter than either wraps
+        const uint16_t ticks = edges[i] - edges[i - 1];
+        const int len = (ticks + DSHOT_TELEMETRY_BIT_TICKS / 2) / DSHOT_TELEMETRY_BIT_TICKS;
+        if (len == 0) {
+            return DSHOT_TELEMETRY_INVALID;
+        }
+        value = (value << len) | (1 << (len - 1));
+        bits += len;
+    }
+    if (count < 1 || bits > 21) {
+        return DSHOT_TELEMETRY_INVALID;
+    }
+    // no edge after the last run, the line goes back to idle at the end of the reply
+    const int len = 21 - bits;
+    if (len) {
+        value = (value << len) | (1 << (len - 1));
+    }
+
+    uint16_t decoded = 0;
+    for (int shift = 15; shift >= 0; shift -= 5) {
+        const uint8_t nibble = gcrDecode[(value >> shift) & 0x1f];
+        if (nibble == GCR_INVALID) {
+            return DSHOT_TELEMETRY_INVALID;
+        }
+        decoded = (decoded << 4) | nibble;
+    }
+
+    const uint16_t csum = decoded ^ (decoded >> 4) ^ (decoded >> 8) ^ (decoded >> 12);
+    if ((csum & 0xf) != 0xf) {
+        return DSHOT_TELEMETRY_INVALID;
+    }
+
+    // 3 bit exponent and 9 bit mantissa of the electrical period in us, all ones when stopped
+    decoded >>= 4;
+    if (decoded == 0x0fff) {
+        return 0;
+    }
+    const uint32_t periodUs = (decoded & 0x1ff) << (decoded >> 9);
+    if (!periodUs) {
+        return DSHOT_TELEMETRY_INVALID;
+    }
+
+    return (1000000 * 60 / 100 + periodUs / 2) / periodUs;
+}
+#endif
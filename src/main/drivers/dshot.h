@@ -0,0 +1,45 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// timer compare values of the DMA symbols, in timer ticks
+#define MOTOR_BIT_0           7
+#define MOTOR_BIT_1           14
+#define MOTOR_BITLENGTH       19
+
+#define PROSHOT_BASE_SYMBOL          24 // 1uS
+#define PROSHOT_BIT_WIDTH            3
+
+#define DSHOT_DMA_BUFFER_SIZE   18 /* resolution + frame reset (2us) */
+#define PROSHOT_DMA_BUFFER_SIZE 6  /* resolution + frame reset (2us) */
+
+// bidirectional DShot: the ESC replies with 21 GCR bits at 5/4 of the DShot bit rate
+#define DSHOT_TELEMETRY_BIT_TICKS   ((MOTOR_BITLENGTH + 1) * 4 / 5)    // GCR bit length in output timer ticks
+#define DSHOT_TELEMETRY_INPUT_LEN   32  // edge timestamps captured per reply, at most 21 are used
+#define DSHOT_TELEMETRY_INVALID     0xffff
+
+uint16_t dshotEncodePacket(uint16_t value, bool requestTelemetry);
+uint8_t dshotLoadDmaBuffer(uint32_t *dmaBuffer, int stride, uint16_t packet);
+uint8_t proshotLoadDmaBuffer(uint32_t *dmaBuffer, int stride, uint16_t packet);
+uint16_t dshotDecodeTelemetry(const uint32_t *edges, int count);
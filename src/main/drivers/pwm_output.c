@@ -67,6 +67,9 @@ static bool isDshot = false;
 #ifdef USE_DSHOT_DMAR
 FAST_RAM_ZERO_INIT bool useBurstDshot = false;
 #endif
+#ifdef USE_DSHOT_TELEMETRY
+FAST_RAM_ZERO_INIT bool useDshotTelemetry = false;
+#endif
 
 static void pwmOCConfig(TIM_TypeDef *tim, uint8_t channel, uint16_t value, uint8_t output)
 {
@@ -156,26 +159,6 @@ static FAST_CODE void pwmWriteDshot(uint8_t index, float value)
 {
     pwmWriteDshotInt(index, lrintf(value));
 }
-
-static FAST_CODE uint8_t loadDmaBufferDshot(uint32_t *dmaBuffer, int stride, uint16_t packet)
-{
-    for (int i = 0; i < 16; i++) {
-        dmaBuffer[i * stride] = (packet & 0x8000) ? MOTOR_BIT_1 : MOTOR_BIT_0;  // MSB first
-        packet <<= 1;
-    }
-
-    return DSHOT_DMA_BUFFER_SIZE;
-}
-
-FAST_CODE static uint8_t loadDmaBufferProshot(uint32_t *dmaBuffer, int stride, uint16_t packet)
-{
-    for (int i = 0; i < 4; i++) {
-        dmaBuffer[i * stride] = PROSHOT_BASE_SYMBOL + ((packet & 0xF000) >> 12) * PROSHOT_BIT_WIDTH;  // Most significant nibble first
-        packet <<= 4;   // Shift 4 bits
-    }
-
-    return PROSHOT_DMA_BUFFER_SIZE;
-}
 #endif
 
 FAST_CODE void pwmWriteMotor(uint8_t index, float value)
@@ -268,7 +251,7 @@ void motorDevInit(const motorDevConfig_t *motorConfig, uint16_t idlePulse, uint8
 #ifdef USE_DSHOT
     case PWM_TYPE_PROSHOT1000:
         pwmWrite = &pwmWriteDshot;
-        loadDmaBuffer = &loadDmaBufferProshot;
+        loadDmaBuffer = &proshotLoadDmaBuffer;
         pwmCompleteWrite = &pwmCompleteDshotMotorUpdate;
         isDshot = true;
         break;
@@ -277,11 +260,15 @@ void motorDevInit(const motorDevConfig_t *motorConfig, uint16_t idlePulse, uint8
     case PWM_TYPE_DSHOT300:
     case PWM_TYPE_DSHOT150:
         pwmWrite = &pwmWriteDshot;
-        loadDmaBuffer = &loadDmaBufferDshot;
+        loadDmaBuffer = &dshotLoadDmaBuffer;
         pwmCompleteWrite = &pwmCompleteDshotMotorUpdate;
         isDshot = true;
+#ifdef USE_DSHOT_TELEMETRY
+        useDshotTelemetry = motorConfig->useDshotTelemetry;
+#endif
 #ifdef USE_DSHOT_DMAR
-        if (motorConfig->useBurstDshot) {
+        // the replies are captured per channel, which burst mode can't do
+        if (motorConfig->useBurstDshot && !motorConfig->useDshotTelemetry) {
             useBurstDshot = true;
         }
 #endif
@@ -311,10 +298,14 @@ void motorDevInit(const motorDevConfig_t *motorConfig, uint16_t idlePulse, uint8
 
 #ifdef USE_DSHOT
         if (isDshot) {
-            pwmDshotMotorHardwareConfig(timerHardware,
-                motorIndex,
-                motorConfig->motorPwmProtocol,
-                motorConfig->motorPwmInversion ? timerHardware->output ^ TIMER_OUTPUT_INVERTED : timerHardware->output);
+            uint8_t output = motorConfig->motorPwmInversion ? timerHardware->output ^ TIMER_OUTPUT_INVERTED : timerHardware->output;
+#ifdef USE_DSHOT_TELEMETRY
+            // bidirectional DShot idles high so that the ESC can pull the line low to reply
+            if (useDshotTelemetry) {
+                output ^= TIMER_OUTPUT_INVERTED;
+            }
+#endif
+            pwmDshotMotorHardwareConfig(timerHardware, motorIndex, motorConfig->motorPwmProtocol, output);
             motors[motorIndex].enabled = true;
             continue;
         }
@@ -517,22 +508,37 @@ FAST_CODE_NOINLINE bool pwmDshotCommandOutputIsEnabled(uint8_t motorCount)
 
 FAST_CODE uint16_t prepareDshotPacket(motorDmaOutput_t *const motor)
 {
-    uint16_t packet = (motor->value << 1) | (motor->requestTelemetry ? 1 : 0);
+    uint16_t packet = dshotEncodePacket(motor->value, motor->requestTelemetry);
     motor->requestTelemetry = false;    // reset telemetry request to make sure it's triggered only once in a row
 
-    // compute checksum
-    int csum = 0;
-    int csum_data = packet;
-    for (int i = 0; i < 3; i++) {
-        csum ^=  csum_data;   // xor data by nibbles
-        csum_data >>= 4;
+#ifdef USE_DSHOT_TELEMETRY
+    // an inverted checksum asks the ESC for a reply on the same wire
+    if (useDshotTelemetry) {
+        packet ^= 0xf;
     }
-    csum &= 0xf;
-    // append checksum
-    packet = (packet << 4) | csum;
+#endif
 
     return packet;
 }
+
+#ifdef USE_DSHOT_TELEMETRY
+FAST_CODE void pwmDshotTelemetryReply(motorDmaOutput_t *const motor, uint16_t value)
+{
+    if (value != DSHOT_TELEMETRY_INVALID) {
+        motor->telemetryValue = value;
+        motor->telemetryInvalidCount = 0;
+    } else if (motor->telemetryInvalidCount < DSHOT_TELEMETRY_TIMEOUT_FRAMES) {
+        motor->telemetryInvalidCount++;
+    } else {
+        motor->telemetryValue = 0;
+    }
+}
+
+uint16_t getDshotTelemetry(uint8_t index)
+{
+    return getMotorDmaOutput(index)->telemetryValue;
+}
+#endif
 #endif
 
 #ifdef USE_SERVOS
@@ -22,6 +22,7 @@
 
 #include "platform.h"
 
+#include "drivers/dshot.h"
 #include "drivers/io_types.h"
 #include "drivers/pwm_output_counts.h"
 #include "drivers/timer.h"
@@ -96,20 +97,10 @@ typedef enum {
 #define MOTOR_DSHOT300_HZ     MHZ_TO_HZ(6)
 #define MOTOR_DSHOT150_HZ     MHZ_TO_HZ(3)
 
-#define MOTOR_BIT_0           7
-#define MOTOR_BIT_1           14
-#define MOTOR_BITLENGTH       19
-
 #define MOTOR_PROSHOT1000_HZ         MHZ_TO_HZ(24)
-#define PROSHOT_BASE_SYMBOL          24 // 1uS
-#define PROSHOT_BIT_WIDTH            3
 #define MOTOR_NIBBLE_LENGTH_PROSHOT  96 // 4uS
 #endif
 
-
-#define DSHOT_DMA_BUFFER_SIZE   18 /* resolution + frame reset (2us) */
-#define PROSHOT_DMA_BUFFER_SIZE 6  /* resolution + frame reset (2us) */
-
 typedef struct {
     TIM_TypeDef *timer;
 #if defined(USE_DSHOT) && defined(USE_DSHOT_DMAR)
@@ -139,6 +130,12 @@ typedef struct {
 #else
     uint8_t dmaBuffer[DSHOT_DMA_BUFFER_SIZE];
 #endif
+#ifdef USE_DSHOT_TELEMETRY
+    volatile bool isInput;                  // channel is capturing the ESC reply
+    uint8_t telemetryInvalidCount;          // replies missed in a row
+    uint16_t telemetryValue;                // last eRPM / 100 the ESC reported
+    uint32_t dmaInputBuffer[DSHOT_TELEMETRY_INPUT_LEN];
+#endif
 } motorDmaOutput_t;
 
 motorDmaOutput_t *getMotorDmaOutput(uint8_t index);
@@ -168,10 +165,14 @@ typedef struct motorDevConfig_s {
     uint8_t  motorPwmInversion;             // Active-High vs Active-Low. Useful for brushed FCs converted for brushless operation
     uint8_t  useUnsyncedPwm;
     uint8_t  useBurstDshot;
+    uint8_t  useDshotTelemetry;             // bidirectional DShot, the ESC answers every frame with its eRPM
     ioTag_t  ioTags[MAX_SUPPORTED_MOTORS];
 } motorDevConfig_t;
 
 extern bool useBurstDshot;
+#ifdef USE_DSHOT_TELEMETRY
+extern bool useDshotTelemetry;
+#endif
 
 void motorDevInit(const motorDevConfig_t *motorDevConfig, uint16_t idlePulse, uint8_t motorCount);
 
@@ -207,6 +208,14 @@ bool pwmDshotCommandIsProcessing(void);
 uint8_t pwmGetDshotCommand(uint8_t index);
 bool pwmDshotCommandOutputIsEnabled(uint8_t motorCount);
 
+#ifdef USE_DSHOT_TELEMETRY
+// replies missed in a row before a motor's eRPM is dropped to 0
+#define DSHOT_TELEMETRY_TIMEOUT_FRAMES  100
+
+void pwmDshotTelemetryReply(motorDmaOutput_t *const motor, uint16_t value);
+uint16_t getDshotTelemetry(uint8_t index);
+#endif
+
 #endif
 
 #ifdef USE_BEEPER
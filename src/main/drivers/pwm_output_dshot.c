@@ -44,6 +44,10 @@
 static uint8_t dmaMotorTimerCount = 0;
 static motorDmaTimer_t dmaMotorTimers[MAX_DMA_TIMERS];
 static motorDmaOutput_t dmaMotors[MAX_SUPPORTED_MOTORS];
+static uint32_t dshotMotorsPending;    // motors written since the last update, one bit each
+#ifdef USE_DSHOT_TELEMETRY
+static TIM_OCInitTypeDef dshotOcInit[MAX_SUPPORTED_MOTORS];    // to turn a channel back into an output after a reply
+#endif
 
 motorDmaOutput_t *getMotorDmaOutput(uint8_t index)
 {
@@ -78,28 +82,125 @@ void pwmWriteDshotInt(uint8_t index, uint16_t value)
     }
 
     motor->value = value;
+    dshotMotorsPending |= 1 << index;
+}
+
+// encode the motors written since the last update into their DMA buffers in one go
+static void loadDshotDmaBuffers(void)
+{
+    loadDmaBufferFn *const load = loadDmaBuffer;
+    uint32_t pending = dshotMotorsPending;
+    dshotMotorsPending = 0;
+
+    while (pending) {
+        motorDmaOutput_t *const motor = &dmaMotors[__builtin_ctz(pending)];
+        pending &= pending - 1;
 
-    uint16_t packet = prepareDshotPacket(motor);
-    uint8_t bufferSize;
+        const uint16_t packet = prepareDshotPacket(motor);
+        uint8_t bufferSize;
 
 #ifdef USE_DSHOT_DMAR
-    if (useBurstDshot) {
-        bufferSize = loadDmaBuffer(&motor->timer->dmaBurstBuffer[timerLookupChannelIndex(motor->timerHardware->channel)], 4, packet);
-        motor->timer->dmaBurstLength = bufferSize * 4;
-    } else
+        if (useBurstDshot) {
+            bufferSize = load(&motor->timer->dmaBurstBuffer[timerLookupChannelIndex(motor->timerHardware->channel)], 4, packet);
+            motor->timer->dmaBurstLength = bufferSize * 4;
+        } else
 #endif
-    {
-        bufferSize = loadDmaBuffer(motor->dmaBuffer, 1, packet);
-        motor->timer->timerDmaSources |= motor->timerDmaSource;
-        DMA_SetCurrDataCounter(motor->timerHardware->dmaRef, bufferSize);
-        DMA_Cmd(motor->timerHardware->dmaRef, ENABLE);
+        {
+            bufferSize = load(motor->dmaBuffer, 1, packet);
+            motor->timer->timerDmaSources |= motor->timerDmaSource;
+            DMA_SetCurrDataCounter(motor->timerHardware->dmaRef, bufferSize);
+            DMA_Cmd(motor->timerHardware->dmaRef, ENABLE);
+        }
     }
 }
 
+#ifdef USE_DSHOT_TELEMETRY
+/*
+ * Turns a channel between driving the DShot frame and capturing the edges of the ESC reply. The DMA
+ * stream keeps its setup, only the direction and the buffer change.
+ */
+static void pwmDshotSetDirectionOutput(motorDmaOutput_t *const motor, bool output)
+{
+    const timerHardware_t *const timerHardware = motor->timerHardware;
+    TIM_TypeDef *timer = timerHardware->tim;
+    DMA_Stream_TypeDef *dmaRef = timerHardware->dmaRef;
+
+    while (DMA_GetCmdStatus(dmaRef) != DISABLE);
+
+    if (output) {
+        // CCxNP must be clear on an output, TIM_OCInit only takes care of it on the advanced timers
+        timer->CCER &= ~(TIM_CCER_CC1NP << timerHardware->channel);
+        timerOCInit(timer, timerHardware->channel, &dshotOcInit[motor - dmaMotors]);
+        timerOCPreloadConfig(timer, timerHardware->channel, TIM_OCPreload_Enable);
+        dmaRef->CR = (dmaRef->CR & ~DMA_SxCR_DIR) | DMA_DIR_MemoryToPeripheral;
+        DMA_MemoryTargetConfig(dmaRef, (uint32_t)motor->dmaBuffer, DMA_Memory_0);
+    } else {
+        TIM_ICInitTypeDef icInit;
+        TIM_ICStructInit(&icInit);
+        icInit.TIM_Channel = timerHardware->channel;
+        icInit.TIM_ICPolarity = TIM_ICPolarity_BothEdge;
+        icInit.TIM_ICSelection = TIM_ICSelection_DirectTI;
+        icInit.TIM_ICPrescaler = TIM_ICPSC_DIV1;
+        icInit.TIM_ICFilter = 2;
+        TIM_ICInit(timer, &icInit);
+        dmaRef->CR = (dmaRef->CR & ~DMA_SxCR_DIR) | DMA_DIR_PeripheralToMemory;
+        DMA_MemoryTargetConfig(dmaRef, (uint32_t)motor->dmaInputBuffer, DMA_Memory_0);
+    }
+
+    motor->isInput = !output;
+}
+
+// called once the frame is out, the reply follows about 30us later
+static void pwmDshotStartCapture(motorDmaOutput_t *const motor)
+{
+    const timerHardware_t *const timerHardware = motor->timerHardware;
+
+    // let the counter run free so that all edges of the reply can be compared
+    TIM_SetAutoreload(timerHardware->tim, 0xffff);
+    pwmDshotSetDirectionOutput(motor, false);
+    DMA_SetCurrDataCounter(timerHardware->dmaRef, DSHOT_TELEMETRY_INPUT_LEN);
+    DMA_Cmd(timerHardware->dmaRef, ENABLE);
+    TIM_DMACmd(timerHardware->tim, motor->timerDmaSource, ENABLE);
+}
+
+// decodes the replies to the previous frame and gets the channels ready for the next one
+static void pwmDshotTelemetryReceive(void)
+{
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+        motorDmaOutput_t *const motor = &dmaMotors[i];
+        if (!motor->isInput) {
+            continue;
+        }
+
+        DMA_Stream_TypeDef *dmaRef = motor->timerHardware->dmaRef;
+        DMA_Cmd(dmaRef, DISABLE);
+        TIM_DMACmd(motor->timerHardware->tim, motor->timerDmaSource, DISABLE);
+        const int count = DSHOT_TELEMETRY_INPUT_LEN - DMA_GetCurrDataCounter(dmaRef);
+        pwmDshotTelemetryReply(motor, dshotDecodeTelemetry(motor->dmaInputBuffer, count));
+
+        pwmDshotSetDirectionOutput(motor, true);
+    }
+
+    for (int i = 0; i < dmaMotorTimerCount; i++) {
+        // the update event loads the bit length straight away instead of at the end of the free running period
+        TIM_SetAutoreload(dmaMotorTimers[i].timer, MOTOR_BITLENGTH);
+        TIM_GenerateEvent(dmaMotorTimers[i].timer, TIM_EventSource_Update);
+    }
+}
+#endif
+
 void pwmCompleteDshotMotorUpdate(uint8_t motorCount)
 {
     UNUSED(motorCount);
 
+#ifdef USE_DSHOT_TELEMETRY
+    if (useDshotTelemetry) {
+        pwmDshotTelemetryReceive();
+    }
+#endif
+
+    loadDshotDmaBuffers();
+
     /* If there is a dshot command loaded up, time it correctly with motor update*/
     if (pwmDshotCommandIsQueued()) {
         if (!pwmDshotCommandOutputIsEnabled(motorCount)) {
@@ -141,6 +242,13 @@ static void motor_DMA_IRQHandler(dmaChannelDescriptor_t *descriptor)
         }
 
         DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
+
+#ifdef USE_DSHOT_TELEMETRY
+        // complementary outputs can't capture, and a full input buffer is left for the next update to decode
+        if (useDshotTelemetry && !motor->isInput && !(motor->timerHardware->output & TIMER_OUTPUT_N_CHANNEL)) {
+            pwmDshotStartCapture(motor);
+        }
+#endif
     }
 }
 
@@ -215,6 +323,9 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
 
     timerOCInit(timer, timerHardware->channel, &TIM_OCInitStructure);
     timerOCPreloadConfig(timer, timerHardware->channel, TIM_OCPreload_Enable);
+#ifdef USE_DSHOT_TELEMETRY
+    dshotOcInit[motorIndex] = TIM_OCInitStructure;
+#endif
 
     if (output & TIMER_OUTPUT_N_CHANNEL) {
         TIM_CCxNCmd(timer, timerHardware->channel, TIM_CCxN_Enable);
@@ -37,6 +37,21 @@
 static FAST_RAM_ZERO_INIT uint8_t dmaMotorTimerCount = 0;
 static FAST_RAM_ZERO_INIT motorDmaTimer_t dmaMotorTimers[MAX_DMA_TIMERS];
 static FAST_RAM_ZERO_INIT motorDmaOutput_t dmaMotors[MAX_SUPPORTED_MOTORS];
+static FAST_RAM_ZERO_INIT uint32_t dshotMotorsPending;    // motors written since the last update, one bit each
+#ifdef USE_DSHOT_TELEMETRY
+static FAST_RAM_ZERO_INIT LL_TIM_OC_InitTypeDef dshotOcInit[MAX_SUPPORTED_MOTORS];    // to turn a channel back into an output after a reply
+#endif
+
+static uint32_t timerLLChannel(const timerHardware_t *timerHardware)
+{
+    switch (timerHardware->channel) {
+    default:
+    case TIM_CHANNEL_1: return LL_TIM_CHANNEL_CH1;
+    case TIM_CHANNEL_2: return LL_TIM_CHANNEL_CH2;
+    case TIM_CHANNEL_3: return LL_TIM_CHANNEL_CH3;
+    case TIM_CHANNEL_4: return LL_TIM_CHANNEL_CH4;
+    }
+}
 
 motorDmaOutput_t *getMotorDmaOutput(uint8_t index)
 {
@@ -71,28 +86,125 @@ FAST_CODE void pwmWriteDshotInt(uint8_t index, uint16_t value)
     }
 
     motor->value = value;
+    dshotMotorsPending |= 1 << index;
+}
 
-    uint16_t packet = prepareDshotPacket(motor);
-    uint8_t bufferSize;
+// encode the motors written since the last update into their DMA buffers in one go
+static FAST_CODE void loadDshotDmaBuffers(void)
+{
+    loadDmaBufferFn *const load = loadDmaBuffer;
+    uint32_t pending = dshotMotorsPending;
+    dshotMotorsPending = 0;
+
+    while (pending) {
+        motorDmaOutput_t *const motor = &dmaMotors[__builtin_ctz(pending)];
+        pending &= pending - 1;
+
+        const uint16_t packet = prepareDshotPacket(motor);
+        uint8_t bufferSize;
 
 #ifdef USE_DSHOT_DMAR
-    if (useBurstDshot) {
-        bufferSize = loadDmaBuffer(&motor->timer->dmaBurstBuffer[timerLookupChannelIndex(motor->timerHardware->channel)], 4, packet);
-        motor->timer->dmaBurstLength = bufferSize * 4;
-    } else
+        if (useBurstDshot) {
+            bufferSize = load(&motor->timer->dmaBurstBuffer[timerLookupChannelIndex(motor->timerHardware->channel)], 4, packet);
+            motor->timer->dmaBurstLength = bufferSize * 4;
+        } else
 #endif
-    {
-        bufferSize = loadDmaBuffer(motor->dmaBuffer, 1, packet);
-        motor->timer->timerDmaSources |= motor->timerDmaSource;
-        LL_EX_DMA_SetDataLength(motor->timerHardware->dmaRef, bufferSize);
-        LL_EX_DMA_EnableStream(motor->timerHardware->dmaRef);
+        {
+            bufferSize = load(motor->dmaBuffer, 1, packet);
+            motor->timer->timerDmaSources |= motor->timerDmaSource;
+            LL_EX_DMA_SetDataLength(motor->timerHardware->dmaRef, bufferSize);
+            LL_EX_DMA_EnableStream(motor->timerHardware->dmaRef);
+        }
     }
 }
 
+#ifdef USE_DSHOT_TELEMETRY
+/*
+ * Turns a channel between driving the DShot frame and capturing the edges of the ESC reply. The DMA
+ * stream keeps its setup, only the direction and the buffer change.
+ */
+static FAST_CODE void pwmDshotSetDirectionOutput(motorDmaOutput_t *const motor, bool output)
+{
+    const timerHardware_t *const timerHardware = motor->timerHardware;
+    TIM_TypeDef *timer = timerHardware->tim;
+    DMA_Stream_TypeDef *dmaRef = timerHardware->dmaRef;
+    const uint32_t channel = timerLLChannel(timerHardware);
+
+    while (LL_EX_DMA_IsEnabledStream(dmaRef));
+
+    if (output) {
+        // CCxNP must be clear on an output, LL_TIM_OC_Init only takes care of it on the advanced timers
+        CLEAR_BIT(timer->CCER, channel << 3);
+        LL_TIM_OC_Init(timer, channel, &dshotOcInit[motor - dmaMotors]);
+        LL_TIM_OC_EnablePreload(timer, channel);
+        LL_EX_DMA_SetDataTransferDirection(dmaRef, LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+        LL_EX_DMA_SetMemoryAddress(dmaRef, (uint32_t)motor->dmaBuffer);
+    } else {
+        LL_TIM_IC_InitTypeDef icInit;
+        LL_TIM_IC_StructInit(&icInit);
+        icInit.ICPolarity = LL_TIM_IC_POLARITY_BOTHEDGE;
+        icInit.ICActiveInput = LL_TIM_ACTIVEINPUT_DIRECTTI;
+        icInit.ICPrescaler = LL_TIM_ICPSC_DIV1;
+        icInit.ICFilter = LL_TIM_IC_FILTER_FDIV1_N4;
+        LL_TIM_IC_Init(timer, channel, &icInit);
+        LL_EX_DMA_SetDataTransferDirection(dmaRef, LL_DMA_DIRECTION_PERIPH_TO_MEMORY);
+        LL_EX_DMA_SetMemoryAddress(dmaRef, (uint32_t)motor->dmaInputBuffer);
+    }
+
+    motor->isInput = !output;
+}
+
+// called once the frame is out, the reply follows about 30us later
+static FAST_CODE void pwmDshotStartCapture(motorDmaOutput_t *const motor)
+{
+    const timerHardware_t *const timerHardware = motor->timerHardware;
+
+    // let the counter run free so that all edges of the reply can be compared
+    LL_TIM_SetAutoReload(timerHardware->tim, 0xffff);
+    pwmDshotSetDirectionOutput(motor, false);
+    LL_EX_DMA_SetDataLength(timerHardware->dmaRef, DSHOT_TELEMETRY_INPUT_LEN);
+    LL_EX_DMA_EnableStream(timerHardware->dmaRef);
+    LL_EX_TIM_EnableIT(timerHardware->tim, motor->timerDmaSource);
+}
+
+// decodes the replies to the previous frame and gets the channels ready for the next one
+static FAST_CODE void pwmDshotTelemetryReceive(void)
+{
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+        motorDmaOutput_t *const motor = &dmaMotors[i];
+        if (!motor->isInput) {
+            continue;
+        }
+
+        DMA_Stream_TypeDef *dmaRef = motor->timerHardware->dmaRef;
+        LL_EX_DMA_DisableStream(dmaRef);
+        LL_EX_TIM_DisableIT(motor->timerHardware->tim, motor->timerDmaSource);
+        const int count = DSHOT_TELEMETRY_INPUT_LEN - LL_EX_DMA_GetDataLength(dmaRef);
+        pwmDshotTelemetryReply(motor, dshotDecodeTelemetry(motor->dmaInputBuffer, count));
+
+        pwmDshotSetDirectionOutput(motor, true);
+    }
+
+    for (int i = 0; i < dmaMotorTimerCount; i++) {
+        // the update event loads the bit length straight away instead of at the end of the free running period
+        LL_TIM_SetAutoReload(dmaMotorTimers[i].timer, MOTOR_BITLENGTH);
+        LL_TIM_GenerateEvent_UPDATE(dmaMotorTimers[i].timer);
+    }
+}
+#endif
+
 FAST_CODE void pwmCompleteDshotMotorUpdate(uint8_t motorCount)
 {
     UNUSED(motorCount);
 
+#ifdef USE_DSHOT_TELEMETRY
+    if (useDshotTelemetry) {
+        pwmDshotTelemetryReceive();
+    }
+#endif
+
+    loadDshotDmaBuffers();
+
     /* If there is a dshot command loaded up, time it correctly with motor update*/
     if (pwmDshotCommandIsQueued()) {
         if (!pwmDshotCommandOutputIsEnabled(motorCount)) {
@@ -139,6 +251,13 @@ FAST_CODE static void motor_DMA_IRQHandler(dmaChannelDescriptor_t* descriptor)
         }
 
         DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
+
+#ifdef USE_DSHOT_TELEMETRY
+        // complementary outputs can't capture, and a full input buffer is left for the next update to decode
+        if (useDshotTelemetry && !motor->isInput && !(motor->timerHardware->output & TIMER_OUTPUT_N_CHANNEL)) {
+            pwmDshotStartCapture(motor);
+        }
+#endif
     }
 }
 
@@ -171,7 +290,13 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
     const uint8_t timerIndex = getTimerIndex(timer);
     const bool configureTimer = (timerIndex == dmaMotorTimerCount - 1);
 
-    IOConfigGPIOAF(motorIO, IO_CONFIG(GPIO_MODE_AF_PP, GPIO_SPEED_FREQ_VERY_HIGH, GPIO_PULLDOWN), timerHardware->alternateFunction);
+#ifdef USE_DSHOT_TELEMETRY
+    // the line idles high between frames and replies
+    const uint32_t pull = useDshotTelemetry ? GPIO_PULLUP : GPIO_PULLDOWN;
+#else
+    const uint32_t pull = GPIO_PULLDOWN;
+#endif
+    IOConfigGPIOAF(motorIO, IO_CONFIG(GPIO_MODE_AF_PP, GPIO_SPEED_FREQ_VERY_HIGH, pull), timerHardware->alternateFunction);
 
     if (configureTimer) {
         LL_TIM_InitTypeDef init;
@@ -201,15 +326,12 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
     }
     oc_init.CompareValue = 0;
 
-    uint32_t channel;
-    switch (timerHardware->channel) {
-    case TIM_CHANNEL_1: channel = LL_TIM_CHANNEL_CH1; break;
-    case TIM_CHANNEL_2: channel = LL_TIM_CHANNEL_CH2; break;
-    case TIM_CHANNEL_3: channel = LL_TIM_CHANNEL_CH3; break;
-    case TIM_CHANNEL_4: channel = LL_TIM_CHANNEL_CH4; break;
-    }
+    const uint32_t channel = timerLLChannel(timerHardware);
     LL_TIM_OC_Init(timer, channel, &oc_init);
     LL_TIM_OC_EnablePreload(timer, channel);
+#ifdef USE_DSHOT_TELEMETRY
+    dshotOcInit[motorIndex] = oc_init;
+#endif
     LL_TIM_OC_DisableFast(timer, channel);
 
     if (output & TIMER_OUTPUT_N_CHANNEL) {
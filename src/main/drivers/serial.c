@@ -20,9 +20,12 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
+#include "common/maths.h"
+
 #include "serial.h"
 
 void serialPrint(serialPort_t *instance, const char *str)
@@ -107,6 +110,13 @@ void serialSetBaudRateCb(serialPort_t *serialPort, void (*cb)(serialPort_t *cont
     }
 }
 
+void serialSetRxSpanCallback(serialPort_t *instance, serialReceiveSpanCallbackPtr rxSpanCallback)
+{
+    // Drivers that receive by DMA hand every completed run of bytes to this callback in one go,
+    // all other drivers keep calling the per byte rxCallback.
+    instance->rxSpanCallback = rxSpanCallback;
+}
+
 void serialWriteBufShim(void *instance, const uint8_t *data, int count)
 {
     serialWriteBuf((serialPort_t *)instance, data, count);
@@ -123,3 +133,60 @@ void serialEndWrite(serialPort_t *instance)
     if (instance->vTable->endWrite)
         instance->vTable->endWrite(instance);
 }
+
+// Reserve space in the transmit buffer to build output in place, never blocks.
+// Returns the number of contiguous bytes available at *buf, 0 if there is no room or the port
+// doesn't support it, in which case serialWriteBuf() must be used.
+int serialReserveWrite(serialPort_t *instance, uint8_t **buf)
+{
+    if (!instance->vTable->reserveWrite) {
+        return 0;
+    }
+    return instance->vTable->reserveWrite(instance, buf);
+}
+
+// Queue count bytes, at most what the preceding serialReserveWrite() returned, for transmission.
+void serialCommitWrite(serialPort_t *instance, int count)
+{
+    if (instance->vTable->commitWrite && count > 0) {
+        instance->vTable->commitWrite(instance, count);
+    }
+}
+
+int serialTxRingReserve(serialPort_t *instance, uint8_t **buf)
+{
+    // The free space starts at the head and is contiguous up to the end of the buffer,
+    // the driver's free count accounts for data still owned by the transmitter (e.g. DMA).
+    const uint32_t head = instance->txBufferHead;
+    *buf = (uint8_t *)&instance->txBuffer[head];
+    return MIN(serialTxBytesFree(instance), instance->txBufferSize - head);
+}
+
+void serialTxRingCommit(serialPort_t *instance, int count)
+{
+    uint32_t head = instance->txBufferHead + count;
+    if (head >= instance->txBufferSize) {
+        head -= instance->txBufferSize;
+    }
+    instance->txBufferHead = head;
+}
+
+// Copy as much of data into the transmit ring as fits, wrapping at the end of the buffer.
+// Returns the number of bytes queued; the caller still has to start the transmitter.
+int serialTxRingWrite(serialPort_t *instance, const uint8_t *data, int count)
+{
+    int written = 0;
+
+    // at most two passes, before and after the wrap
+    for (int pass = 0; pass < 2 && written < count; pass++) {
+        uint8_t *buf;
+        const int len = MIN(serialTxRingReserve(instance, &buf), count - written);
+        if (len <= 0) {
+            break;
+        }
+        memcpy(buf, data + written, len);
+        serialTxRingCommit(instance, len);
+        written += len;
+    }
+    return written;
+}
@@ -56,6 +56,7 @@ typedef enum {
 #define CTRL_LINE_STATE_RTS (1 << 1)
 
 typedef void (*serialReceiveCallbackPtr)(uint16_t data, void *rxCallbackData);   // used by serial drivers to return frames to app
+typedef void (*serialReceiveSpanCallbackPtr)(const uint8_t *data, int len, void *rxCallbackData);   // used by DMA capable drivers to return a run of bytes at once
 
 typedef struct serialPort_s {
 
@@ -76,6 +77,7 @@ typedef struct serialPort_s {
     uint32_t txBufferTail;
 
     serialReceiveCallbackPtr rxCallback;
+    serialReceiveSpanCallbackPtr rxSpanCallback;
     void *rxCallbackData;
 
     uint8_t identifier;
@@ -120,6 +122,10 @@ struct serialPortVTable {
     // Optional functions used to buffer large writes.
     void (*beginWrite)(serialPort_t *instance);
     void (*endWrite)(serialPort_t *instance);
+
+    // Optional non-blocking access to the transmit buffer, used to build output in place.
+    int (*reserveWrite)(serialPort_t *instance, uint8_t **buf);
+    void (*commitWrite)(serialPort_t *instance, int count);
 };
 
 void serialWrite(serialPort_t *instance, uint8_t ch);
@@ -131,6 +137,7 @@ void serialSetBaudRate(serialPort_t *instance, uint32_t baudRate);
 void serialSetMode(serialPort_t *instance, portMode_e mode);
 void serialSetCtrlLineStateCb(serialPort_t *instance, void (*cb)(void *context, uint16_t ctrlLineState), void *context);
 void serialSetBaudRateCb(serialPort_t *instance, void (*cb)(serialPort_t *context, uint32_t baud), serialPort_t *context);
+void serialSetRxSpanCallback(serialPort_t *instance, serialReceiveSpanCallbackPtr rxSpanCallback);
 bool isSerialTransmitBufferEmpty(const serialPort_t *instance);
 void serialPrint(serialPort_t *instance, const char *str);
 uint32_t serialGetBaudRate(serialPort_t *instance);
@@ -139,3 +146,10 @@ uint32_t serialGetBaudRate(serialPort_t *instance);
 void serialWriteBufShim(void *instance, const uint8_t *data, int count);
 void serialBeginWrite(serialPort_t *instance);
 void serialEndWrite(serialPort_t *instance);
+int serialReserveWrite(serialPort_t *instance, uint8_t **buf);
+void serialCommitWrite(serialPort_t *instance, int count);
+
+// Helpers for drivers that transmit from the txBuffer ring of serialPort_t
+int serialTxRingReserve(serialPort_t *instance, uint8_t **buf);
+void serialTxRingCommit(serialPort_t *instance, int count);
+int serialTxRingWrite(serialPort_t *instance, const uint8_t *data, int count);
@@ -611,6 +611,21 @@ void softSerialWriteByte(serialPort_t *s, uint8_t ch)
     s->txBufferHead = (s->txBufferHead + 1) % s->txBufferSize;
 }
 
+static void softSerialWriteBuf(serialPort_t *s, const void *data, int count)
+{
+    if ((s->mode & MODE_TX) == 0) {
+        return;
+    }
+
+    // the bit timer picks bytes up from the ring, wait for room like serialWriteBuf() does
+    const uint8_t *p = data;
+    while (count > 0) {
+        const int written = serialTxRingWrite(s, p, count);
+        p += written;
+        count -= written;
+    }
+}
+
 void softSerialSetBaudRate(serialPort_t *s, uint32_t baudRate)
 {
     softSerial_t *softSerial = (softSerial_t *)s;
@@ -640,9 +655,11 @@ static const struct serialPortVTable softSerialVTable = {
     .setMode = softSerialSetMode,
     .setCtrlLineStateCb = NULL,
     .setBaudRateCb = NULL,
-    .writeBuf = NULL,
+    .writeBuf = softSerialWriteBuf,
     .beginWrite = NULL,
-    .endWrite = NULL
+    .endWrite = NULL,
+    .reserveWrite = serialTxRingReserve,
+    .commitWrite = serialTxRingCommit
 };
 
 #endif
@@ -27,12 +27,15 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 
 #include "platform.h"
 
 #include "build/build_config.h"
 
+#include "common/maths.h"
+#include "common/ring_buffer.h"
 #include "common/utils.h"
 
 #include "io/serial.h"
@@ -89,11 +92,6 @@ static tcpPort_t* tcpReconfigure(tcpPort_t *s, int id)
         // TODO: clean up & re-init
         return NULL;
     }
-    if (pthread_mutex_init(&s->rxLock, NULL) != 0) {
-        fprintf(stderr, "RX mutex init failed - %d\n", errno);
-        // TODO: clean up & re-init
-        return NULL;
-    }
 
     tcpStart = true;
     tcpPortInitialized[id] = true;
@@ -129,6 +127,8 @@ serialPort_t *serTcpOpen(int id, serialReceiveCallbackPtr rxCallback, void *rxCa
     s->port.vTable = &tcpVTable;
 
     // common serial initialisation code should move to serialPort::init()
+    // RX goes through rxRing, filled by the dyad thread and drained by the main loop
+    ringBufferInit(&s->rxRing, s->rxBuffer, RX_BUFFER_SIZE);
     s->port.rxBufferHead = s->port.rxBufferTail = 0;
     s->port.txBufferHead = s->port.txBufferTail = 0;
     s->port.rxBufferSize = RX_BUFFER_SIZE;
@@ -149,30 +149,29 @@ serialPort_t *serTcpOpen(int id, serialReceiveCallbackPtr rxCallback, void *rxCa
 uint32_t tcpTotalRxBytesWaiting(const serialPort_t *instance)
 {
     tcpPort_t *s = (tcpPort_t*)instance;
-    uint32_t count;
-    pthread_mutex_lock(&s->rxLock);
-    if (s->port.rxBufferHead >= s->port.rxBufferTail) {
-        count = s->port.rxBufferHead - s->port.rxBufferTail;
-    } else {
-        count = s->port.rxBufferSize + s->port.rxBufferHead - s->port.rxBufferTail;
-    }
-    pthread_mutex_unlock(&s->rxLock);
 
-    return count;
+    return ringBufferUsed(&s->rxRing);
 }
 
-uint32_t tcpTotalTxBytesFree(const serialPort_t *instance)
+// txLock must be held
+static uint32_t tcpTxBytesFreeLocked(const tcpPort_t *s)
 {
-    tcpPort_t *s = (tcpPort_t*)instance;
     uint32_t bytesUsed;
 
-    pthread_mutex_lock(&s->txLock);
     if (s->port.txBufferHead >= s->port.txBufferTail) {
         bytesUsed = s->port.txBufferHead - s->port.txBufferTail;
     } else {
         bytesUsed = s->port.txBufferSize + s->port.txBufferHead - s->port.txBufferTail;
     }
-    uint32_t bytesFree = (s->port.txBufferSize - 1) - bytesUsed;
+    return (s->port.txBufferSize - 1) - bytesUsed;
+}
+
+uint32_t tcpTotalTxBytesFree(const serialPort_t *instance)
+{
+    tcpPort_t *s = (tcpPort_t*)instance;
+
+    pthread_mutex_lock(&s->txLock);
+    uint32_t bytesFree = tcpTxBytesFreeLocked(s);
     pthread_mutex_unlock(&s->txLock);
 
     return bytesFree;
@@ -189,17 +188,10 @@ bool isTcpTransmitBufferEmpty(const serialPort_t *instance)
 
 uint8_t tcpRead(serialPort_t *instance)
 {
-    uint8_t ch;
+    uint8_t ch = 0;
     tcpPort_t *s = (tcpPort_t *)instance;
-    pthread_mutex_lock(&s->rxLock);
 
-    ch = s->port.rxBuffer[s->port.rxBufferTail];
-    if (s->port.rxBufferTail + 1 >= s->port.rxBufferSize) {
-        s->port.rxBufferTail = 0;
-    } else {
-        s->port.rxBufferTail++;
-    }
-    pthread_mutex_unlock(&s->rxLock);
+    ringBufferPopByte(&s->rxRing, &ch);
 
     return ch;
 }
@@ -220,6 +212,66 @@ void tcpWrite(serialPort_t *instance, uint8_t ch)
     tcpDataOut(s);
 }
 
+// The serialTxRing helpers query the free space through the vtable, which takes txLock itself,
+// so the ring is reserved and filled here with the lock held throughout.
+static int tcpReserveWrite(serialPort_t *instance, uint8_t **buf)
+{
+    tcpPort_t *s = (tcpPort_t *)instance;
+
+    pthread_mutex_lock(&s->txLock);
+    const uint32_t head = s->port.txBufferHead;
+    *buf = (uint8_t *)&s->port.txBuffer[head];
+    const int len = MIN(tcpTxBytesFreeLocked(s), s->port.txBufferSize - head);
+    pthread_mutex_unlock(&s->txLock);
+
+    return len;
+}
+
+static void tcpWriteBuf(serialPort_t *instance, const void *data, int count)
+{
+    tcpPort_t *s = (tcpPort_t *)instance;
+    const uint8_t *p = data;
+
+    // the ring is drained straight into the socket buffer, so one pass normally takes it all
+    while (count > 0) {
+        int written = 0;
+
+        pthread_mutex_lock(&s->txLock);
+        // at most two copies, before and after the wrap
+        for (int pass = 0; pass < 2 && written < count; pass++) {
+            const uint32_t head = s->port.txBufferHead;
+            const int len = MIN(MIN(tcpTxBytesFreeLocked(s), s->port.txBufferSize - head), (uint32_t)(count - written));
+            if (len <= 0) {
+                break;
+            }
+            memcpy((uint8_t *)&s->port.txBuffer[head], p + written, len);
+            serialTxRingCommit(instance, len);
+            written += len;
+        }
+        pthread_mutex_unlock(&s->txLock);
+
+        if (!written) {
+            // nobody is connected to drain the ring
+            break;
+        }
+        p += written;
+        count -= written;
+
+        tcpDataOut(s);
+    }
+}
+
+static void tcpCommitWrite(serialPort_t *instance, int count)
+{
+    tcpPort_t *s = (tcpPort_t *)instance;
+
+    pthread_mutex_lock(&s->txLock);
+    serialTxRingCommit(instance, count);
+    pthread_mutex_unlock(&s->txLock);
+
+    tcpDataOut(s);
+}
+
 void tcpDataOut(tcpPort_t *instance)
 {
     tcpPort_t *s = (tcpPort_t *)instance;
@@ -243,19 +295,9 @@ void tcpDataOut(tcpPort_t *instance)
 void tcpDataIn(tcpPort_t *instance, uint8_t* ch, int size)
 {
     tcpPort_t *s = (tcpPort_t *)instance;
-    pthread_mutex_lock(&s->rxLock);
-
-    while (size--) {
-//        printf("%c", *ch);
-        s->port.rxBuffer[s->port.rxBufferHead] = *(ch++);
-        if (s->port.rxBufferHead + 1 >= s->port.rxBufferSize) {
-            s->port.rxBufferHead = 0;
-        } else {
-            s->port.rxBufferHead++;
-        }
-    }
-    pthread_mutex_unlock(&s->rxLock);
-//    printf("\n");
+
+    // bytes that don't fit are dropped, as a UART would on overrun
+    ringBufferPush(&s->rxRing, ch, size);
 }
 
 static const struct serialPortVTable tcpVTable = {
@@ -268,7 +310,9 @@ static const struct serialPortVTable tcpVTable = {
         .setMode = NULL,
         .setCtrlLineStateCb = NULL,
         .setBaudRateCb = NULL,
-        .writeBuf = NULL,
+        .writeBuf = tcpWriteBuf,
         .beginWrite = NULL,
         .endWrite = NULL,
+        .reserveWrite = tcpReserveWrite,
+        .commitWrite = tcpCommitWrite,
 };
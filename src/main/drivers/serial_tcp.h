@@ -24,18 +24,20 @@
 #include <pthread.h>
 #include "dyad.h"
 
-#define RX_BUFFER_SIZE    1400
+#include "common/ring_buffer.h"
+
+#define RX_BUFFER_SIZE    2048  // power of two for rxRing
 #define TX_BUFFER_SIZE    1400
 
 typedef struct {
     serialPort_t port;
     uint8_t rxBuffer[RX_BUFFER_SIZE];
+    ringBuffer_t rxRing;
     uint8_t txBuffer[TX_BUFFER_SIZE];
 
     dyad_Stream *serv;
     dyad_Stream *conn;
     pthread_mutex_t txLock;
-    pthread_mutex_t rxLock;
     bool connected;
     uint16_t clientCount;
     uint8_t id;
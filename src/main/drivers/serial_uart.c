@@ -141,6 +141,45 @@ void uartTryStartTxDMA(uartPort_t *s)
     }
 }
 
+static void uartRxDmaDeliverSpan(uartPort_t *s, uint32_t from, uint32_t to)
+{
+    const uint8_t *data = (const uint8_t *)&s->port.rxBuffer[from];
+    const int len = to - from;
+
+    if (s->port.rxSpanCallback) {
+        s->port.rxSpanCallback(data, len, s->port.rxCallbackData);
+    } else {
+        for (int i = 0; i < len; i++) {
+            s->port.rxCallback(data[i], s->port.rxCallbackData);
+        }
+    }
+}
+
+// Called from the USART idle line interrupt when RX runs on a circular DMA with a receive callback.
+// Everything the DMA wrote since the last call is handed over as at most two spans, the second one
+// when the write wrapped around the end of the buffer.
+void uartRxDmaIdle(uartPort_t *s)
+{
+#ifdef STM32F4
+    const uint32_t dmaRemaining = s->rxDMAStream->NDTR;
+#else
+    const uint32_t dmaRemaining = s->rxDMAChannel->CNDTR;
+#endif
+    // rxDMAPos and the DMA counter both count down from rxBufferSize
+    const uint32_t tail = s->port.rxBufferSize - s->rxDMAPos;
+    const uint32_t head = (s->port.rxBufferSize - dmaRemaining) % s->port.rxBufferSize;
+
+    if (head < tail) {
+        uartRxDmaDeliverSpan(s, tail, s->port.rxBufferSize);
+        if (head) {
+            uartRxDmaDeliverSpan(s, 0, head);
+        }
+    } else if (head > tail) {
+        uartRxDmaDeliverSpan(s, tail, head);
+    }
+    s->rxDMAPos = s->port.rxBufferSize - head;
+}
+
 static uint32_t uartTotalRxBytesWaiting(const serialPort_t *instance)
 {
     const uartPort_t *s = (const uartPort_t*)instance;
@@ -246,16 +285,8 @@ static uint8_t uartRead(serialPort_t *instance)
     return ch;
 }
 
-static void uartWrite(serialPort_t *instance, uint8_t ch)
+static void uartStartTx(uartPort_t *s)
 {
-    uartPort_t *s = (uartPort_t *)instance;
-    s->port.txBuffer[s->port.txBufferHead] = ch;
-    if (s->port.txBufferHead + 1 >= s->port.txBufferSize) {
-        s->port.txBufferHead = 0;
-    } else {
-        s->port.txBufferHead++;
-    }
-
 #ifdef STM32F4
     if (s->txDMAStream)
 #else
@@ -268,6 +299,46 @@ static void uartWrite(serialPort_t *instance, uint8_t ch)
     }
 }
 
+static void uartWrite(serialPort_t *instance, uint8_t ch)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+    s->port.txBuffer[s->port.txBufferHead] = ch;
+    if (s->port.txBufferHead + 1 >= s->port.txBufferSize) {
+        s->port.txBufferHead = 0;
+    } else {
+        s->port.txBufferHead++;
+    }
+
+    uartStartTx(s);
+}
+
+// Copy the whole buffer into the TX ring and start the transmitter once, instead of per byte.
+static void uartWriteBuf(serialPort_t *instance, const void *data, int count)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+    const uint8_t *p = data;
+
+    while (count > 0) {
+        const int written = serialTxRingWrite(instance, p, count);
+        p += written;
+        count -= written;
+        if (count > 0) {
+            // TX ring is full, get it draining and wait for room like serialWriteBuf() does
+            uartStartTx(s);
+            while (!uartTotalTxBytesFree(instance)) {
+            };
+        }
+    }
+
+    uartStartTx(s);
+}
+
+static void uartCommitWrite(serialPort_t *instance, int count)
+{
+    serialTxRingCommit(instance, count);
+    uartStartTx((uartPort_t *)instance);
+}
+
 const struct serialPortVTable uartVTable[] = {
     {
         .serialWrite = uartWrite,
@@ -279,9 +350,11 @@ const struct serialPortVTable uartVTable[] = {
         .setMode = uartSetMode,
         .setCtrlLineStateCb = NULL,
         .setBaudRateCb = NULL,
-        .writeBuf = NULL,
+        .writeBuf = uartWriteBuf,
         .beginWrite = NULL,
         .endWrite = NULL,
+        .reserveWrite = serialTxRingReserve,
+        .commitWrite = uartCommitWrite,
     }
 };
 
@@ -140,6 +140,12 @@ void uartReconfigure(uartPort_t *uartPort)
 
             uartPort->rxDMAPos = __HAL_DMA_GET_COUNTER(&uartPort->rxDMAHandle);
 
+            if (uartPort->port.rxCallback) {
+                /* Hand received bytes to the callback once per burst, when the line goes idle */
+                __HAL_UART_CLEAR_IDLEFLAG(&uartPort->Handle);
+                SET_BIT(uartPort->USARTx->CR1, USART_CR1_IDLEIE);
+            }
+
         }
         else
         {
@@ -204,8 +210,9 @@ serialPort_t *uartOpen(UARTDevice_e device, serialReceiveCallbackPtr callback, v
     // common serial initialisation code should move to serialPort::init()
     s->port.rxBufferHead = s->port.rxBufferTail = 0;
     s->port.txBufferHead = s->port.txBufferTail = 0;
-    // callback works for IRQ-based RX ONLY
+    // with RX DMA the callback is run from the idle line interrupt
     s->port.rxCallback = callback;
+    s->port.rxSpanCallback = NULL;
     s->port.rxCallbackData = callbackData;
     s->port.mode = mode;
     s->port.baudRate = baudRate;
@@ -252,6 +259,41 @@ void uartStartTxDMA(uartPort_t *s)
     HAL_UART_Transmit_DMA(&s->Handle, (uint8_t *)&s->port.txBuffer[fromwhere], size);
 }
 
+static void uartRxDmaDeliverSpan(uartPort_t *s, uint32_t from, uint32_t to)
+{
+    const uint8_t *data = (const uint8_t *)&s->port.rxBuffer[from];
+    const int len = to - from;
+
+    if (s->port.rxSpanCallback) {
+        s->port.rxSpanCallback(data, len, s->port.rxCallbackData);
+    } else {
+        for (int i = 0; i < len; i++) {
+            s->port.rxCallback(data[i], s->port.rxCallbackData);
+        }
+    }
+}
+
+// Called from the USART idle line interrupt when RX runs on a circular DMA with a receive callback.
+// Everything the DMA wrote since the last call is handed over as at most two spans, the second one
+// when the write wrapped around the end of the buffer.
+void uartRxDmaIdle(uartPort_t *s)
+{
+    const uint32_t dmaRemaining = __HAL_DMA_GET_COUNTER(s->Handle.hdmarx);
+    // rxDMAPos and the DMA counter both count down from rxBufferSize
+    const uint32_t tail = s->port.rxBufferSize - s->rxDMAPos;
+    const uint32_t head = (s->port.rxBufferSize - dmaRemaining) % s->port.rxBufferSize;
+
+    if (head < tail) {
+        uartRxDmaDeliverSpan(s, tail, s->port.rxBufferSize);
+        if (head) {
+            uartRxDmaDeliverSpan(s, 0, head);
+        }
+    } else if (head > tail) {
+        uartRxDmaDeliverSpan(s, tail, head);
+    }
+    s->rxDMAPos = s->port.rxBufferSize - head;
+}
+
 uint32_t uartTotalRxBytesWaiting(const serialPort_t *instance)
 {
     uartPort_t *s = (uartPort_t*)instance;
@@ -338,6 +380,16 @@ uint8_t uartRead(serialPort_t *instance)
     return ch;
 }
 
+static void uartStartTx(uartPort_t *s)
+{
+    if (s->txDMAStream) {
+        if (!(s->txDMAStream->CR & 1))
+            uartStartTxDMA(s);
+    } else {
+        __HAL_UART_ENABLE_IT(&s->Handle, UART_IT_TXE);
+    }
+}
+
 void uartWrite(serialPort_t *instance, uint8_t ch)
 {
     uartPort_t *s = (uartPort_t *)instance;
@@ -348,12 +400,34 @@ void uartWrite(serialPort_t *instance, uint8_t ch)
         s->port.txBufferHead++;
     }
 
-    if (s->txDMAStream) {
-        if (!(s->txDMAStream->CR & 1))
-            uartStartTxDMA(s);
-    } else {
-        __HAL_UART_ENABLE_IT(&s->Handle, UART_IT_TXE);
+    uartStartTx(s);
+}
+
+// Copy the whole buffer into the TX ring and start the transmitter once, instead of per byte.
+static void uartWriteBuf(serialPort_t *instance, const void *data, int count)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+    const uint8_t *p = data;
+
+    while (count > 0) {
+        const int written = serialTxRingWrite(instance, p, count);
+        p += written;
+        count -= written;
+        if (count > 0) {
+            // TX ring is full, get it draining and wait for room like serialWriteBuf() does
+            uartStartTx(s);
+            while (!uartTotalTxBytesFree(instance)) {
+            };
+        }
     }
+
+    uartStartTx(s);
+}
+
+static void uartCommitWrite(serialPort_t *instance, int count)
+{
+    serialTxRingCommit(instance, count);
+    uartStartTx((uartPort_t *)instance);
 }
 
 const struct serialPortVTable uartVTable[] = {
@@ -367,9 +441,11 @@ const struct serialPortVTable uartVTable[] = {
         .setMode = uartSetMode,
         .setCtrlLineStateCb = NULL,
         .setBaudRateCb = NULL,
-        .writeBuf = NULL,
+        .writeBuf = uartWriteBuf,
         .beginWrite = NULL,
         .endWrite = NULL,
+        .reserveWrite = serialTxRingReserve,
+        .commitWrite = uartCommitWrite,
     }
 };
 
@@ -176,7 +176,8 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
     }
 
     // RX/TX Interrupt
-    if (!hardware->rxDMAChannel || !hardware->txDMAChannel) {
+    // Also needed with RX and TX DMA, the idle line interrupt runs the receive callback
+    {
         NVIC_InitTypeDef NVIC_InitStructure;
 
         NVIC_InitStructure.NVIC_IRQChannel = hardware->irqn;
@@ -204,7 +205,12 @@ void uartIrqHandler(uartPort_t *s)
             }
         }
     }
-    if (SR & USART_FLAG_TXE) {
+    if (SR & USART_FLAG_IDLE && s->rxDMAChannel && s->port.rxCallback) {
+        // reading SR then DR clears the idle flag
+        (void)s->USARTx->DR;
+        uartRxDmaIdle(s);
+    }
+    if (!s->txDMAChannel && (SR & USART_FLAG_TXE)) {
         if (s->port.txBufferTail != s->port.txBufferHead) {
             s->USARTx->DR = s->port.txBuffer[s->port.txBufferTail++];
             if (s->port.txBufferTail >= s->port.txBufferSize) {
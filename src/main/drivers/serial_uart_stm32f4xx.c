@@ -256,7 +256,8 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
         }
     }
 
-    if (!(s->rxDMAChannel)) {
+    // Also needed with RX DMA, the idle line interrupt runs the receive callback
+    {
         NVIC_InitTypeDef NVIC_InitStructure;
 
         NVIC_InitStructure.NVIC_IRQChannel = hardware->irqn;
@@ -280,6 +281,12 @@ void uartIrqHandler(uartPort_t *s)
         }
     }
 
+    if (s->rxDMAStream && s->port.rxCallback && (USART_GetITStatus(s->USARTx, USART_IT_IDLE) == SET)) {
+        // reading SR then DR clears the idle flag
+        (void)s->USARTx->DR;
+        uartRxDmaIdle(s);
+    }
+
     if (!s->txDMAStream && (USART_GetITStatus(s->USARTx, USART_IT_TXE) == SET)) {
         if (s->port.txBufferTail != s->port.txBufferHead) {
             USART_SendData(s->USARTx, s->port.txBuffer[s->port.txBufferTail]);
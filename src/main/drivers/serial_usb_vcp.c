@@ -20,6 +20,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -122,16 +123,21 @@ static uint8_t usbVcpRead(serialPort_t *instance)
     }
 }
 
-static void usbVcpWriteBuf(serialPort_t *instance, const void *data, int count)
+static bool usbVcpFlush(vcpPort_t *port)
 {
-    UNUSED(instance);
+    uint32_t count = port->txAt;
+    port->txAt = 0;
 
-    if (!(usbIsConnected() && usbIsConfigured())) {
-        return;
+    if (count == 0) {
+        return true;
+    }
+
+    if (!usbIsConnected() || !usbIsConfigured()) {
+        return false;
     }
 
     uint32_t start = millis();
-    const uint8_t *p = data;
+    uint8_t *p = port->txBuf;
     while (count > 0) {
         uint32_t txed = CDC_Send_DATA(p, count);
         count -= txed;
@@ -141,23 +147,27 @@ static void usbVcpWriteBuf(serialPort_t *instance, const void *data, int count)
             break;
         }
     }
+    return count == 0;
 }
 
-static bool usbVcpFlush(vcpPort_t *port)
+static void usbVcpWriteBuf(serialPort_t *instance, const void *data, int count)
 {
-    uint32_t count = port->txAt;
-    port->txAt = 0;
+    vcpPort_t *port = container_of(instance, vcpPort_t, port);
 
-    if (count == 0) {
-        return true;
+    if (port->buffering && port->txAt + count <= (int)ARRAYLEN(port->txBuf)) {
+        // small writes join the bytes already buffered and go out in the same packet
+        memcpy(&port->txBuf[port->txAt], data, count);
+        port->txAt += count;
+        return;
     }
 
-    if (!usbIsConnected() || !usbIsConfigured()) {
-        return false;
+    // anything buffered has to go out first to keep the byte order
+    if (!usbVcpFlush(port) || !(usbIsConnected() && usbIsConfigured())) {
+        return;
     }
 
     uint32_t start = millis();
-    uint8_t *p = port->txBuf;
+    const uint8_t *p = data;
     while (count > 0) {
         uint32_t txed = CDC_Send_DATA(p, count);
         count -= txed;
@@ -167,7 +177,6 @@ static bool usbVcpFlush(vcpPort_t *port)
             break;
         }
     }
-    return count == 0;
 }
 
 static void usbVcpWrite(serialPort_t *instance, uint8_t c)
@@ -180,6 +189,24 @@ static void usbVcpWrite(serialPort_t *instance, uint8_t c)
     }
 }
 
+static int usbVcpReserveWrite(serialPort_t *instance, uint8_t **buf)
+{
+    vcpPort_t *port = container_of(instance, vcpPort_t, port);
+
+    *buf = &port->txBuf[port->txAt];
+    return ARRAYLEN(port->txBuf) - port->txAt;
+}
+
+static void usbVcpCommitWrite(serialPort_t *instance, int count)
+{
+    vcpPort_t *port = container_of(instance, vcpPort_t, port);
+
+    port->txAt += count;
+    if (!port->buffering || port->txAt >= ARRAYLEN(port->txBuf)) {
+        usbVcpFlush(port);
+    }
+}
+
 static void usbVcpBeginWrite(serialPort_t *instance)
 {
     vcpPort_t *port = container_of(instance, vcpPort_t, port);
@@ -212,7 +239,9 @@ static const struct serialPortVTable usbVTable[] = {
         .setBaudRateCb = usbVcpSetBaudRateCb,
         .writeBuf = usbVcpWriteBuf,
         .beginWrite = usbVcpBeginWrite,
-        .endWrite = usbVcpEndWrite
+        .endWrite = usbVcpEndWrite,
+        .reserveWrite = usbVcpReserveWrite,
+        .commitWrite = usbVcpCommitWrite
     }
 };
 
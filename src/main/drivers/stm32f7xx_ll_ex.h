@@ -77,6 +77,21 @@ __STATIC_INLINE void LL_EX_DMA_DisableStream(DMA_Stream_TypeDef *DMAx_Streamy)
 	CLEAR_BIT(DMAx_Streamy->CR, DMA_SxCR_EN);
 }
 
+__STATIC_INLINE uint32_t LL_EX_DMA_IsEnabledStream(DMA_Stream_TypeDef *DMAx_Streamy)
+{
+	return (READ_BIT(DMAx_Streamy->CR, DMA_SxCR_EN) == DMA_SxCR_EN);
+}
+
+__STATIC_INLINE void LL_EX_DMA_SetDataTransferDirection(DMA_Stream_TypeDef *DMAx_Streamy, uint32_t Direction)
+{
+	MODIFY_REG(DMAx_Streamy->CR, DMA_SxCR_DIR, Direction);
+}
+
+__STATIC_INLINE void LL_EX_DMA_SetMemoryAddress(DMA_Stream_TypeDef *DMAx_Streamy, uint32_t MemoryAddress)
+{
+	WRITE_REG(DMAx_Streamy->M0AR, MemoryAddress);
+}
+
 __STATIC_INLINE void LL_EX_DMA_EnableIT_TC(DMA_Stream_TypeDef *DMAx_Streamy)
 {
 	SET_BIT(DMAx_Streamy->CR, DMA_SxCR_TCIE);
@@ -87,6 +102,11 @@ __STATIC_INLINE void LL_EX_DMA_SetDataLength(DMA_Stream_TypeDef* DMAx_Streamy, u
  	MODIFY_REG(DMAx_Streamy->NDTR, DMA_SxNDT, NbData);
 }
 
+__STATIC_INLINE uint32_t LL_EX_DMA_GetDataLength(DMA_Stream_TypeDef* DMAx_Streamy)
+{
+	return READ_BIT(DMAx_Streamy->NDTR, DMA_SxNDT);
+}
+
 __STATIC_INLINE void LL_EX_TIM_EnableIT(TIM_TypeDef *TIMx, uint32_t Sources)
 {
 	SET_BIT(TIMx->DIER, Sources);
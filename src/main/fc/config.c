@@ -145,6 +145,8 @@ static void activateConfig(void)
     accInitFilters();
 
     imuConfigure(throttleCorrectionConfig()->throttle_correction_angle);
+
+    mixerInitPlan();
 #endif // USE_OSD_SLAVE
 
 #ifdef USE_LED_STRIP
@@ -57,6 +57,7 @@
 #include "fc/controlrate_profile.h"
 #include "fc/fc_core.h"
 #include "fc/fc_rc.h"
+#include "fc/loop_state.h"
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
 #include "fc/runtime_config.h"
@@ -88,6 +89,7 @@
 #include "flight/mixer.h"
 #include "flight/pid.h"
 #include "flight/servos.h"
+#include "flight/rpm_filter.h"
 #include "flight/gps_rescue.h"
 
 
@@ -134,6 +136,7 @@ static bool flipOverAfterCrashMode = false;
 static timeUs_t disarmAt;     // Time of automatic disarm when "Don't spin the motors when armed" is enabled and auto_disarm_delay is nonzero
 
 bool isRXDataNew;
+static timeUs_t rxLatencyFrameUs;   // frame behind the rcCommand update waiting for its motor write, DEBUG_RX_LATENCY only
 static int lastArmingDisabledReason = 0;
 static timeUs_t lastDisarmTimeUs;
 static int tryingToArm = ARMING_DELAYED_DISARMED;
@@ -968,12 +971,40 @@ static FAST_CODE void subTaskMotorUpdate(timeUs_t currentTimeUs)
 
     writeMotors();
 
+#ifdef USE_RPM_FILTER
+    rpmFilterUpdate();
+#endif
+
     DEBUG_SET(DEBUG_PIDLOOP, 2, micros() - startTime);
+
+    if (rxLatencyFrameUs) {
+        debug[1] = micros() - rxLatencyFrameUs;
+        rxLatencyFrameUs = 0;
+    }
 }
 
 static FAST_CODE_NOINLINE void subTaskRcCommand(timeUs_t currentTimeUs)
 {
-    UNUSED(currentTimeUs);
+#ifdef USE_RX_FRAME_EVENT
+    // Take a frame completed since the last iteration straight away rather than waiting for TASK_RX
+    const bool frameEvent = rxProcessFrameEvent(currentTimeUs);
+    if (frameEvent) {
+        updateRcCommands();
+    }
+#else
+    const bool frameEvent = false;
+#endif
+
+    // DEBUG_RX_LATENCY, times since the end of the RX frame:
+    // 0 - rcCommand used by the PID loop
+    // 1 - first motor write with the new rcCommand
+    // 2 - 1 if the frame was delivered by frame event, 0 if by TASK_RX
+    // 3 - frame decoded by the PID loop (frame event only)
+    if (debugMode == DEBUG_RX_LATENCY && isRXDataNew) {
+        rxLatencyFrameUs = rxGetFrameTimeUs();
+        debug[0] = currentTimeUs - rxLatencyFrameUs;
+        debug[2] = frameEvent;
+    }
 
     // If we're armed, at minimum throttle, and we do arming via the
     // sticks, do not process yaw input from the rx.  We do this so the
@@ -991,7 +1022,7 @@ static FAST_CODE_NOINLINE void subTaskRcCommand(timeUs_t currentTimeUs)
         resetYawAxis();
     }
 
-    processRcCommand();
+    processRcCommand(currentTimeUs);
 
 }
 
@@ -1037,6 +1068,7 @@ FAST_CODE void taskMainPidLoop(timeUs_t currentTimeUs)
         }
         subTaskPidController(currentTimeUs);
         subTaskMotorUpdate(currentTimeUs);
+        loopStatePublish(currentTimeUs);
         subTaskPidSubprocesses(currentTimeUs);
     }
 
@@ -224,6 +224,33 @@ float applyRaceFlightRates(const int axis, float rcCommandf, const float rcComma
     return angleRate;
 }
 
+// Rate curves are odd functions of stick deflection, so each axis is tabulated over [0, 1] and
+// evaluated by linear interpolation. The tables are rebuilt by initRcProcessing() whenever the
+// rate profile changes, which keeps expo/superrate maths out of the setpoint path.
+#define RATE_LOOKUP_SEGMENTS 128
+
+static FAST_RAM_ZERO_INIT float rateLookup[3][RATE_LOOKUP_SEGMENTS + 1];
+
+static void buildRateLookupTables(void)
+{
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        for (int i = 0; i <= RATE_LOOKUP_SEGMENTS; i++) {
+            const float rcCommandfAbs = (float)i / RATE_LOOKUP_SEGMENTS;
+            rateLookup[axis][i] = constrainf(applyRates(axis, rcCommandfAbs, rcCommandfAbs), -SETPOINT_RATE_LIMIT, SETPOINT_RATE_LIMIT);
+        }
+    }
+}
+
+static FAST_CODE float rateLookupApply(const int axis, const float rcCommandf, const float rcCommandfAbs)
+{
+    const float position = MIN(rcCommandfAbs, 1.0f) * RATE_LOOKUP_SEGMENTS;
+    const int index = MIN((int)position, RATE_LOOKUP_SEGMENTS - 1);
+    const float *lookup = rateLookup[axis];
+    const float angleRate = lookup[index] + (position - index) * (lookup[index + 1] - lookup[index]);
+
+    return rcCommandf < 0 ? -angleRate : angleRate;
+}
+
 static void calculateSetpointRate(int axis)
 {
     static volatile float angleRate;
@@ -245,7 +272,7 @@ static void calculateSetpointRate(int axis)
         const float rcCommandfAbs = ABS(rcCommandf);
         rcDeflectionAbs[axis] = rcCommandfAbs;
 
-        angleRate = applyRates(axis, rcCommandf, rcCommandfAbs);
+        angleRate = rateLookupApply(axis, rcCommandf, rcCommandfAbs);
     }
     setpointRate[axis] = constrainf(angleRate, -SETPOINT_RATE_LIMIT, SETPOINT_RATE_LIMIT); // Rate limit protection (deg/sec)
 
@@ -277,8 +304,6 @@ static void scaleRcCommandToFpvCamAngle(void)
 
 static void checkForThrottleErrorResetState(uint16_t rxRefreshRate)
 {
-    currentRxRefreshRate = constrain(getTaskDeltaTime(TASK_RX),1000,20000);
-
     static int index;
     static int16_t rcCommandThrottlePrevious[THROTTLE_BUFFER_MAX];
 
@@ -302,20 +327,65 @@ static void checkForThrottleErrorResetState(uint16_t rxRefreshRate)
     }
 }
 
-FAST_CODE uint8_t processRcInterpolation(void)
+#define RX_FRAME_INTERVAL_MIN_US    1000
+#define RX_FRAME_INTERVAL_MAX_US    20000
+#define RX_FRAME_JITTER_MARGIN      2   // ramps are stretched by this many mean deviations so late frames don't cause a hold
+
+static FAST_RAM_ZERO_INIT timeUs_t rxFramePrevTimeUs;
+static FAST_RAM_ZERO_INIT float rxFrameIntervalUs;     // running average of the frame interval
+static FAST_RAM_ZERO_INIT float rxFrameJitterUs;       // running mean deviation from that average
+
+// Measure the rx frame interval from the frame arrival timestamps, so scheduling
+// delays between frame arrival and processing don't show up as rate changes.
+static void updateRxFrameInterval(timeUs_t frameTimeUs)
 {
-    static FAST_RAM_ZERO_INIT float rcCommandInterp[4];
-    static FAST_RAM_ZERO_INIT float rcStepSize[4];
-    static FAST_RAM_ZERO_INIT int16_t rcInterpolationStepCount;
+    const timeDelta_t frameDeltaUs = cmpTimeUs(frameTimeUs, rxFramePrevTimeUs);
+    rxFramePrevTimeUs = frameTimeUs;
 
-    uint16_t rxRefreshRate;
+    if (frameDeltaUs < RX_FRAME_INTERVAL_MIN_US || frameDeltaUs > RX_FRAME_INTERVAL_MAX_US) {
+        // first frame or a signal gap, nothing to measure
+        if (!currentRxRefreshRate) {
+            currentRxRefreshRate = constrain(rxGetRefreshRate(), RX_FRAME_INTERVAL_MIN_US, RX_FRAME_INTERVAL_MAX_US);
+        }
+        return;
+    }
+
+    currentRxRefreshRate = frameDeltaUs;
+    if (rxFrameIntervalUs == 0.0f) {
+        rxFrameIntervalUs = frameDeltaUs;
+    }
+    rxFrameIntervalUs += (frameDeltaUs - rxFrameIntervalUs) * 0.125f;
+    rxFrameJitterUs += (fabsf(frameDeltaUs - rxFrameIntervalUs) - rxFrameJitterUs) * 0.125f;
+}
+
+// Each new frame is extrapolated to the current PID time along the slope of the last two frames,
+// using the frames' arrival timestamps, so a steadily moving stick comes through without the lag
+// of a ramp and jitter in frame arrival or processing doesn't turn into setpoint steps. The
+// difference between the previous output and the new prediction is faded out over the ramp, and
+// the look-ahead ends with the ramp so a lost frame holds instead of running away.
+// Updates without a new frame (failsafe, aux or 50Hz processing) ramp to the new value from now.
+FAST_CODE uint8_t processRcInterpolation(timeUs_t currentTimeUs)
+{
+    static FAST_RAM_ZERO_INIT float rcCommandInterp[4];
+    static FAST_RAM_ZERO_INIT float rcFrameValue[4];
+    static FAST_RAM_ZERO_INIT float rcFrameSlope[4];       // per microsecond
+    static FAST_RAM_ZERO_INIT float rcCorrection[4];       // prediction error when the frame was picked up
+    static FAST_RAM_ZERO_INIT timeUs_t rcFrameTimeUs;
+    static FAST_RAM_ZERO_INIT timeUs_t rcRampStartUs;
+    static FAST_RAM_ZERO_INIT timeDelta_t rcRampLengthUs;
+
+    timeDelta_t rxRefreshRate;
     uint8_t updatedChannel = 0;
 
     if (rxConfig()->rcInterpolation) {
          // Set RC refresh rate for sampling and channels to filter
         switch (rxConfig()->rcInterpolation) {
         case RC_SMOOTHING_AUTO:
-            rxRefreshRate = currentRxRefreshRate + 1000; // Add slight overhead to prevent ramps
+            if (rxFrameIntervalUs > 0.0f) {
+                rxRefreshRate = lrintf(rxFrameIntervalUs + RX_FRAME_JITTER_MARGIN * rxFrameJitterUs);
+            } else {
+                rxRefreshRate = currentRxRefreshRate + 1000; // Add slight overhead to prevent ramps
+            }
             break;
         case RC_SMOOTHING_MANUAL:
             rxRefreshRate = 1000 * rxConfig()->rcInterpolationInterval;
@@ -327,31 +397,56 @@ FAST_CODE uint8_t processRcInterpolation(void)
         }
 
         if (isRXDataNew && rxRefreshRate > 0) {
-            rcInterpolationStepCount = rxRefreshRate / constrain(targetPidLooptime, 125, targetPidLooptime);
+            const timeUs_t frameTimeUs = rxGetFrameTimeUs();
+            const timeDelta_t frameDeltaUs = cmpTimeUs(frameTimeUs, rcFrameTimeUs);
+            const bool newFrame = frameDeltaUs > 0 && rxIsReceivingSignal() && !failsafeIsActive();
+            const bool predict = newFrame && frameDeltaUs >= RX_FRAME_INTERVAL_MIN_US && frameDeltaUs <= RX_FRAME_INTERVAL_MAX_US;
+
+            rcRampStartUs = newFrame ? frameTimeUs : currentTimeUs;
+            rcRampLengthUs = rxRefreshRate;
+            if (newFrame) {
+                rcFrameTimeUs = frameTimeUs;
+            }
 
+            const timeDelta_t elapsedUs = constrain(cmpTimeUs(currentTimeUs, rcRampStartUs), 0, rcRampLengthUs);
+            const float remaining = 1.0f - (float)elapsedUs / rcRampLengthUs;
             for (int channel = 0; channel < PRIMARY_CHANNEL_COUNT; channel++) {
                 if ((1 << channel) & interpolationChannels) {
-                    rcStepSize[channel] = (rcCommand[channel] - rcCommandInterp[channel]) / (float)rcInterpolationStepCount;
+                    rcFrameSlope[channel] = predict ? (rcCommand[channel] - rcFrameValue[channel]) / frameDeltaUs : 0.0f;
+                    rcFrameValue[channel] = rcCommand[channel];
+                    // start from the previous output so the setpoint doesn't step, unless the ramp is already over
+                    const float predicted = rcFrameValue[channel] + rcFrameSlope[channel] * elapsedUs;
+                    rcCorrection[channel] = remaining > 0.0f ? (rcCommandInterp[channel] - predicted) / remaining : 0.0f;
                 }
             }
 
            DEBUG_SET(DEBUG_RC_INTERPOLATION, 0, lrintf(rcCommand[0]));
            DEBUG_SET(DEBUG_RC_INTERPOLATION, 1, lrintf(currentRxRefreshRate / 1000));
-        } else {
-            rcInterpolationStepCount--;
         }
 
-        // Interpolate steps of rcCommand
-        if (rcInterpolationStepCount > 0) {
+        // Follow the prediction with the correction faded out, the last step holds the prediction
+        if (rcRampLengthUs > 0) {
+            const timeDelta_t elapsedUs = constrain(cmpTimeUs(currentTimeUs, rcRampStartUs), 0, rcRampLengthUs);
+            const float remaining = 1.0f - (float)elapsedUs / rcRampLengthUs;
             for (updatedChannel = 0; updatedChannel < PRIMARY_CHANNEL_COUNT; updatedChannel++) {
                 if ((1 << updatedChannel) & interpolationChannels) {
-                    rcCommandInterp[updatedChannel] += rcStepSize[updatedChannel];
+                    const float value = rcFrameValue[updatedChannel] + rcFrameSlope[updatedChannel] * elapsedUs + rcCorrection[updatedChannel] * remaining;
+                    if (updatedChannel == THROTTLE) {
+                        rcCommandInterp[updatedChannel] = constrainf(value, PWM_RANGE_MIN, PWM_RANGE_MAX);
+                    } else {
+                        rcCommandInterp[updatedChannel] = constrainf(value, -500.0f, 500.0f);
+                    }
                     rcCommand[updatedChannel] = rcCommandInterp[updatedChannel];
                 }
             }
+            rcInterpolationStepCount = (rcRampLengthUs - elapsedUs) / constrain(targetPidLooptime, 125, targetPidLooptime);
+            if (elapsedUs == rcRampLengthUs) {
+                rcRampLengthUs = 0;
+            }
         }
     } else {
-        rcInterpolationStepCount = 0; // reset factor in case of level modes flip flopping
+        rcRampLengthUs = 0; // reset ramp in case of level modes flip flopping
+        rcInterpolationStepCount = 0;
     }
 
     DEBUG_SET(DEBUG_RC_INTERPOLATION, 2, rcInterpolationStepCount);
@@ -615,10 +710,14 @@ FAST_CODE uint8_t processRcSmoothingFilter(void)
 }
 #endif // USE_RC_SMOOTHING_FILTER
 
-FAST_CODE void processRcCommand(void)
+FAST_CODE void processRcCommand(timeUs_t currentTimeUs)
 {
     uint8_t updatedChannel;
 
+    if (isRXDataNew) {
+        updateRxFrameInterval(rxGetFrameTimeUs());
+    }
+
     if (isRXDataNew && pidAntiGravityEnabled()) {
         checkForThrottleErrorResetState(currentRxRefreshRate);
     }
@@ -631,7 +730,7 @@ FAST_CODE void processRcCommand(void)
 #endif // USE_RC_SMOOTHING_FILTER
     case RC_SMOOTHING_TYPE_INTERPOLATION:
     default:
-        updatedChannel = processRcInterpolation();
+        updatedChannel = processRcInterpolation(currentTimeUs);
         break;
     }
 
@@ -818,6 +917,7 @@ void initRcProcessing(void)
 
         break;
     }
+    buildRateLookupTables();
 
     interpolationChannels = 0;
     switch (rxConfig()->rcInterpolationChannels) {
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "common/time.h"
+
 typedef enum {
     INTERPOLATION_CHANNELS_RP,
     INTERPOLATION_CHANNELS_RPY,
@@ -31,7 +33,7 @@ typedef enum {
 extern volatile bool 		isSetpointNew;
 extern volatile uint16_t 	currentRxRefreshRate;
 
-void processRcCommand(void);
+void processRcCommand(timeUs_t currentTimeUs);
 float getSetpointRate(int axis);
 uint32_t getSetpointRateInt(int axis);
 float getRcDeflection(int axis);
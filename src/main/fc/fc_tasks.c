@@ -60,6 +60,7 @@
 #include "fc/runtime_config.h"
 
 #include "flight/position.h"
+#include "flight/failsafe.h"
 #include "flight/imu.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
@@ -82,6 +83,7 @@
 #include "io/vtx.h"
 
 #include "msp/msp_serial.h"
+#include "msp/msp_stream.h"
 
 #include "pg/rx.h"
 
@@ -205,7 +207,14 @@ static void taskUpdateRxMain(timeUs_t currentTimeUs)
 #endif
 
     // updateRcCommands sets rcCommand, which is needed by updateAltHoldState and updateSonarAltHoldState
+#ifdef USE_RX_FRAME_EVENT
+    // rcCommand is already up to date if the frame was delivered to the PID loop, unless failsafe changed rcData since
+    if (!rxFrameEventConsume() || failsafeIsActive()) {
+        updateRcCommands();
+    }
+#else
     updateRcCommands();
+#endif
     updateArmingStatus();
 }
 #endif
@@ -253,6 +262,13 @@ static void taskCameraControl(uint32_t currentTime)
 }
 #endif
 
+#ifdef USE_MSP_STREAM
+static void taskMspStream(timeUs_t currentTimeUs)
+{
+    mspStreamProcess(currentTimeUs, mspFcProcessCommand);
+}
+#endif
+
 void fcTasksInit(void)
 {
     schedulerInit();
@@ -644,5 +660,14 @@ FAST_RAM cfTask_t cfTasks[TASK_COUNT] = {
         .staticPriority = TASK_PRIORITY_IDLE
     },
 #endif
+
+#ifdef USE_MSP_STREAM
+    [TASK_MSP_STREAM] = {
+        .taskName = "MSP_STREAM",
+        .taskFunc = taskMspStream,
+        .desiredPeriod = TASK_PERIOD_HZ(MSP_STREAM_MAX_RATE_HZ),
+        .staticPriority = TASK_PRIORITY_LOW,
+    },
+#endif
 #endif
 };
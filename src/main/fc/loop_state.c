@@ -0,0 +1,111 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Per loop flight state, published once per PID loop under a sequence lock.
+ *
+ * The sequence is odd while the PID loop writes the snapshot and even once it is complete. A reader
+ * copies the snapshot and keeps the copy only if the sequence was even and unchanged across the
+ * copy, so the writer never waits for a reader and a reader never sees half of one loop and half
+ * of the next, even from an interrupt or another thread (SITL).
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "common/utils.h"
+
+#include "fc/rc_controls.h"
+
+#include "flight/mixer.h"
+
+#include "sensors/acceleration.h"
+#include "sensors/compass.h"
+#include "sensors/gyro.h"
+
+#include "loop_state.h"
+
+// a reader that keeps being overtaken by the writer gives up rather than spin, the PID loop may be
+// waiting for it to return
+#define LOOP_STATE_READ_ATTEMPTS    4
+
+typedef struct loopStateBuffer_s {
+    uint32_t sequence;
+    loopState_t state;
+} loopStateBuffer_t;
+
+static loopStateBuffer_t loopStateBuffer;
+
+// the snapshot is complete once the motors have been written, before the blackbox logs it
+FAST_CODE void loopStatePublish(timeUs_t currentTimeUs)
+{
+    loopState_t *state = &loopStateBuffer.state;
+    const uint32_t sequence = loopStateBuffer.sequence;
+
+    __atomic_store_n(&loopStateBuffer.sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    state->timeUs = currentTimeUs;
+    state->iteration = sequence / 2 + 1;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        state->gyroADCf[axis] = gyro.gyroADCf[axis];
+        state->accADC[axis] = acc.accADC[axis];
+#ifdef USE_MAG
+        state->magADC[axis] = mag.magADC[axis];
+#endif
+        state->pidData[axis] = pidData[axis];
+    }
+    state->attitude = attitude;
+    memcpy(state->rcCommand, rcCommand, sizeof(state->rcCommand));
+    state->motorCount = getMotorCount();
+    memcpy(state->motor, motor, state->motorCount * sizeof(state->motor[0]));
+    memcpy(state->debug, debug, sizeof(state->debug));
+
+    __atomic_store_n(&loopStateBuffer.sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+/*
+ * Copies the snapshot of the latest complete PID loop into state. Returns false, with state left
+ * as it was, if the PID loop kept overwriting the snapshot while it was being copied.
+ */
+bool loopStateRead(loopState_t *state)
+{
+    loopState_t copy;
+
+    for (int attempt = 0; attempt < LOOP_STATE_READ_ATTEMPTS; attempt++) {
+        const uint32_t sequence = __atomic_load_n(&loopStateBuffer.sequence, __ATOMIC_ACQUIRE);
+        if (sequence & 1) {
+            continue;
+        }
+
+        memcpy(&copy, &loopStateBuffer.state, sizeof(copy));
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&loopStateBuffer.sequence, __ATOMIC_RELAXED) == sequence) {
+            memcpy(state, &copy, sizeof(copy));
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,58 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "build/debug.h"
+
+#include "common/axis.h"
+#include "common/time.h"
+
+#include "drivers/pwm_output_counts.h"
+
+#include "flight/imu.h"
+#include "flight/pid.h"
+
+/*
+ * Snapshot of the flight state at the end of a PID loop, for everything that isn't the PID loop
+ * itself: blackbox, MSP, telemetry. All values belong to the same loop, which reading the live
+ * globals one by one doesn't guarantee.
+ */
+typedef struct loopState_s {
+    timeUs_t timeUs;                        // start of the loop
+    uint32_t iteration;                     // PID loops published since boot, tells a new snapshot from one already seen
+    float gyroADCf[XYZ_AXIS_COUNT];
+    float accADC[XYZ_AXIS_COUNT];
+#ifdef USE_MAG
+    float magADC[XYZ_AXIS_COUNT];
+#endif
+    attitudeEulerAngles_t attitude;
+    float rcCommand[4];
+    pidAxisData_t pidData[XYZ_AXIS_COUNT];
+    float motor[MAX_SUPPORTED_MOTORS];
+    int16_t debug[DEBUG16_VALUE_COUNT];
+    uint8_t motorCount;
+} loopState_t;
+
+void loopStatePublish(timeUs_t currentTimeUs);
+bool loopStateRead(loopState_t *state);
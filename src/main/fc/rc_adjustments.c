@@ -719,6 +719,7 @@ void processRcAdjustments(controlRateConfig_t *controlRateConfig)
 
             newValue = applyStepAdjustment(controlRateConfig, adjustmentFunction, delta);
             pidInitConfig(currentPidProfile);
+            initRcProcessing();
         } else if (adjustmentState->config->mode == ADJUSTMENT_MODE_SELECT) {
             int switchPositions = adjustmentState->config->data.switchPositions;
             if (adjustmentFunction == ADJUSTMENT_RATE_PROFILE && systemConfig()->rateProfile6PosSwitch) {
@@ -758,6 +759,7 @@ void processRcAdjustments(controlRateConfig_t *controlRateConfig)
             lastRcData[index] = rcData[channelIndex];
             applyAbsoluteAdjustment(controlRateConfig, adjustmentRange->adjustmentFunction, value);
             pidInitConfig(currentPidProfile);
+            initRcProcessing();
         }
     }
 }
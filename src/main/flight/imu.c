@@ -35,6 +35,10 @@
 #include "pg/pg_ids.h"
 
 #include "drivers/time.h"
+#ifdef USE_GYRO_IMUF9001
+#include "drivers/accgyro/accgyro.h"
+#include "drivers/accgyro/accgyro_imuf9001.h"
+#endif
 
 #include "fc/runtime_config.h"
 
@@ -95,7 +99,17 @@ quaternion qOffset = QUATERNION_INITIALIZE;
 // absolute angle inclination in multiple of 0.1 degree    180 deg = 1800
 attitudeEulerAngles_t attitude = EULER_INITIALIZE;
 
-PG_REGISTER_WITH_RESET_TEMPLATE(imuConfig_t, imuConfig, PG_IMU_CONFIG, 0);
+#ifdef USE_GYRO_IMUF9001
+// the IMU-F quaternion is only trusted while frames keep coming, after that Mahony takes over
+#define IMUF_QUAT_STALE_US          50000
+#define IMUF_QUAT_NORM_TOLERANCE    0.01f
+
+static uint32_t imufQuatLastSequence;
+static timeUs_t imufQuatUpdatedAtUs;
+static bool imufQuatReceived;
+#endif
+
+PG_REGISTER_WITH_RESET_TEMPLATE(imuConfig_t, imuConfig, PG_IMU_CONFIG, 1);
 
 PG_RESET_TEMPLATE(imuConfig_t, imuConfig,
     .dcm_kp = 7013,
@@ -123,6 +137,9 @@ void imuConfigure(uint16_t throttle_correction_angle)
     imuRuntimeConfig.dcm_ki = imuConfig()->dcm_ki / 10000.0f;
     imuRuntimeConfig.acc_unarmedcal = imuConfig()->acc_unarmedcal;
     imuRuntimeConfig.small_angle = imuConfig()->small_angle;
+#ifdef USE_GYRO_IMUF9001
+    imuRuntimeConfig.attitude_source = imuConfig()->attitude_source;
+#endif
 
     fc_acc = calculateAccZLowPassFilterRCTimeConstant(5.0f); // Set to fix value
     throttleAngleScale = calculateThrottleAngleScale(throttle_correction_angle);
@@ -304,10 +321,12 @@ static void imuMahonyAHRSupdate(float dt, quaternion *vGyro, quaternion *vError)
     const float vGyroModulus = quaternionModulus(vGyro);
     // reduce gyro noise integration integrate only above vGyroStdDevModulus
     if (vGyroModulus > vGyroStdDevModulus) {
-        qDiff.w = cosf(vGyroModulus * 0.5f * dt);
-        qDiff.x = sinf(vGyroModulus * 0.5f * dt) * (vGyro->x / vGyroModulus);
-        qDiff.y = sinf(vGyroModulus * 0.5f * dt) * (vGyro->y / vGyroModulus);
-        qDiff.z = sinf(vGyroModulus * 0.5f * dt) * (vGyro->z / vGyroModulus);
+        const float halfAngle = vGyroModulus * 0.5f * dt;
+        const float sinHalfAngleByModulus = sin_approx(halfAngle) / vGyroModulus;
+        qDiff.w = cos_approx(halfAngle);
+        qDiff.x = sinHalfAngleByModulus * vGyro->x;
+        qDiff.y = sinHalfAngleByModulus * vGyro->y;
+        qDiff.z = sinHalfAngleByModulus * vGyro->z;
         quaternionMultiply(&qAttitude, &qDiff, &qAttitude);
     }
 
@@ -333,6 +352,41 @@ static void imuMahonyAHRSupdate(float dt, quaternion *vGyro, quaternion *vError)
     DEBUG_SET(DEBUG_IMU, DEBUG_IMU3, lrintf(vGyroStdDevModulus * 1000));
 }
 
+#ifdef USE_GYRO_IMUF9001
+// Takes the latest IMU-F quaternion as the attitude. Returns false if there is no recent, sane
+// frame, in which case the caller runs Mahony instead.
+// The FC hands the board and sensor alignment to the IMU-F at setup (param8/param9 in
+// setupImufParams()) and skips alignSensors() for its samples, so the quaternion already is the
+// attitude of the body and is used as is.
+static bool imuUpdateAttitudeFromImuf(timeUs_t currentTimeUs)
+{
+    const uint32_t sequence = imufQuatSequence;
+    if (sequence != imufQuatLastSequence) {
+        quaternion qImuf;
+        qImuf.w = imufQuat.w;
+        qImuf.x = imufQuat.x;
+        qImuf.y = imufQuat.y;
+        qImuf.z = imufQuat.z;
+
+        // a frame arriving while copying would leave a mix of two, take it on the next tick instead
+        if (sequence == imufQuatSequence) {
+            imufQuatLastSequence = sequence;
+            const float norm = quaternionNorm(&qImuf);
+            if (norm > 1.0f - IMUF_QUAT_NORM_TOLERANCE && norm < 1.0f + IMUF_QUAT_NORM_TOLERANCE) {
+                qAttitude = qImuf;
+                quaternionComputeProducts(&qAttitude, &qpAttitude);
+                imufQuatUpdatedAtUs = currentTimeUs;
+                imufQuatReceived = true;
+                return true;
+            }
+        }
+    }
+
+    // no new frame this tick, the last one is still good until it goes stale
+    return imufQuatReceived && cmpTimeUs(currentTimeUs, imufQuatUpdatedAtUs) < IMUF_QUAT_STALE_US;
+}
+#endif
+
 STATIC_UNIT_TESTED void imuUpdateEulerAngles(void) {
     quaternionProducts buffer;
 
@@ -371,18 +425,26 @@ static void imuCalculateEstimatedAttitude(timeUs_t currentTimeUs)
 //  printf("[imu]deltaT = %u, imuDeltaT = %u, currentTimeUs = %u, micros64_real = %lu\n", deltaT, imuDeltaT, currentTimeUs, micros64_real());
     deltaT = imuDeltaT;
 #endif
-    quaternion vError = VECTOR_INITIALIZE;
     quaternion vGyroAverage;
     quaternion vAccAverage;
+    // always collect the averages so they don't build up while Mahony isn't running
     gyroGetAverage(&vGyroAverage);
     accGetAverage(&vAccAverage);
-    DEBUG_SET(DEBUG_IMU, DEBUG_IMU2, lrintf((quaternionModulus(&vAccAverage)/ acc.dev.acc_1G) * 1000));
-    if (accIsHealthy(&vAccAverage)) {
-         applyAccError(&vAccAverage, &vError);
+#ifdef USE_GYRO_IMUF9001
+    if (imuRuntimeConfig.attitude_source == IMU_ATTITUDE_SOURCE_IMUF && imuUpdateAttitudeFromImuf(currentTimeUs)) {
+        imuUpdateEulerAngles();
+    } else
+#endif
+    {
+        quaternion vError = VECTOR_INITIALIZE;
+        DEBUG_SET(DEBUG_IMU, DEBUG_IMU2, lrintf((quaternionModulus(&vAccAverage)/ acc.dev.acc_1G) * 1000));
+        if (accIsHealthy(&vAccAverage)) {
+             applyAccError(&vAccAverage, &vError);
+        }
+        applySensorCorrection(&vError);
+        imuMahonyAHRSupdate(deltaT * 1e-6f, &vGyroAverage, &vError);
+        imuUpdateEulerAngles();
     }
-    applySensorCorrection(&vError);
-    imuMahonyAHRSupdate(deltaT * 1e-6f, &vGyroAverage, &vError);
-    imuUpdateEulerAngles();
 #endif
 
 #if defined(USE_ALT_HOLD)
@@ -56,12 +56,20 @@ typedef struct accDeadband_s {
     uint8_t z;                  // set the acc deadband for z-Axis, this ignores small accelerations
 } accDeadband_t;
 
+typedef enum {
+    IMU_ATTITUDE_SOURCE_FC = 0,             // Mahony AHRS on the flight controller
+    IMU_ATTITUDE_SOURCE_IMUF,               // quaternion streamed by the IMU-F, Mahony when it stops
+} imuAttitudeSource_e;
+
 typedef struct imuConfig_s {
     uint16_t dcm_kp;                        // DCM filter proportional gain ( x 10000)
     uint16_t dcm_ki;                        // DCM filter integral gain ( x 10000)
     uint8_t small_angle;
     uint8_t acc_unarmedcal;                 // turn automatic acc compensation on/off
     accDeadband_t accDeadband;
+#ifdef USE_GYRO_IMUF9001
+    uint8_t attitude_source;                // see imuAttitudeSource_e
+#endif
 } imuConfig_t;
 
 PG_DECLARE(imuConfig_t, imuConfig);
@@ -72,6 +80,9 @@ typedef struct imuRuntimeConfig_s {
     uint8_t acc_unarmedcal;
     uint8_t small_angle;
     accDeadband_t accDeadband;
+#ifdef USE_GYRO_IMUF9001
+    uint8_t attitude_source;
+#endif
 } imuRuntimeConfig_t;
 
 enum {
@@ -75,7 +75,7 @@ PG_RESET_TEMPLATE(mixerConfig_t, mixerConfig,
     .crashflip_motor_percent = 0,
 );
 
-PG_REGISTER_WITH_RESET_FN(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 1);
+PG_REGISTER_WITH_RESET_FN(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 2);
 
 void pgResetFn_motorConfig(motorConfig_t *motorConfig)
 {
@@ -126,6 +126,20 @@ float motor_disarmed[MAX_SUPPORTED_MOTORS];
 mixerMode_e currentMixerMode;
 static motorMixer_t currentMixer[MAX_SUPPORTED_MOTORS];
 
+// The mix per term rather than per motor, plus the parts of the output stage that only depend on
+// the configuration. Rebuilt by mixerInitPlan() when either changes, so mixTable() doesn't have to
+// work them out for every motor on every loop.
+typedef struct mixerPlan_s {
+    float throttle[MAX_SUPPORTED_MOTORS];
+    float roll[MAX_SUPPORTED_MOTORS];       // roll, pitch and yaw include the 1 / PID_MIXER_SCALING
+    float pitch[MAX_SUPPORTED_MOTORS];
+    float yaw[MAX_SUPPORTED_MOTORS];        // yaw also includes the yaw_motors_reversed direction
+    bool tricopter;
+    bool motorStop;                         // motor_stop feature and not 3D
+} mixerPlan_t;
+
+static FAST_RAM_ZERO_INIT mixerPlan_t mixerPlan;
+
 static FAST_RAM_ZERO_INIT int throttleAngleCorrection;
 
 
@@ -448,6 +462,7 @@ void mixerConfigureOutput(void)
         }
     }
     mixerResetDisarmedMotors();
+    mixerInitPlan();
 }
 
 void mixerLoadMix(int index, motorMixer_t *customMixers)
@@ -473,9 +488,24 @@ void mixerConfigureOutput(void)
         currentMixer[i] = mixerQuadX[i];
     }
     mixerResetDisarmedMotors();
+    mixerInitPlan();
 }
 #endif // USE_QUAD_MIXER_ONLY
 
+void mixerInitPlan(void)
+{
+    const float yawDirection = mixerConfig()->yaw_motors_reversed ? 1.0f : -1.0f;
+
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+        mixerPlan.throttle[i] = currentMixer[i].throttle;
+        mixerPlan.roll[i] = currentMixer[i].roll / PID_MIXER_SCALING;
+        mixerPlan.pitch[i] = currentMixer[i].pitch / PID_MIXER_SCALING;
+        mixerPlan.yaw[i] = yawDirection * currentMixer[i].yaw / PID_MIXER_SCALING;
+    }
+    mixerPlan.tricopter = mixerIsTricopter();
+    mixerPlan.motorStop = feature(FEATURE_MOTOR_STOP) && !feature(FEATURE_3D);
+}
+
 void mixerResetDisarmedMotors(void)
 {
     // set disarmed motor values
@@ -700,39 +730,49 @@ static void applyFlipOverAfterCrashModeToMotors(void)
     }
 }
 
-static void applyMixToMotors(float motorMix[MAX_SUPPORTED_MOTORS])
+// mixScale takes a motor mix to output units, including the direction and the normalisation of the mix range
+static void applyMixToMotors(const float motorMix[MAX_SUPPORTED_MOTORS], float mixScale)
 {
-    // Now add in the desired throttle, but keep in a range that doesn't clip adjusted
-    // roll/pitch/yaw. This could move throttle down, but also up for those low throttle flips.
-    for (int i = 0; i < motorCount; i++) {
-        float motorOutput = motorOutputMin + (motorOutputRange * (motorOutputMixSign * motorMix[i] + throttle * currentMixer[i].throttle));
-        if (mixerIsTricopter()) {
-            motorOutput += mixerTricopterMotorCorrection(i);
-        }
-        if (failsafeIsActive()) {
-            if (isMotorProtocolDshot()) {
-                motorOutput = (motorOutput < motorRangeMin) ? disarmMotorOutput : motorOutput; // Prevent getting into special reserved range
-            }
-            motorOutput = constrain(motorOutput, disarmMotorOutput, motorRangeMax);
-        } else {
-            motorOutput = constrain(motorOutput, motorRangeMin, motorRangeMax);
+    // Disarmed mode
+    if (!ARMING_FLAG(ARMED)) {
+        for (int i = 0; i < motorCount; i++) {
+            motor[i] = motor_disarmed[i];
         }
-        // Motor stop handling
-        if (feature(FEATURE_MOTOR_STOP) && ARMING_FLAG(ARMED) && !feature(FEATURE_3D) && !isAirmodeActive()
-            && !FLIGHT_MODE(GPS_RESCUE_MODE)) {   // disable motor_stop while GPS Rescue is active
+        return;
+    }
 
-            if (((rcData[THROTTLE]) < rxConfig()->mincheck)) {
-                motorOutput = disarmMotorOutput;
-            }
+    // Motor stop handling
+    if (mixerPlan.motorStop && rcData[THROTTLE] < rxConfig()->mincheck && !isAirmodeActive()
+        && !FLIGHT_MODE(GPS_RESCUE_MODE)) {   // disable motor_stop while GPS Rescue is active
+        for (int i = 0; i < motorCount; i++) {
+            motor[i] = disarmMotorOutput;
         }
-        motor[i] = motorOutput;
+        return;
     }
 
-    // Disarmed mode
-    if (!ARMING_FLAG(ARMED)) {
+    // Now add in the desired throttle, but keep in a range that doesn't clip adjusted
+    // roll/pitch/yaw. This could move throttle down, but also up for those low throttle flips.
+    const float throttleOutput = motorOutputRange * throttle;
+    const bool failsafeActive = failsafeIsActive();
+    if (!mixerPlan.tricopter && !failsafeActive) {
         for (int i = 0; i < motorCount; i++) {
-            motor[i] = motor_disarmed[i];
+            const float motorOutput = motorOutputMin + mixScale * motorMix[i] + throttleOutput * mixerPlan.throttle[i];
+            motor[i] = constrain(motorOutput, motorRangeMin, motorRangeMax);
+        }
+        return;
+    }
+
+    const bool failsafeDshot = failsafeActive && isMotorProtocolDshot();
+    const float motorOutputLimitLow = failsafeActive ? disarmMotorOutput : motorRangeMin;
+    for (int i = 0; i < motorCount; i++) {
+        float motorOutput = motorOutputMin + mixScale * motorMix[i] + throttleOutput * mixerPlan.throttle[i];
+        if (mixerPlan.tricopter) {
+            motorOutput += mixerTricopterMotorCorrection(i);
+        }
+        if (failsafeDshot) {
+            motorOutput = (motorOutput < motorRangeMin) ? disarmMotorOutput : motorOutput; // Prevent getting into special reserved range
         }
+        motor[i] = constrain(motorOutput, motorOutputLimitLow, motorRangeMax);
     }
 }
 
@@ -761,21 +801,15 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensa
     // Find min and max throttle based on conditions. Throttle has to be known before mixing
     calculateThrottleAndCurrentMotorEndpoints(currentTimeUs);
 
-    // Calculate and Limit the PIDsum
-    const float scaledAxisPidRoll =
-        constrainf(pidData[FD_ROLL].Sum, -currentPidProfile->pidSumLimit, currentPidProfile->pidSumLimit) / PID_MIXER_SCALING;
-    const float scaledAxisPidPitch =
-        constrainf(pidData[FD_PITCH].Sum, -currentPidProfile->pidSumLimit, currentPidProfile->pidSumLimit) / PID_MIXER_SCALING;
-
-    float scaledAxisPidYaw =
-        constrainf(pidData[FD_YAW].Sum, -currentPidProfile->pidSumLimit, currentPidProfile->pidSumLimit) / PID_MIXER_SCALING;
-    if (!mixerConfig()->yaw_motors_reversed) {
-        scaledAxisPidYaw = -scaledAxisPidYaw;
-    }
-
     // Calculate voltage compensation
     const float vbatCompensationFactor = vbatPidCompensation ? calculateVbatPidCompensation() : 1.0f;
 
+    // Limit the PIDsum, the scaling and the yaw direction are in the mixer plan
+    const float pidSumLimit = currentPidProfile->pidSumLimit;
+    const float axisPidRoll = constrainf(pidData[FD_ROLL].Sum, -pidSumLimit, pidSumLimit) * vbatCompensationFactor;
+    const float axisPidPitch = constrainf(pidData[FD_PITCH].Sum, -pidSumLimit, pidSumLimit) * vbatCompensationFactor;
+    const float axisPidYaw = constrainf(pidData[FD_YAW].Sum, -pidSumLimit, pidSumLimit) * vbatCompensationFactor;
+
     // Apply the throttle_limit_percent to scale or limit the throttle based on throttle_limit_type
     if (currentControlRateProfile->throttle_limit_type != THROTTLE_LIMIT_TYPE_OFF) {
         throttle = applyThrottleLimit(throttle);
@@ -793,18 +827,13 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensa
     float motorMix[MAX_SUPPORTED_MOTORS];
     float motorMixMax = 0, motorMixMin = 0;
     for (int i = 0; i < motorCount; i++) {
-        float mix =
-            scaledAxisPidRoll  * currentMixer[i].roll +
-            scaledAxisPidPitch * currentMixer[i].pitch +
-            scaledAxisPidYaw   * currentMixer[i].yaw;
-
-        mix *= vbatCompensationFactor;  // Add voltage compensation
+        const float mix =
+            axisPidRoll  * mixerPlan.roll[i] +
+            axisPidPitch * mixerPlan.pitch[i] +
+            axisPidYaw   * mixerPlan.yaw[i];
 
-        if (mix > motorMixMax) {
-            motorMixMax = mix;
-        } else if (mix < motorMixMin) {
-            motorMixMin = mix;
-        }
+        motorMixMax = MAX(motorMixMax, mix);
+        motorMixMin = MIN(motorMixMin, mix);
         motorMix[i] = mix;
     }
 
@@ -825,11 +854,11 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensa
     }
 #endif
 
+    float mixScale = motorOutputRange * motorOutputMixSign;
     motorMixRange = motorMixMax - motorMixMin;
     if (motorMixRange > 1.0f) {
-        for (int i = 0; i < motorCount; i++) {
-            motorMix[i] /= motorMixRange;
-        }
+        // normalise the mix into the available range, applied along with the output scaling
+        mixScale /= motorMixRange;
         // Get the maximum correction by setting offset to center when airmode enabled
         if (isAirmodeActive()) {
             throttle = 0.5f;
@@ -841,7 +870,7 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensa
     }
 
     // Apply the mix to motor endpoints
-    applyMixToMotors(motorMix);
+    applyMixToMotors(motorMix, mixScale);
 }
 
 float convertExternalToMotor(uint16_t externalValue)
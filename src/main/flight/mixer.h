@@ -123,6 +123,7 @@ void mixerLoadMix(int index, motorMixer_t *customMixers);
 void mixerInit(mixerMode_e mixerMode);
 
 void mixerConfigureOutput(void);
+void mixerInitPlan(void);
 
 void mixerResetDisarmedMotors(void);
 void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensation);
@@ -352,14 +352,27 @@ void pidUpdateSetpointDerivativeLpf(uint16_t filterCutoff)
 }
 #endif // USE_RC_SMOOTHING_FILTER
 
+// gains kept per term rather than per axis, so the controllers can walk all axes of one term at a time
 typedef struct pidCoefficient_s {
-    float Kp;
-    float Ki;
-    float Kd;
-    float Kf;
+    float Kp[XYZ_AXIS_COUNT];
+    float Ki[XYZ_AXIS_COUNT];
+    float Kd[XYZ_AXIS_COUNT];
+    float Kf[XYZ_AXIS_COUNT];
 } pidCoefficient_t;
 
-static FAST_RAM_ZERO_INIT pidCoefficient_t pidCoefficient[XYZ_AXIS_COUNT];
+// everything the controllers need that is the same for all axes, worked out once per PID loop
+typedef struct pidLoopState_s {
+    float dynCi;
+    float kpAttenuation;
+    float kiAttenuation;
+    float kdAttenuation;
+    bool outputSaturated[XYZ_AXIS_COUNT];
+} pidLoopState_t;
+
+typedef void (*pidControllerFn)(const pidProfile_t *pidProfile, const pidLoopState_t *loopState,
+    const float errorRate[XYZ_AXIS_COUNT], const float currentPidSetpoint[XYZ_AXIS_COUNT], float dDelta[XYZ_AXIS_COUNT]);
+
+static FAST_RAM_ZERO_INIT pidCoefficient_t pidCoefficient;
 static FAST_RAM_ZERO_INIT float maxVelocity[XYZ_AXIS_COUNT];
 static FAST_RAM_ZERO_INIT float feedForwardTransition;
 static FAST_RAM_ZERO_INIT pidControllerFn activePidController;
@@ -401,8 +414,10 @@ void pidResetITerm(void)
     }
 }
 
-float butteredPids(const pidProfile_t *pidProfile, int axis, float errorRate, float dynCi, float iDT, float currentPidSetpoint);
-float classicPids(const pidProfile_t *pidProfile, int axis, float errorRate, float dynCi, float iDT, float currentPidSetpoint);
+static void butteredPids(const pidProfile_t *pidProfile, const pidLoopState_t *loopState,
+    const float errorRate[XYZ_AXIS_COUNT], const float currentPidSetpoint[XYZ_AXIS_COUNT], float dDelta[XYZ_AXIS_COUNT]);
+static void classicPids(const pidProfile_t *pidProfile, const pidLoopState_t *loopState,
+    const float errorRate[XYZ_AXIS_COUNT], const float currentPidSetpoint[XYZ_AXIS_COUNT], float dDelta[XYZ_AXIS_COUNT]);
 
 #ifdef USE_ACRO_TRAINER
 static FAST_RAM_ZERO_INIT float acroTrainerAngleLimit;
@@ -428,10 +443,10 @@ void pidInitConfig(const pidProfile_t *pidProfile)
         feedForwardTransition = 100.0f / pidProfile->feedForwardTransition;
     }
     for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-        pidCoefficient[axis].Kp = PTERM_SCALE * pidProfile->pid[axis].P;
-        pidCoefficient[axis].Ki = ITERM_SCALE * pidProfile->pid[axis].I;
-        pidCoefficient[axis].Kd = DTERM_SCALE * pidProfile->pid[axis].D;
-        pidCoefficient[axis].Kf = FEEDFORWARD_SCALE * (pidProfile->pid[axis].F / 100.0f);
+        pidCoefficient.Kp[axis] = PTERM_SCALE * pidProfile->pid[axis].P;
+        pidCoefficient.Ki[axis] = ITERM_SCALE * pidProfile->pid[axis].I;
+        pidCoefficient.Kd[axis] = DTERM_SCALE * pidProfile->pid[axis].D;
+        pidCoefficient.Kf[axis] = FEEDFORWARD_SCALE * (pidProfile->pid[axis].F / 100.0f);
     }
 
     levelGain = pidProfile->pid[PID_LEVEL].P / 10.0f;
@@ -838,206 +853,171 @@ void FAST_CODE applySmartFeedforward(int axis)
 
 static FAST_RAM_ZERO_INIT float previousRateError[3];
 static FAST_RAM_ZERO_INIT timeUs_t crashDetectedAtUs;
-//static FAST_RAM_ZERO_INIT timeUs_t previousTimeUs;
 
 #define SIGN(x) ((x > 0.0f) - (x < 0.0f))
 
-// Butterflight pid controller which uses measurement instead of error rate to calculate D
-FAST_CODE float butteredPids(const pidProfile_t *pidProfile, int axis, float errorRate, float dynCi, float iDT, float currentPidSetpoint)
+// don't let a change of sign undo more of the accumulated I than i_decay allows
+static FAST_CODE float applyItermDecay(float iterm, float itermNew, float iDecay)
 {
-    (void) iDT;
-    (void)(currentPidSetpoint);
-    // -----calculate P component
-    pidData[axis].P = (pidCoefficient[axis].Kp * errorRate);
-
-    // -----calculate I component
-    //float iterm = constrainf(pidData[axis].I + (pidCoefficient[axis].Ki * errorRate) * dynCi, -itermLimit, itermLimit);
-    float iterm    = pidData[axis].I;
-    float ITermNew = pidCoefficient[axis].Ki * errorRate * dynCi;
-    if (ITermNew != 0.0f)
-    {
-        if (SIGN(iterm) != SIGN(ITermNew))
-        {
-        	const float newVal = ITermNew * (float)pidProfile->i_decay;
-        	if (fabs(iterm) > fabs(newVal))
-        	{
-        		ITermNew = newVal;
-        	}
+    if (itermNew != 0.0f && SIGN(iterm) != SIGN(itermNew)) {
+        const float newVal = itermNew * iDecay;
+        if (fabsf(iterm) > fabsf(newVal)) {
+            return newVal;
         }
     }
+    return itermNew;
+}
 
-    iterm = constrainf(iterm + ITermNew, -itermLimit, itermLimit);
-    if (!mixerIsOutputSaturated(axis, errorRate) || ABS(iterm) < ABS(pidData[axis].I)) {
-        // Only increase ITerm if output is not saturated
-        pidData[axis].I = iterm;
-    }
+// Butterflight pid controller which uses measurement instead of error rate to calculate D
+static FAST_CODE void butteredPids(const pidProfile_t *pidProfile, const pidLoopState_t *loopState,
+    const float errorRate[XYZ_AXIS_COUNT], const float currentPidSetpoint[XYZ_AXIS_COUNT], float dDelta[XYZ_AXIS_COUNT])
+{
+    UNUSED(currentPidSetpoint);
+    const float iDecay = (float)pidProfile->i_decay;
+    const filterApplyFnPtr lowpassApplyFn = dtermLowpassApplyFn;
 
-    // use measurement and apply filters. mmmm gimme that butter.
-    float dDelta = dtermLowpassApplyFn((filter_t *) &dtermLowpass[axis], -((gyro.gyroADCf[axis] - previousRateError[axis]) * pidFrequency));
-    previousRateError[axis] = gyro.gyroADCf[axis];
-    pidData[axis].D = (pidCoefficient[axis].Kd * dDelta);
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        const float gyroRate = gyro.gyroADCf[axis];
 
-#if defined(USE_TPA_CURVES)
-    pidData[axis].P = pidData[axis].P * getThrottlePIDAttenuationKp();
-    pidData[axis].I = pidData[axis].I * getThrottlePIDAttenuationKi();
-    pidData[axis].D = pidData[axis].D * getThrottlePIDAttenuationKd();
-#else
-    pidData[axis].P = pidData[axis].P * getThrottlePIDAttenuation();
-    pidData[axis].D = pidData[axis].D * getThrottlePIDAttenuation();
-#endif
-    return dDelta;
+        // -----calculate P component
+        pidData[axis].P = (pidCoefficient.Kp[axis] * errorRate[axis]) * loopState->kpAttenuation;
+
+        // -----calculate I component
+        const float ITerm = pidData[axis].I;
+        const float ITermNew = constrainf(ITerm + applyItermDecay(ITerm, pidCoefficient.Ki[axis] * errorRate[axis] * loopState->dynCi, iDecay), -itermLimit, itermLimit);
+        if (!loopState->outputSaturated[axis] || ABS(ITermNew) < ABS(ITerm)) {
+            // Only increase ITerm if output is not saturated
+            pidData[axis].I = ITermNew;
+        }
+        pidData[axis].I = pidData[axis].I * loopState->kiAttenuation;
+
+        // use measurement and apply filters. mmmm gimme that butter.
+        dDelta[axis] = lowpassApplyFn((filter_t *) &dtermLowpass[axis], -((gyroRate - previousRateError[axis]) * pidFrequency));
+        previousRateError[axis] = gyroRate;
+        pidData[axis].D = (pidCoefficient.Kd[axis] * dDelta[axis]) * loopState->kdAttenuation;
+    }
 }
 
 // Betaflight pid controller, which will be maintained in the future with additional features specialised for current (mini) multirotor usage.
 // Based on 2DOF reference design (matlab)
-
-FAST_CODE float classicPids(const pidProfile_t* pidProfile, int axis, float errorRate, float dynCi, float iDT, float currentPidSetpoint)
+static FAST_CODE void classicPids(const pidProfile_t *pidProfile, const pidLoopState_t *loopState,
+    const float errorRate[XYZ_AXIS_COUNT], const float currentPidSetpoint[XYZ_AXIS_COUNT], float dDelta[XYZ_AXIS_COUNT])
 {
-    UNUSED(iDT);
-    UNUSED(currentPidSetpoint);
-    float gyroRateDterm[XYZ_AXIS_COUNT];
     static float previousGyroRateDterm[XYZ_AXIS_COUNT];
+    const float iDecay = (float)pidProfile->i_decay;
+    const filterApplyFnPtr notchApplyFn = dtermNotchApplyFn;
+    const filterApplyFnPtr lowpassApplyFn = dtermLowpassApplyFn;
+#if defined(USE_ABSOLUTE_CONTROL)
+    const bool acActive = acGain > 0 && isAirmodeActivated();
+#endif
+#ifndef USE_ITERM_RELAX
+    UNUSED(currentPidSetpoint);
+#endif
 
     rotateITermAndAxisError();
+
     // --------low-level gyro-based PID based on 2DOF PID controller. ----------
     // 2-DOF PID controller with optional filter on derivative term.
     // b = 1 and only c (feedforward weight) can be tuned (amount derivative on measurement or error).
-
-#ifdef USE_ABSOLUTE_CONTROL
-    float acCorrection = 0;
-    float acErrorRate;
-#endif
-
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
         const float gyroRate = gyro.gyroADCf[axis];
-        float ITerm = pidData[axis].I;
-        float itermErrorRate = errorRate;
+        const float ITerm = pidData[axis].I;
+        float itermErrorRate = errorRate[axis];
+#if defined(USE_ABSOLUTE_CONTROL)
+        float acErrorRate;
+#endif
 
 #if defined(USE_ITERM_RELAX)
-    if (itermRelax && (axis < FD_YAW || itermRelax == ITERM_RELAX_RPY || itermRelax == ITERM_RELAX_RPY_INC)) {
-        const float setpointLpf = pt1FilterApply(&windupLpf[axis], currentPidSetpoint);
-        const float setpointHpf = fabsf(currentPidSetpoint - setpointLpf);
-        const float itermRelaxFactor = 1 - setpointHpf / ITERM_RELAX_SETPOINT_THRESHOLD;
-
-        const bool isDecreasingI = ((ITerm > 0) && (itermErrorRate < 0)) || ((ITerm < 0) && (itermErrorRate > 0));
-        if ((itermRelax >= ITERM_RELAX_RP_INC) && isDecreasingI) {
-            // Do Nothing, use the precalculed itermErrorRate
-        } else if (itermRelaxType == ITERM_RELAX_SETPOINT && setpointHpf < ITERM_RELAX_SETPOINT_THRESHOLD) {
-            itermErrorRate *= itermRelaxFactor;
-        } else if (itermRelaxType == ITERM_RELAX_GYRO ) {
-            itermErrorRate = fapplyDeadband(setpointLpf - gyroRate, setpointHpf);
-        } else {
-            itermErrorRate = 0.0f;
-        }
+        if (itermRelax && (axis < FD_YAW || itermRelax == ITERM_RELAX_RPY || itermRelax == ITERM_RELAX_RPY_INC)) {
+            const float setpointLpf = pt1FilterApply(&windupLpf[axis], currentPidSetpoint[axis]);
+            const float setpointHpf = fabsf(currentPidSetpoint[axis] - setpointLpf);
+            const float itermRelaxFactor = 1 - setpointHpf / ITERM_RELAX_SETPOINT_THRESHOLD;
+
+            const bool isDecreasingI = ((ITerm > 0) && (itermErrorRate < 0)) || ((ITerm < 0) && (itermErrorRate > 0));
+            if ((itermRelax >= ITERM_RELAX_RP_INC) && isDecreasingI) {
+                // Do Nothing, use the precalculed itermErrorRate
+            } else if (itermRelaxType == ITERM_RELAX_SETPOINT && setpointHpf < ITERM_RELAX_SETPOINT_THRESHOLD) {
+                itermErrorRate *= itermRelaxFactor;
+            } else if (itermRelaxType == ITERM_RELAX_GYRO ) {
+                itermErrorRate = fapplyDeadband(setpointLpf - gyroRate, setpointHpf);
+            } else {
+                itermErrorRate = 0.0f;
+            }
 
-        if (axis == FD_ROLL) {
-            DEBUG_SET(DEBUG_ITERM_RELAX, 0, lrintf(setpointHpf));
-            DEBUG_SET(DEBUG_ITERM_RELAX, 1, lrintf(itermRelaxFactor * 100.0f));
-            DEBUG_SET(DEBUG_ITERM_RELAX, 2, lrintf(itermErrorRate));
-        }
+            if (axis == FD_ROLL) {
+                DEBUG_SET(DEBUG_ITERM_RELAX, 0, lrintf(setpointHpf));
+                DEBUG_SET(DEBUG_ITERM_RELAX, 1, lrintf(itermRelaxFactor * 100.0f));
+                DEBUG_SET(DEBUG_ITERM_RELAX, 2, lrintf(itermErrorRate));
+            }
 
 #if defined(USE_ABSOLUTE_CONTROL)
-        const float gmaxac = setpointLpf + 2 * setpointHpf;
-        const float gminac = setpointLpf - 2 * setpointHpf;
-        if (gyroRate >= gminac && gyroRate <= gmaxac) {
-            float acErrorRate1 = gmaxac - gyroRate;
-            float acErrorRate2 = gminac - gyroRate;
-            if (acErrorRate1 * axisError[axis] < 0) {
-                acErrorRate = acErrorRate1;
+            const float gmaxac = setpointLpf + 2 * setpointHpf;
+            const float gminac = setpointLpf - 2 * setpointHpf;
+            if (gyroRate >= gminac && gyroRate <= gmaxac) {
+                float acErrorRate1 = gmaxac - gyroRate;
+                float acErrorRate2 = gminac - gyroRate;
+                if (acErrorRate1 * axisError[axis] < 0) {
+                    acErrorRate = acErrorRate1;
+                } else {
+                    acErrorRate = acErrorRate2;
+                }
+                if (fabsf(acErrorRate * dT) > fabsf(axisError[axis]) ) {
+                    acErrorRate = -axisError[axis] / dT;
+                }
             } else {
-                acErrorRate = acErrorRate2;
-            }
-            if (fabsf(acErrorRate * dT) > fabsf(axisError[axis]) ) {
-                acErrorRate = -axisError[axis] / dT;
+                acErrorRate = (gyroRate > gmaxac ? gmaxac : gminac ) - gyroRate;
             }
-        } else {
-            acErrorRate = (gyroRate > gmaxac ? gmaxac : gminac ) - gyroRate;
-        }
 #endif // USE_ABSOLUTE_CONTROL
-    } else
+        } else
 #endif // USE_ITERM_RELAX
-    {
+        {
 #if defined(USE_ABSOLUTE_CONTROL)
-        acErrorRate = itermErrorRate;
+            acErrorRate = itermErrorRate;
 #endif // USE_ABSOLUTE_CONTROL
-    }
+        }
 
 #if defined(USE_ABSOLUTE_CONTROL)
-    if (acGain > 0 && isAirmodeActivated()) {
-        axisError[axis] = constrainf(axisError[axis] + acErrorRate * dT, -acErrorLimit, acErrorLimit);
-        acCorrection = constrainf(axisError[axis] * acGain, -acLimit, acLimit);
-        currentPidSetpoint += acCorrection;
-        itermErrorRate += acCorrection;
-        if (axis == FD_ROLL) {
-            DEBUG_SET(DEBUG_ITERM_RELAX, 3, lrintf(axisError[axis] * 10));
+        if (acActive) {
+            axisError[axis] = constrainf(axisError[axis] + acErrorRate * dT, -acErrorLimit, acErrorLimit);
+            itermErrorRate += constrainf(axisError[axis] * acGain, -acLimit, acLimit);
+            if (axis == FD_ROLL) {
+                DEBUG_SET(DEBUG_ITERM_RELAX, 3, lrintf(axisError[axis] * 10));
+            }
         }
-    }
 #endif
 
         // -----calculate P component and add Dynamic Part based on stick input
-#ifdef USE_TPA_CURVES
-    pidData[axis].P = (pidCoefficient[axis].Kp * errorRate) * getThrottlePIDAttenuationKp();
-#else
-    pidData[axis].P = (pidCoefficient[axis].Kp * errorRate) * getThrottlePIDAttenuation();
-#endif
-    // -----calculate I component
-   // const float ITermNew = constrainf(ITerm + pidCoefficient[axis].Ki * itermErrorRate * dynCi, -itermLimit, itermLimit);
-    float ITermNew = pidCoefficient[axis].Ki * itermErrorRate * dynCi;
-    if (ITermNew != 0.0f)
-    {
-        if (SIGN(ITerm) != SIGN(ITermNew))
-        {
-        	const float newVal = ITermNew * (float)pidProfile->i_decay;
-        	if (fabs(ITerm) > fabs(newVal))
-        	{
-        		ITermNew = newVal;
-        	}
-        }
-    }
-    ITermNew = constrainf(ITerm + ITermNew, -itermLimit, itermLimit);
-
-    const bool outputSaturated = mixerIsOutputSaturated(axis, errorRate);
-    if (outputSaturated == false || ABS(ITermNew) < ABS(ITerm)) {
-        // Only increase ITerm if output is not saturated
-#ifdef USE_TPA_CURVES
-        pidData[axis].I = ITermNew * getThrottlePIDAttenuationKi();
-#else
-        pidData[axis].I = ITermNew;
-#endif
-    }
+        pidData[axis].P = (pidCoefficient.Kp[axis] * errorRate[axis]) * loopState->kpAttenuation;
 
-    // -----calculate D component
-    gyroRateDterm[axis] = dtermNotchApplyFn((filter_t *) &dtermNotch[axis], gyroRate);
-    gyroRateDterm[axis] = dtermLowpassApplyFn((filter_t *) &dtermLowpass[axis], gyroRateDterm[axis]);
-    const float delta = - (gyroRateDterm[axis] - previousGyroRateDterm[axis]) * pidFrequency;
-    if (pidCoefficient[axis].Kd > 0) {
-
-        // Divide rate change by dT to get differential (ie dr/dt).
-        // dT is fixed and calculated from the target PID loop time
-        // This is done to avoid DTerm spikes that occur with dynamically
-        // calculated deltaT whenever another task causes the PID
-        // loop execution to be delayed.
+        // -----calculate I component
+        const float ITermNew = constrainf(ITerm + applyItermDecay(ITerm, pidCoefficient.Ki[axis] * itermErrorRate * loopState->dynCi, iDecay), -itermLimit, itermLimit);
+        if (!loopState->outputSaturated[axis] || ABS(ITermNew) < ABS(ITerm)) {
+            // Only increase ITerm if output is not saturated
+            pidData[axis].I = ITermNew * loopState->kiAttenuation;
+        }
 
-#ifdef USE_TPA_CURVES
-        pidData[axis].D = pidCoefficient[axis].Kd * delta * getThrottlePIDAttenuationKd();
-#else
-        pidData[axis].D = pidCoefficient[axis].Kd * delta * getThrottlePIDAttenuation();
-#endif
-    } else {
-        pidData[axis].D = 0;
+        // -----calculate D component
+        const float gyroRateDterm = lowpassApplyFn((filter_t *) &dtermLowpass[axis], notchApplyFn((filter_t *) &dtermNotch[axis], gyroRate));
+        dDelta[axis] = - (gyroRateDterm - previousGyroRateDterm[axis]) * pidFrequency;
+        previousGyroRateDterm[axis] = gyroRateDterm;
+        if (pidCoefficient.Kd[axis] > 0) {
+
+            // Divide rate change by dT to get differential (ie dr/dt).
+            // dT is fixed and calculated from the target PID loop time
+            // This is done to avoid DTerm spikes that occur with dynamically
+            // calculated deltaT whenever another task causes the PID
+            // loop execution to be delayed.
+            pidData[axis].D = pidCoefficient.Kd[axis] * dDelta[axis] * loopState->kdAttenuation;
+        } else {
+            pidData[axis].D = 0;
+        }
     }
-    previousGyroRateDterm[axis] = gyroRateDterm[axis];
-    return delta;
 }
 
 void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *angleTrim, timeUs_t currentTimeUs)
 {
     static float previousPidSetpoint[XYZ_AXIS_COUNT];
 
-//    const float deltaT = (currentTimeUs - previousTimeUs) * 0.000001f;
-//    previousTimeUs = currentTimeUs;
-    // calculate actual deltaT in seconds
-//    const float iDT = 1.0f/deltaT; //divide once
-    // calculate actual deltaT in seconds
     // Dynamic i component,
     if ((antiGravityMode == ANTI_GRAVITY_SMOOTH) && antiGravityEnabled) {
         itermAccelerator = 1 + fabsf(antiGravityThrottleHpf) * 0.01f * (itermAcceleratorGain - 1000);
@@ -1045,27 +1025,38 @@ void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *an
     }
     DEBUG_SET(DEBUG_ANTI_GRAVITY, 0, lrintf(itermAccelerator * 1000));
 
-
+    pidLoopState_t loopState;
     // gradually scale back integration when above windup point
-    const float dynCi = constrainf((1.0f - getMotorMixRange()) * ITermWindupPointInv, 0.0f, 1.0f)
+    loopState.dynCi = constrainf((1.0f - getMotorMixRange()) * ITermWindupPointInv, 0.0f, 1.0f)
         * dT * itermAccelerator;
-    float errorRate;
-    float currentPidSetpoint;
+#ifdef USE_TPA_CURVES
+    loopState.kpAttenuation = getThrottlePIDAttenuationKp();
+    loopState.kiAttenuation = getThrottlePIDAttenuationKi();
+    loopState.kdAttenuation = getThrottlePIDAttenuationKd();
+#else
+    loopState.kpAttenuation = getThrottlePIDAttenuation();
+    loopState.kiAttenuation = 1.0f;
+    loopState.kdAttenuation = loopState.kpAttenuation;
+#endif
+
+    float currentPidSetpoint[XYZ_AXIS_COUNT];
+    float errorRate[XYZ_AXIS_COUNT];
+    float dDelta[XYZ_AXIS_COUNT];
 
-    // ----------PID controller----------
+    // ----------setpoints and error rates----------
     for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-        currentPidSetpoint = getSetpointRate(axis);
+        float setpoint = getSetpointRate(axis);
         if (maxVelocity[axis]) {
-            currentPidSetpoint = accelerationLimit(axis, currentPidSetpoint);
+            setpoint = accelerationLimit(axis, setpoint);
         }
         // Yaw control is GYRO based, direct sticks control is applied to rate PID
         if ((FLIGHT_MODE(ANGLE_MODE) || FLIGHT_MODE(HORIZON_MODE) || FLIGHT_MODE(GPS_RESCUE_MODE)) && axis != FD_YAW) {
-            currentPidSetpoint = pidLevel(axis, pidProfile, angleTrim, currentPidSetpoint);
+            setpoint = pidLevel(axis, pidProfile, angleTrim, setpoint);
         }
 
 #ifdef USE_ACRO_TRAINER
         if ((axis != FD_YAW) && acroTrainerActive && !inCrashRecoveryMode) {
-            currentPidSetpoint = applyAcroTrainer(axis, angleTrim, currentPidSetpoint);
+            setpoint = applyAcroTrainer(axis, angleTrim, setpoint);
         }
 #endif // USE_ACRO_TRAINER
 
@@ -1073,32 +1064,37 @@ void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *an
         // It's not necessary to zero the set points for R/P because the PIDs will be zeroed below
 #ifdef USE_YAW_SPIN_RECOVERY
         if ((axis == FD_YAW) && gyroYawSpinDetected()) {
-            currentPidSetpoint = 0.0f;
+            setpoint = 0.0f;
         }
 #endif // USE_YAW_SPIN_RECOVERY
 
         // -----calculate error rate
-        errorRate = currentPidSetpoint - gyro.gyroADCf[axis]; // r - y
+        currentPidSetpoint[axis] = setpoint;
+        errorRate[axis] = setpoint - gyro.gyroADCf[axis]; // r - y
 
         handleCrashRecovery(
-            pidProfile->crash_recovery, angleTrim, axis, currentTimeUs, errorRate,
-            &currentPidSetpoint, &errorRate);
+            pidProfile->crash_recovery, angleTrim, axis, currentTimeUs, errorRate[axis],
+            &currentPidSetpoint[axis], &errorRate[axis]);
 
-        float dDelta = activePidController(pidProfile, axis, errorRate, dynCi, 0.0f, currentPidSetpoint);
+        loopState.outputSaturated[axis] = mixerIsOutputSaturated(axis, errorRate[axis]);
+    }
 
+    // ----------PID controller, all axes in one pass----------
+    activePidController(pidProfile, &loopState, errorRate, currentPidSetpoint, dDelta);
 
-        detectAndSetCrashRecovery(pidProfile->crash_recovery, axis, currentTimeUs, dDelta, errorRate);
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        detectAndSetCrashRecovery(pidProfile->crash_recovery, axis, currentTimeUs, dDelta[axis], errorRate[axis]);
 
         // -----calculate feedforward component
         // Only enable feedforward for rate mode
-        const float feedforwardGain = flightModeFlags ? 0.0f : pidCoefficient[axis].Kf;
+        const float feedforwardGain = flightModeFlags ? 0.0f : pidCoefficient.Kf[axis];
 
         if (feedforwardGain > 0) {
 
             // no transition if feedForwardTransition == 0
             float transition = feedForwardTransition > 0 ? MIN(1.f, getRcDeflectionAbs(axis) * feedForwardTransition) : 1;
 
-            float pidSetpointDelta = currentPidSetpoint - previousPidSetpoint[axis];
+            float pidSetpointDelta = currentPidSetpoint[axis] - previousPidSetpoint[axis];
 
 #ifdef USE_RC_SMOOTHING_FILTER
             pidSetpointDelta = applyRcSmoothingDerivativeFilter(axis, pidSetpointDelta);
@@ -1113,7 +1109,7 @@ void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *an
         } else {
             pidData[axis].F = 0;
         }
-        previousPidSetpoint[axis] = currentPidSetpoint;
+        previousPidSetpoint[axis] = currentPidSetpoint[axis];
 
 #ifdef USE_YAW_SPIN_RECOVERY
         if (gyroYawSpinDetected()) {
@@ -0,0 +1,202 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Per motor notch filter bank on the gyro, steered by the eRPM every ESC reports over bidirectional
+ * DShot. Each motor gets a notch on its rotation frequency and optionally on the next harmonics, so
+ * the notches sit right on the motor noise instead of where a spectrum estimate last found a peak.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_RPM_FILTER
+
+#include "build/debug.h"
+
+#include "common/axis.h"
+#include "common/filter.h"
+#include "common/maths.h"
+
+#include "drivers/pwm_output.h"
+
+#include "flight/mixer.h"
+#include "flight/pid.h"
+
+#include "pg/pg.h"
+#include "pg/pg_ids.h"
+
+#include "sensors/gyro.h"
+
+#include "rpm_filter.h"
+
+#define RPM_FILTER_MAX_NOTCHES  (RPM_FILTER_MAX_HARMONICS * MAX_SUPPORTED_MOTORS)
+// every notch gets new coefficients at about this rate, spread over the PID loops in between
+#define RPM_FILTER_UPDATE_HZ    1000
+// DShot telemetry reports eRPM / 100
+#define RPM_FILTER_ERPM_SCALE   100.0f
+// each gyro sensor is filtered on its own and needs its own notch states
+#ifdef USE_DUAL_GYRO
+#define RPM_FILTER_GYRO_COUNT   2
+#else
+#define RPM_FILTER_GYRO_COUNT   1
+#endif
+
+PG_REGISTER_WITH_RESET_TEMPLATE(rpmFilterConfig_t, rpmFilterConfig, PG_RPM_FILTER_CONFIG, 0);
+
+PG_RESET_TEMPLATE(rpmFilterConfig_t, rpmFilterConfig,
+    .gyro_rpm_notch_harmonics = 3,
+    .gyro_rpm_notch_min = 100,
+    .gyro_rpm_notch_q = 500,
+    .rpm_lpf = 150,
+);
+
+typedef struct rpmNotchBank_s {
+    uint8_t notchCount;             // motors * harmonics, 0 if the filter is off
+    uint8_t harmonics;
+    uint8_t updatesPerLoop;
+    uint8_t nextNotch;
+    float q;
+    float minHz;
+    float maxHz;
+    uint32_t looptimeUs;            // sample period of the signal the notches run on
+    // the notch of harmonic h of motor m is at [m * harmonics + h], the coefficients are the same for all gyros and axes
+    biquadFilter_t notch[RPM_FILTER_GYRO_COUNT][XYZ_AXIS_COUNT][RPM_FILTER_MAX_NOTCHES];
+} rpmNotchBank_t;
+
+static FAST_RAM_ZERO_INIT rpmNotchBank_t gyroBank;
+static FAST_RAM_ZERO_INIT pt1Filter_t motorFrequencyFilter[MAX_SUPPORTED_MOTORS];
+static FAST_RAM_ZERO_INIT float motorFrequencyHz[MAX_SUPPORTED_MOTORS];
+static FAST_RAM_ZERO_INIT float erpmToHz;
+static FAST_RAM_ZERO_INIT uint8_t motorCount;
+
+void rpmFilterInit(const rpmFilterConfig_t *config)
+{
+    gyroBank.notchCount = 0;
+
+    if (!config->gyro_rpm_notch_harmonics || !useDshotTelemetry) {
+        return;
+    }
+
+    motorCount = MIN(getMotorCount(), MAX_SUPPORTED_MOTORS);
+    gyroBank.harmonics = MIN(config->gyro_rpm_notch_harmonics, RPM_FILTER_MAX_HARMONICS);
+    gyroBank.q = config->gyro_rpm_notch_q / 100.0f;
+    gyroBank.minHz = config->gyro_rpm_notch_min;
+    gyroBank.maxHz = 0.48f * 1e6f / gyro.targetLooptime;
+    gyroBank.looptimeUs = gyro.targetLooptime;
+    gyroBank.notchCount = motorCount * gyroBank.harmonics;
+    gyroBank.nextNotch = 0;
+
+    for (int gyroIndex = 0; gyroIndex < RPM_FILTER_GYRO_COUNT; gyroIndex++) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            for (int i = 0; i < gyroBank.notchCount; i++) {
+                biquadFilterInit(&gyroBank.notch[gyroIndex][axis][i], gyroBank.minHz, gyroBank.looptimeUs, gyroBank.q, FILTER_NOTCH);
+            }
+        }
+    }
+
+    const float pidLooptimeS = targetPidLooptime * 1e-6f;
+    for (int motor = 0; motor < motorCount; motor++) {
+        pt1FilterInit(&motorFrequencyFilter[motor], pt1FilterGain(config->rpm_lpf, pidLooptimeS));
+        motorFrequencyHz[motor] = 0.0f;
+    }
+    erpmToHz = RPM_FILTER_ERPM_SCALE / 60.0f / (motorConfig()->motorPoleCount / 2.0f);
+
+    const float loopsPerUpdate = 1e6f / RPM_FILTER_UPDATE_HZ / targetPidLooptime;
+    gyroBank.updatesPerLoop = MAX(lrintf(ceilf(gyroBank.notchCount / loopsPerUpdate)), 1);
+}
+
+bool isRpmFilterEnabled(void)
+{
+    return gyroBank.notchCount > 0;
+}
+
+FAST_CODE float rpmFilterGyro(int gyroIndex, int axis, float value)
+{
+    biquadFilter_t *notch = gyroBank.notch[gyroIndex][axis];
+
+    for (int i = 0; i < gyroBank.notchCount; i++) {
+        value = biquadFilterApplyDF1(&notch[i], value);
+    }
+
+    return value;
+}
+
+static FAST_CODE void rpmNotchUpdate(rpmNotchBank_t *bank, int index, float frequencyHz)
+{
+    biquadFilter_t *notch = &bank->notch[0][X][index];
+
+    if (frequencyHz >= bank->minHz && frequencyHz < bank->maxHz) {
+        biquadFilterUpdate(notch, frequencyHz, bank->looptimeUs, bank->q, FILTER_NOTCH);
+    } else {
+        // a stopped motor, one whose telemetry timed out and reads 0, or a harmonic above Nyquist
+        // has nothing to take out, let the signal through
+        notch->b0 = 1.0f;
+        notch->b1 = notch->b2 = notch->a1 = notch->a2 = 0.0f;
+    }
+
+    for (int gyroIndex = 0; gyroIndex < RPM_FILTER_GYRO_COUNT; gyroIndex++) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            biquadFilter_t *other = &bank->notch[gyroIndex][axis][index];
+            if (other == notch) {
+                continue;
+            }
+            other->b0 = notch->b0;
+            other->b1 = notch->b1;
+            other->b2 = notch->b2;
+            other->a1 = notch->a1;
+            other->a2 = notch->a2;
+        }
+    }
+}
+
+// once per PID loop, after the motor outputs have been written and the replies decoded
+FAST_CODE_NOINLINE void rpmFilterUpdate(void)
+{
+    if (!gyroBank.notchCount) {
+        return;
+    }
+
+    for (int motor = 0; motor < motorCount; motor++) {
+        motorFrequencyHz[motor] = pt1FilterApply(&motorFrequencyFilter[motor], getDshotTelemetry(motor) * erpmToHz);
+        if (motor < 4) {
+            DEBUG_SET(DEBUG_RPM_FILTER, motor, lrintf(motorFrequencyHz[motor]));
+        }
+    }
+
+    for (int i = 0; i < gyroBank.updatesPerLoop; i++) {
+        const int index = gyroBank.nextNotch;
+        const int motor = index / gyroBank.harmonics;
+        const int harmonic = index - motor * gyroBank.harmonics;
+
+        rpmNotchUpdate(&gyroBank, index, motorFrequencyHz[motor] * (harmonic + 1));
+
+        gyroBank.nextNotch = index + 1 < gyroBank.notchCount ? index + 1 : 0;
+    }
+}
+
+float rpmFilterGetMotorFrequencyHz(int motor)
+{
+    return motorFrequencyHz[motor];
+}
+#endif
@@ -0,0 +1,43 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pg/pg.h"
+
+#define RPM_FILTER_MAX_HARMONICS 3
+
+typedef struct rpmFilterConfig_s {
+    uint8_t  gyro_rpm_notch_harmonics;      // notches per motor on the motor frequency and its multiples, 0 switches the filter off
+    uint8_t  gyro_rpm_notch_min;            // Hz, notches below this frequency let the signal through
+    uint16_t gyro_rpm_notch_q;              // notch Q * 100
+    uint16_t rpm_lpf;                       // Hz, smoothing of the motor frequencies reported by the ESCs
+} rpmFilterConfig_t;
+
+PG_DECLARE(rpmFilterConfig_t, rpmFilterConfig);
+
+void rpmFilterInit(const rpmFilterConfig_t *config);
+bool isRpmFilterEnabled(void);
+float rpmFilterGyro(int gyroIndex, int axis, float value);
+void rpmFilterUpdate(void);
+float rpmFilterGetMotorFrequencyHz(int motor);
@@ -63,6 +63,7 @@
 #include "fc/controlrate_profile.h"
 #include "fc/fc_core.h"
 #include "fc/fc_rc.h"
+#include "fc/loop_state.h"
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
 #include "fc/rc_modes.h"
@@ -97,6 +98,7 @@
 #include "io/vtx_string.h"
 
 #include "msp/msp_serial.h"
+#include "msp/msp_stream.h"
 
 #include "pg/beeper.h"
 #include "pg/board.h"
@@ -164,6 +166,9 @@ typedef enum {
 } mspFlashFsFlags_e;
 
 #define RATEPROFILE_MASK (1 << 7)
+
+// last snapshot of the PID loop handed out, kept if a read gets overtaken by the loop
+static loopState_t loopState;
 #endif //USE_OSD_SLAVE
 
 #define RTC_NOT_SUPPORTED 0xff
@@ -840,6 +845,8 @@ bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
 
     case MSP_RAW_IMU:
         {
+            loopStateRead(&loopState);
+
             // Hack scale due to choice of units for sensor data in multiwii
 
             uint8_t scale = 1;
@@ -854,13 +861,17 @@ bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
 #endif //USE_GYRO_IMUF901
 
             for (int i = 0; i < 3; i++) {
-                sbufWriteU16(dst, lrintf(acc.accADC[i] / scale));
+                sbufWriteU16(dst, lrintf(loopState.accADC[i] / scale));
             }
             for (int i = 0; i < 3; i++) {
-                sbufWriteU16(dst, gyroRateDps(i));
+                sbufWriteU16(dst, gyroRateToRaw(loopState.gyroADCf[i]));
             }
             for (int i = 0; i < 3; i++) {
-                sbufWriteU16(dst, lrintf(mag.magADC[i]));
+#ifdef USE_MAG
+                sbufWriteU16(dst, lrintf(loopState.magADC[i]));
+#else
+                sbufWriteU16(dst, 0);
+#endif
             }
         }
         break;
@@ -903,13 +914,17 @@ bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
 #endif
 
     case MSP_MOTOR:
-        for (unsigned i = 0; i < 8; i++) {
-            if (i >= MAX_SUPPORTED_MOTORS || !pwmGetMotors()[i].enabled) {
-                sbufWriteU16(dst, 0);
-                continue;
-            }
+        {
+            loopStateRead(&loopState);
+
+            for (unsigned i = 0; i < 8; i++) {
+                if (i >= MAX_SUPPORTED_MOTORS || !pwmGetMotors()[i].enabled) {
+                    sbufWriteU16(dst, 0);
+                    continue;
+                }
 
-            sbufWriteU16(dst, convertMotorToExternal(motor[i]));
+                sbufWriteU16(dst, convertMotorToExternal(loopState.motor[i]));
+            }
         }
         break;
 
@@ -920,9 +935,13 @@ bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
         break;
 
     case MSP_ATTITUDE:
-        sbufWriteU16(dst, attitude.values.roll);
-        sbufWriteU16(dst, attitude.values.pitch);
-        sbufWriteU16(dst, DECIDEGREES_TO_DEGREES(attitude.values.yaw));
+        {
+            loopStateRead(&loopState);
+
+            sbufWriteU16(dst, loopState.attitude.values.roll);
+            sbufWriteU16(dst, loopState.attitude.values.pitch);
+            sbufWriteU16(dst, DECIDEGREES_TO_DEGREES(loopState.attitude.values.yaw));
+        }
         break;
 
     case MSP_ALTITUDE:
@@ -2522,6 +2541,178 @@ mspResult_e mspCommonProcessInCommand(uint8_t cmdMSP, sbuf_t *src, mspPostProces
     return MSP_RESULT_ACK;
 }
 
+#define MSP_PG_LIST_PAGE_SIZE 32
+
+static int pgRegistryIndex(const pgRegistry_t *reg)
+{
+    return reg - __pg_registry_start;
+}
+
+// Private to MSP, the CLI owns reg->copy and may hold an edit in it at any time.
+// A transfer is only continued with the chunk that directly follows the last one,
+// anything else that touches the buffer (including a modified check) abandons it.
+static uint8_t mspPgStaging[PG_MAX_SIZE];
+static pgn_t mspPgStagingPgn;
+static uint16_t mspPgStagingOffset;
+
+static void mspPgStagingReset(void)
+{
+    mspPgStagingPgn = 0;
+    mspPgStagingOffset = 0;
+}
+
+static bool pgIsModified(const pgRegistry_t *reg)
+{
+    mspPgStagingReset();
+    pgResetInstance(reg, mspPgStaging);
+    return memcmp(reg->address, mspPgStaging, pgSize(reg)) != 0;
+}
+
+#ifdef USE_MSP_STREAM
+// Only replies that are cheap to generate, fit a single small frame and take no arguments may be streamed.
+static const uint8_t mspStreamCommands[] = {
+    MSP_STATUS, MSP_STATUS_EX, MSP_RAW_IMU, MSP_SERVO, MSP_MOTOR, MSP_RC, MSP_RAW_GPS, MSP_COMP_GPS,
+    MSP_ATTITUDE, MSP_ALTITUDE, MSP_ANALOG, MSP_BATTERY_STATE, MSP_ESC_SENSOR_DATA, MSP_DEBUG,
+};
+
+static bool mspStreamCommandAllowed(uint16_t cmdMSP)
+{
+    for (unsigned i = 0; i < ARRAYLEN(mspStreamCommands); i++) {
+        if (mspStreamCommands[i] == cmdMSP) {
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+static mspResult_e mspFcProcessV2Command(uint16_t cmdMSP, sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    switch (cmdMSP) {
+    case MSP2_PG_LIST:
+        {
+            const int first = sbufBytesRemaining(src) ? sbufReadU8(src) * MSP_PG_LIST_PAGE_SIZE : 0;
+            const int count = constrain(PG_REGISTRY_SIZE - first, 0, MSP_PG_LIST_PAGE_SIZE);
+
+            sbufWriteU16(dst, PG_REGISTRY_SIZE);
+            sbufWriteU16(dst, first);
+            sbufWriteU8(dst, count);
+            for (int i = first; i < first + count; i++) {
+                const pgRegistry_t *reg = &__pg_registry_start[i];
+                sbufWriteU16(dst, pgN(reg));
+                sbufWriteU8(dst, pgVersion(reg));
+                sbufWriteU16(dst, pgSize(reg));
+            }
+        }
+        break;
+
+    case MSP2_PG_MODIFIED:
+        {
+            // one bit per group in registry order, as reported by MSP2_PG_LIST
+            uint8_t bits = 0;
+            sbufWriteU16(dst, PG_REGISTRY_SIZE);
+            PG_FOREACH(reg) {
+                const int index = pgRegistryIndex(reg);
+                if (pgIsModified(reg)) {
+                    bits |= 1 << (index % 8);
+                }
+                if (index % 8 == 7 || reg + 1 == __pg_registry_end) {
+                    sbufWriteU8(dst, bits);
+                    bits = 0;
+                }
+            }
+        }
+        break;
+
+    case MSP2_PG_GET:
+        {
+            if (sbufBytesRemaining(src) < 2) {
+                return MSP_RESULT_ERROR;
+            }
+            const pgRegistry_t *reg = pgFind(sbufReadU16(src));
+            const int offset = sbufBytesRemaining(src) >= 2 ? sbufReadU16(src) : 0;
+            if (!reg || offset > pgSize(reg)) {
+                return MSP_RESULT_ERROR;
+            }
+
+            sbufWriteU16(dst, pgN(reg));
+            sbufWriteU8(dst, pgVersion(reg));
+            sbufWriteU16(dst, pgSize(reg));
+            sbufWriteU16(dst, offset);
+
+            const int len = MIN(pgSize(reg) - offset, sbufBytesRemaining(dst));
+            if (offset == 0) {
+                sbufAdvance(dst, pgStore(reg, sbufPtr(dst), len));
+            } else {
+                sbufWriteData(dst, reg->address + offset, len);
+            }
+        }
+        break;
+
+    case MSP2_PG_SET:
+        {
+            // Chunks are staged and the group is only loaded once its last byte arrives,
+            // so a partially transferred image never reaches the live config.
+            if (ARMING_FLAG(ARMED) || sbufBytesRemaining(src) < 5) {
+                return MSP_RESULT_ERROR;
+            }
+            const pgRegistry_t *reg = pgFind(sbufReadU16(src));
+            const uint8_t version = sbufReadU8(src);
+            const int offset = sbufReadU16(src);
+            const int len = sbufBytesRemaining(src);
+            if (!reg || version != pgVersion(reg) || offset + len > pgSize(reg)) {
+                mspPgStagingReset();
+                return MSP_RESULT_ERROR;
+            }
+
+            if (offset == 0) {
+                memcpy(mspPgStaging, reg->address, pgSize(reg));
+                mspPgStagingPgn = pgN(reg);
+            } else if (mspPgStagingPgn != pgN(reg) || mspPgStagingOffset != offset) {
+                mspPgStagingReset();
+                return MSP_RESULT_ERROR;
+            }
+            sbufReadData(src, mspPgStaging + offset, len);
+            mspPgStagingOffset = offset + len;
+            if (mspPgStagingOffset == pgSize(reg)) {
+                pgLoad(reg, mspPgStaging, pgSize(reg), version);
+                mspPgStagingReset();
+            }
+        }
+        break;
+
+#ifdef USE_MSP_STREAM
+    case MSP2_STREAM_SUBSCRIBE:
+        {
+            // The whole request is validated first, a bad entry leaves the current subscriptions untouched.
+            // They are replaced for the requesting port only, once the reply has been sent on it.
+            const int count = sbufBytesRemaining(src) / 3;
+            if (sbufBytesRemaining(src) % 3 || count > MSP_STREAM_MAX_SUBSCRIPTIONS) {
+                return MSP_RESULT_ERROR;
+            }
+            mspStreamRequestClear();
+            for (int i = 0; i < count; i++) {
+                const uint16_t streamCmd = sbufReadU16(src);
+                const uint8_t rateHz = sbufReadU8(src);
+                if (!mspStreamCommandAllowed(streamCmd) || !mspStreamRequestAdd(streamCmd, rateHz)) {
+                    return MSP_RESULT_ERROR;
+                }
+            }
+
+            sbufWriteU8(dst, mspStreamRequestCount());
+            if (mspPostProcessFn) {
+                *mspPostProcessFn = mspStreamApplyRequest;
+            }
+        }
+        break;
+#endif
+
+    default:
+        return MSP_RESULT_CMD_UNKNOWN;
+    }
+    return MSP_RESULT_ACK;
+}
+
 /*
  * Returns MSP_RESULT_ACK, MSP_RESULT_ERROR or MSP_RESULT_NO_REPLY
  */
@@ -2534,7 +2725,13 @@ mspResult_e mspFcProcessCommand(mspPacket_t *cmd, mspPacket_t *reply, mspPostPro
     // initialize reply by default
     reply->cmd = cmd->cmd;
 
-    if (mspCommonProcessOutCommand(cmdMSP, dst, mspPostProcessFn)) {
+    if (cmd->cmd > 0xff) {
+        // MSPv2 only command ids, must not be truncated into the MSPv1 id space
+        ret = mspFcProcessV2Command(cmd->cmd, src, dst, mspPostProcessFn);
+        if (ret == MSP_RESULT_CMD_UNKNOWN) {
+            ret = MSP_RESULT_ERROR;
+        }
+    } else if (mspCommonProcessOutCommand(cmdMSP, dst, mspPostProcessFn)) {
         ret = MSP_RESULT_ACK;
     } else if (mspProcessOutCommand(cmdMSP, dst)) {
         ret = MSP_RESULT_ACK;
@@ -62,7 +62,7 @@
 #define MSP_PROTOCOL_VERSION                0
 
 #define API_VERSION_MAJOR                   1  // increment when major changes are made
-#define API_VERSION_MINOR                   40 // increment after a release, to set the version for all changes to go into the following release (if no changes to MSP are made between the releases, this can be reverted before the release)
+#define API_VERSION_MINOR                   41 // increment after a release, to set the version for all changes to go into the following release (if no changes to MSP are made between the releases, this can be reverted before the release)
 
 #define API_VERSION_LENGTH                  2
 
@@ -337,3 +337,11 @@
 #define MSP_IMUF_CONFIG          227    //out message
 #define MSP_SET_IMUF_CONFIG      228    //in message
 #define MSP_IMUF_INFO            229    //out message
+
+// MSPv2 commands (16 bit command ids, only reachable over MSPv2 framing)
+// Parameter group bulk access: groups are transferred as raw images tagged with pgn and version.
+#define MSP2_PG_LIST             0x3000 //out message         List registered parameter groups (pgn, version, size), paged
+#define MSP2_PG_MODIFIED         0x3001 //out message         Bitmap of parameter groups that differ from their defaults
+#define MSP2_PG_GET              0x3002 //out message         Get a parameter group image, in chunks
+#define MSP2_PG_SET              0x3003 //in message          Set a parameter group image, in chunks
+#define MSP2_STREAM_SUBSCRIBE    0x3004 //in message          Replace the set of streamed MSP replies (cmd, rate Hz), empty to stop
@@ -64,6 +64,7 @@ typedef enum {
 #endif
 #ifdef USE_GYRO_IMUF9001
     TABLE_IMUF_RATE,
+    TABLE_IMU_ATTITUDE_SOURCE,
 #endif
     TABLE_DEBUG,
     TABLE_MOTOR_PWM_PROTOCOL,
@@ -99,6 +100,7 @@ typedef enum {
 #endif
 #ifdef USE_DUAL_GYRO
     TABLE_GYRO,
+    TABLE_GYRO_COMBINE,
 #endif
     TABLE_THROTTLE_LIMIT_TYPE,
 #ifdef USE_MAX7456
@@ -34,7 +34,8 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include <string.h>
+
+#include "common/ring_buffer.h"
 
 #include "drivers/flash.h"
 
@@ -42,26 +43,23 @@
 
 static uint8_t flashWriteBuffer[FLASHFS_WRITE_BUFFER_SIZE];
 
-/* The position of our head and tail in the circular flash write buffer.
- *
- * The head is the index that a byte would be inserted into on writing, while the tail is the index of the
- * oldest byte that has yet to be written to flash.
- *
- * When the circular buffer is empty, head == tail
- */
-static uint8_t bufferHead = 0, bufferTail = 0;
+/* The circular flash write buffer. Its tail is the oldest byte that has yet to be written to flash. */
+static ringBuffer_t flashWriteRing = {
+    .buffer = flashWriteBuffer,
+    .mask = FLASHFS_WRITE_BUFFER_SIZE - 1,
+};
 
 // The position of the buffer's tail in the overall flash address space:
 static uint32_t tailAddress = 0;
 
 static void flashfsClearBuffer(void)
 {
-    bufferTail = bufferHead = 0;
+    ringBufferClear(&flashWriteRing);
 }
 
 static bool flashfsBufferIsEmpty(void)
 {
-    return bufferTail == bufferHead;
+    return ringBufferIsEmpty(&flashWriteRing);
 }
 
 static void flashfsSetTailAddress(uint32_t address)
@@ -127,10 +125,7 @@ uint32_t flashfsGetSize(void)
 
 static uint32_t flashfsTransmitBufferUsed(void)
 {
-    if (bufferHead >= bufferTail)
-        return bufferHead - bufferTail;
-
-    return FLASHFS_WRITE_BUFFER_SIZE - bufferTail + bufferHead;
+    return ringBufferUsed(&flashWriteRing);
 }
 
 /**
@@ -266,16 +261,7 @@ static uint32_t flashfsWriteBuffers(uint8_t const **buffers, uint32_t *bufferSiz
  */
 static void flashfsGetDirtyDataBuffers(uint8_t const *buffers[], uint32_t bufferSizes[])
 {
-    buffers[0] = flashWriteBuffer + bufferTail;
-    buffers[1] = flashWriteBuffer + 0;
-
-    if (bufferHead >= bufferTail) {
-        bufferSizes[0] = bufferHead - bufferTail;
-        bufferSizes[1] = 0;
-    } else {
-        bufferSizes[0] = FLASHFS_WRITE_BUFFER_SIZE - bufferTail;
-        bufferSizes[1] = bufferHead;
-    }
+    ringBufferPeekSpans(&flashWriteRing, buffers, bufferSizes);
 }
 
 /**
@@ -298,12 +284,7 @@ uint32_t flashfsGetOffset(void)
  */
 static void flashfsAdvanceTailInBuffer(uint32_t delta)
 {
-    bufferTail += delta;
-
-    // Wrap tail around the end of the buffer
-    if (bufferTail >= FLASHFS_WRITE_BUFFER_SIZE) {
-        bufferTail -= FLASHFS_WRITE_BUFFER_SIZE;
-    }
+    ringBufferConsume(&flashWriteRing, delta);
 
     if (flashfsBufferIsEmpty()) {
         flashfsClearBuffer(); // Bring buffer pointers back to the start to be tidier
@@ -374,11 +355,7 @@ void flashfsSeekRel(int32_t offset)
  */
 void flashfsWriteByte(uint8_t byte)
 {
-    flashWriteBuffer[bufferHead++] = byte;
-
-    if (bufferHead >= FLASHFS_WRITE_BUFFER_SIZE) {
-        bufferHead = 0;
-    }
+    ringBufferPushByte(&flashWriteRing, byte);
 
     if (flashfsTransmitBufferUsed() >= FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN) {
         flashfsFlushAsync();
@@ -448,25 +425,7 @@ void flashfsWrite(const uint8_t *data, unsigned int len, bool sync)
     }
 
     // Buffer up the data the user supplied instead of writing it right away
-
-    // First write the portion before we wrap around the end of the circular buffer
-    unsigned int bufferBytesBeforeWrap = FLASHFS_WRITE_BUFFER_SIZE - bufferHead;
-
-    unsigned int firstPortion = len < bufferBytesBeforeWrap ? len : bufferBytesBeforeWrap;
-
-    memcpy(flashWriteBuffer + bufferHead, data, firstPortion);
-
-    bufferHead += firstPortion;
-
-    data += firstPortion;
-    len -= firstPortion;
-
-    // If we wrap the head around, write the remainder to the start of the buffer (if any)
-    if (bufferHead == FLASHFS_WRITE_BUFFER_SIZE) {
-        memcpy(flashWriteBuffer + 0, data, len);
-
-        bufferHead = len;
-    }
+    ringBufferPush(&flashWriteRing, data, len);
 }
 
 /**
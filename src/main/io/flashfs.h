@@ -20,8 +20,8 @@
 
 #pragma once
 
-#define FLASHFS_WRITE_BUFFER_SIZE 128
-#define FLASHFS_WRITE_BUFFER_USABLE (FLASHFS_WRITE_BUFFER_SIZE - 1)
+#define FLASHFS_WRITE_BUFFER_SIZE 128 // must be a power of two
+#define FLASHFS_WRITE_BUFFER_USABLE FLASHFS_WRITE_BUFFER_SIZE
 
 // Automatically trigger a flush when this much data is in the buffer
 #define FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN 64
@@ -29,6 +29,7 @@
 #include "common/streambuf.h"
 #include "common/utils.h"
 #include "common/crc.h"
+#include "common/maths.h"
 
 #include "drivers/system.h"
 
@@ -46,6 +47,7 @@
 #endif
 
 static mspPort_t mspPorts[MAX_MSP_PORT_COUNT];
+static mspPort_t *mspCommandPort;   // port whose request is being processed, NULL otherwise
 
 static void resetMspPort(mspPort_t *mspPortToReset, serialPort_t *serialPort, bool sharedWithTelemetry)
 {
@@ -157,11 +159,14 @@ static bool mspSerialProcessReceivedData(mspPort_t *mspPort, uint32_t c)
             mspPort->checksum1 ^= c;
             if (mspPort->offset == sizeof(mspHeaderV1_t)) {
                 mspHeaderV1_t * hdr = (mspHeaderV1_t *)&mspPort->inBuf[0];
-                // Check incoming buffer size limit
+                // Check incoming buffer size limit, the 8 bit v1 size can only exceed a small buffer
+#if MSP_PORT_INBUF_SIZE < 255
                 if (hdr->size > MSP_PORT_INBUF_SIZE) {
                     mspPort->c_state = MSP_IDLE;
                 }
-                else if (hdr->cmd == MSP_V2_FRAME_ID) {
+                else
+#endif
+                if (hdr->cmd == MSP_V2_FRAME_ID) {
                     // MSPv1 payload must be big enough to hold V2 header + extra checksum
                     if (hdr->size >= sizeof(mspHeaderV2_t) + 1) {
                         mspPort->mspVersion = MSP_V2_OVER_V1;
@@ -203,6 +208,10 @@ static bool mspSerialProcessReceivedData(mspPort_t *mspPort, uint32_t c)
             mspPort->checksum2 = crc8_dvb_s2(mspPort->checksum2, c);
             if (mspPort->offset == (sizeof(mspHeaderV2_t) + sizeof(mspHeaderV1_t))) {
                 mspHeaderV2_t * hdrv2 = (mspHeaderV2_t *)&mspPort->inBuf[sizeof(mspHeaderV1_t)];
+                if (hdrv2->size > MSP_PORT_INBUF_SIZE) {
+                    mspPort->c_state = MSP_IDLE;
+                    break;
+                }
                 mspPort->dataSize = hdrv2->size;
                 mspPort->cmdMSP = hdrv2->cmd;
                 mspPort->cmdFlags = hdrv2->flags;
@@ -235,6 +244,10 @@ static bool mspSerialProcessReceivedData(mspPort_t *mspPort, uint32_t c)
             mspPort->checksum2 = crc8_dvb_s2(mspPort->checksum2, c);
             if (mspPort->offset == sizeof(mspHeaderV2_t)) {
                 mspHeaderV2_t * hdrv2 = (mspHeaderV2_t *)&mspPort->inBuf[0];
+                if (hdrv2->size > MSP_PORT_INBUF_SIZE) {
+                    mspPort->c_state = MSP_IDLE;
+                    break;
+                }
                 mspPort->dataSize = hdrv2->size;
                 mspPort->cmdMSP = hdrv2->cmd;
                 mspPort->cmdFlags = hdrv2->flags;
@@ -273,36 +286,173 @@ static uint8_t mspSerialChecksumBuf(uint8_t checksum, const uint8_t *data, int l
 }
 
 #define JUMBO_FRAME_SIZE_LIMIT 255
-static int mspSerialSendFrame(mspPort_t *msp, const uint8_t * hdr, int hdrLen, const uint8_t * data, int dataLen, const uint8_t * crc, int crcLen)
+#define MSP_PENDING_REPLY_TIMEOUT_MS 500
+#define MSP_FRAME_WRITE_CHUNK 64    // payload is checksummed in chunks right before they are written
+
+static void mspSerialFrameChecksumUpdate(mspFrame_t *frame, const uint8_t *data, int len)
 {
-    // We are allowed to send out the response if
-    //  a) TX buffer is completely empty (we are talking to well-behaving party that follows request-response scheduling;
-    //     this allows us to transmit jumbo frames bigger than TX buffer (serialWriteBuf will block, but for jumbo frames we don't care)
-    //  b) Response fits into TX buffer
-    const int totalFrameLength = hdrLen + dataLen + crcLen;
-    if (!isSerialTransmitBufferEmpty(msp->port) && ((int)serialTxBytesFree(msp->port) < totalFrameLength))
-        return 0;
+    switch (frame->mspVersion) {
+    case MSP_V2_OVER_V1:
+        frame->checksum1 = mspSerialChecksumBuf(frame->checksum1, data, len);
+        FALLTHROUGH;
+    case MSP_V2_NATIVE:
+        frame->checksum2 = crc8_dvb_s2_update(frame->checksum2, data, len);
+        break;
+    default:
+        frame->checksum1 = mspSerialChecksumBuf(frame->checksum1, data, len);
+        break;
+    }
+}
+
+// Only valid once the whole payload has been queued
+static void mspSerialFrameChecksumFinish(mspFrame_t *frame)
+{
+    switch (frame->mspVersion) {
+    case MSP_V2_OVER_V1:
+        // the MSPv1 checksum covers the MSPv2 one as well
+        frame->crc[0] = frame->checksum2;
+        frame->crc[1] = frame->checksum1 ^ frame->checksum2;
+        break;
+    case MSP_V2_NATIVE:
+        frame->crc[0] = frame->checksum2;
+        break;
+    default:
+        frame->crc[0] = frame->checksum1;
+        break;
+    }
+}
+
+// Copy straight into the port's TX buffer where the driver supports reserving it,
+// the others (e.g. VCP, which buffers between begin and end write) take serialWriteBuf.
+static void mspSerialWriteData(serialPort_t *port, const uint8_t *data, int len)
+{
+    while (len > 0) {
+        uint8_t *buf;
+        const int reserved = serialReserveWrite(port, &buf);
+        if (reserved <= 0) {
+            serialWriteBuf(port, data, len);
+            return;
+        }
+        const int chunk = MIN(reserved, len);
+        memcpy(buf, data, chunk);
+        serialCommitWrite(port, chunk);
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+// Queue up to room bytes of the frame, straight from the segment memory into the TX buffer.
+// Returns the number of bytes queued.
+static int mspSerialWriteFrame(serialPort_t *port, mspFrame_t *frame, int room)
+{
+    int skip = frame->sent;
+    int written = 0;
+
+    serialBeginWrite(port);
+    for (int i = 0; i < MSP_FRAME_SEGMENT_COUNT && room > 0; i++) {
+        const mspFrameSegment_t *segment = &frame->segments[i];
+        if (skip >= segment->len) {
+            skip -= segment->len;
+            continue;
+        }
+        if (i == MSP_FRAME_SEGMENT_COUNT - 1) {
+            mspSerialFrameChecksumFinish(frame);
+        }
+        const uint8_t *ptr = segment->ptr + skip;
+        int len = MIN(segment->len - skip, room);
+        room -= len;
+        written += len;
+        while (len > 0) {
+            const int chunk = (i == 1) ? MIN(len, MSP_FRAME_WRITE_CHUNK) : len;
+            if (i == 1) {
+                mspSerialFrameChecksumUpdate(frame, ptr, chunk);
+            }
+            mspSerialWriteData(port, ptr, chunk);
+            ptr += chunk;
+            len -= chunk;
+        }
+        skip = 0;
+    }
+    serialEndWrite(port);
+
+    frame->sent += written;
+    return written;
+}
+
+// Queue as much of the pending reply as the TX buffer takes.
+// Returns true while part of the reply is still waiting to be queued.
+static bool mspSerialSendPendingReply(mspPort_t *msp)
+{
+    mspFrame_t *reply = &msp->pendingReply;
+    if (!reply->totalLen) {
+        return false;
+    }
 
-    // Transmit frame
-    serialBeginWrite(msp->port);
-    serialWriteBuf(msp->port, hdr, hdrLen);
-    serialWriteBuf(msp->port, data, dataLen);
-    serialWriteBuf(msp->port, crc, crcLen);
-    serialEndWrite(msp->port);
+    const int room = serialTxBytesFree(msp->port);
+    if (room > 0) {
+        mspSerialWriteFrame(msp->port, reply, room);
+        reply->lastProgressMs = millis();
+    }
+
+    // give up on the reply if the port stopped draining, e.g. the USB host went away
+    if (reply->sent == reply->totalLen
+        || millis() - reply->lastProgressMs > MSP_PENDING_REPLY_TIMEOUT_MS) {
+        memset(reply, 0, sizeof(*reply));
+        return false;
+    }
+    return true;
+}
 
-    return totalFrameLength;
+// Replies are built in a buffer shared by all ports, it stays busy until a pending reply is queued.
+static bool mspSerialOutBufBusy(void)
+{
+    for (uint8_t portIndex = 0; portIndex < MAX_MSP_PORT_COUNT; portIndex++) {
+        if (mspPorts[portIndex].pendingReply.totalLen) {
+            return true;
+        }
+    }
+    return false;
 }
 
-static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e mspVersion)
+static int mspSerialSendFrame(mspPort_t *msp, mspFrame_t *frame, bool deferrable)
+{
+    if ((int)serialTxBytesFree(msp->port) < frame->totalLen) {
+        if (!deferrable) {
+            // Pushed frames reference transient data, so they can't wait for the TX buffer to drain.
+            // They are still sent if the TX buffer is completely empty (serialWriteBuf will block,
+            // but pushes are small and this keeps jumbo pushes working).
+            if (!isSerialTransmitBufferEmpty(msp->port)) {
+                return 0;
+            }
+        } else {
+            // Keep the reply and queue it piecewise on the following calls
+            mspFrame_t *reply = &msp->pendingReply;
+            *reply = *frame;
+            reply->segments[0].ptr = reply->hdr;
+            reply->segments[2].ptr = reply->crc;
+            reply->lastProgressMs = millis();
+            mspSerialSendPendingReply(msp);
+
+            return frame->totalLen;
+        }
+    }
+
+    return mspSerialWriteFrame(msp->port, frame, frame->totalLen);
+}
+
+static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e mspVersion, bool deferrable)
 {
     static const uint8_t mspMagic[MSP_VERSION_COUNT] = MSP_VERSION_MAGIC_INITIALIZER;
     const int dataLen = sbufBytesRemaining(&packet->buf);
-    uint8_t hdrBuf[16] = { '$', mspMagic[mspVersion], packet->result == MSP_RESULT_ERROR ? '!' : '>'};
-    uint8_t crcBuf[2];
-    uint8_t checksum;
+    mspFrame_t frame = {
+        .hdr = { '$', mspMagic[mspVersion], packet->result == MSP_RESULT_ERROR ? '!' : '>'},
+        .mspVersion = mspVersion,
+    };
+    uint8_t *hdrBuf = frame.hdr;
     int hdrLen = 3;
     int crcLen = 0;
 
+    // Only the header checksums are computed here, the payload is folded in while it is written
     #define V1_CHECKSUM_STARTPOS 3
     if (mspVersion == MSP_V1) {
         mspHeaderV1_t * hdrV1 = (mspHeaderV1_t *)&hdrBuf[hdrLen];
@@ -321,10 +471,8 @@ static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e msp
             hdrV1->size = dataLen;
         }
 
-        // Pre-calculate CRC
-        checksum = mspSerialChecksumBuf(0, hdrBuf + V1_CHECKSUM_STARTPOS, hdrLen - V1_CHECKSUM_STARTPOS);
-        checksum = mspSerialChecksumBuf(checksum, sbufPtr(&packet->buf), dataLen);
-        crcBuf[crcLen++] = checksum;
+        frame.checksum1 = mspSerialChecksumBuf(0, hdrBuf + V1_CHECKSUM_STARTPOS, hdrLen - V1_CHECKSUM_STARTPOS);
+        crcLen = 1;
     }
     else if (mspVersion == MSP_V2_OVER_V1) {
         mspHeaderV1_t * hdrV1 = (mspHeaderV1_t *)&hdrBuf[hdrLen];
@@ -355,15 +503,10 @@ static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e msp
         hdrV2->size = dataLen;
 
         // V2 CRC: only V2 header + data payload
-        checksum = crc8_dvb_s2_update(0, (uint8_t *)hdrV2, sizeof(mspHeaderV2_t));
-        checksum = crc8_dvb_s2_update(checksum, sbufPtr(&packet->buf), dataLen);
-        crcBuf[crcLen++] = checksum;
-
+        frame.checksum2 = crc8_dvb_s2_update(0, (uint8_t *)hdrV2, sizeof(mspHeaderV2_t));
         // V1 CRC: All headers + data payload + V2 CRC byte
-        checksum = mspSerialChecksumBuf(0, hdrBuf + V1_CHECKSUM_STARTPOS, hdrLen - V1_CHECKSUM_STARTPOS);
-        checksum = mspSerialChecksumBuf(checksum, sbufPtr(&packet->buf), dataLen);
-        checksum = mspSerialChecksumBuf(checksum, crcBuf, crcLen);
-        crcBuf[crcLen++] = checksum;
+        frame.checksum1 = mspSerialChecksumBuf(0, hdrBuf + V1_CHECKSUM_STARTPOS, hdrLen - V1_CHECKSUM_STARTPOS);
+        crcLen = 2;
     }
     else if (mspVersion == MSP_V2_NATIVE) {
         mspHeaderV2_t * hdrV2 = (mspHeaderV2_t *)&hdrBuf[hdrLen];
@@ -373,20 +516,24 @@ static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e msp
         hdrV2->cmd = packet->cmd;
         hdrV2->size = dataLen;
 
-        checksum = crc8_dvb_s2_update(0, (uint8_t *)hdrV2, sizeof(mspHeaderV2_t));
-        checksum = crc8_dvb_s2_update(checksum, sbufPtr(&packet->buf), dataLen);
-        crcBuf[crcLen++] = checksum;
+        frame.checksum2 = crc8_dvb_s2_update(0, (uint8_t *)hdrV2, sizeof(mspHeaderV2_t));
+        crcLen = 1;
     }
     else {
         // Shouldn't get here
         return 0;
     }
 
+    frame.segments[0] = (mspFrameSegment_t){ frame.hdr, hdrLen };
+    frame.segments[1] = (mspFrameSegment_t){ sbufPtr(&packet->buf), dataLen };
+    frame.segments[2] = (mspFrameSegment_t){ frame.crc, crcLen };
+    frame.totalLen = hdrLen + dataLen + crcLen;
+
     // Send the frame
-    return mspSerialSendFrame(msp, hdrBuf, hdrLen, sbufPtr(&packet->buf), dataLen, crcBuf, crcLen);
+    return mspSerialSendFrame(msp, &frame, deferrable);
 }
 
-static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspProcessCommandFnPtr mspProcessCommandFn)
+static void mspSerialProcessReceivedCommand(mspPort_t *msp, mspProcessCommandFnPtr mspProcessCommandFn)
 {
     static uint8_t outBuf[MSP_PORT_OUTBUF_SIZE];
 
@@ -408,14 +555,16 @@ static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspPr
     };
 
     mspPostProcessFnPtr mspPostProcessFn = NULL;
+    mspCommandPort = msp;
     const mspResult_e status = mspProcessCommandFn(&command, &reply, &mspPostProcessFn);
+    mspCommandPort = NULL;
 
     if (status != MSP_RESULT_NO_REPLY) {
         sbufSwitchToReader(&reply.buf, outBufHead); // change streambuf direction
-        mspSerialEncode(msp, &reply, msp->mspVersion);
+        mspSerialEncode(msp, &reply, msp->mspVersion, true);
     }
 
-    return mspPostProcessFn;
+    msp->pendingPostProcessFn = mspPostProcessFn;
 }
 
 static void mspEvaluateNonMspData(mspPort_t * mspPort, uint8_t receivedChar)
@@ -480,7 +629,8 @@ static void mspSerialProcessReceivedReply(mspPort_t *msp, mspProcessReplyFnPtr m
 /*
  * Process MSP commands from serial ports configured as MSP ports.
  *
- * Called periodically by the scheduler.
+ * Called periodically by the scheduler. All requests waiting in the RX buffer are processed
+ * (pipelining) for as long as their replies can be queued without waiting for the port.
  */
 void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn)
 {
@@ -490,9 +640,26 @@ void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessComm
             continue;
         }
 
-        mspPostProcessFnPtr mspPostProcessFn = NULL;
+        if (mspSerialSendPendingReply(mspPort)) {
+            continue;
+        }
+
+        if (mspPort->pendingPostProcessFn) {
+            // post processing (reboot, passthrough) needs the reply to be on the wire first
+            if (isSerialTransmitBufferEmpty(mspPort->port)) {
+                const mspPostProcessFnPtr mspPostProcessFn = mspPort->pendingPostProcessFn;
+                mspPort->pendingPostProcessFn = NULL;
+                mspPostProcessFn(mspPort->port);
+            }
+            continue;
+        }
 
         if (!mspPort->pendingRequest && serialRxBytesWaiting(mspPort->port)) {
+            if (mspSerialOutBufBusy()) {
+                // another port still sends its reply from the shared buffer, leave the requests in the RX buffer
+                continue;
+            }
+
             // There are bytes incoming - abort pending request
             mspPort->lastActivityMs = millis();
             mspPort->pendingRequest = MSP_PENDING_NONE;
@@ -507,19 +674,17 @@ void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessComm
 
                 if (mspPort->c_state == MSP_COMMAND_RECEIVED) {
                     if (mspPort->packetType == MSP_PACKET_COMMAND) {
-                        mspPostProcessFn = mspSerialProcessReceivedCommand(mspPort, mspProcessCommandFn);
+                        mspSerialProcessReceivedCommand(mspPort, mspProcessCommandFn);
                     } else if (mspPort->packetType == MSP_PACKET_REPLY) {
                         mspSerialProcessReceivedReply(mspPort, mspProcessReplyFn);
                     }
 
                     mspPort->c_state = MSP_IDLE;
-                    break; // process one command at a time so as not to block.
-                }
-            }
 
-            if (mspPostProcessFn) {
-                waitForSerialPortToFinishTransmitting(mspPort->port);
-                mspPostProcessFn(mspPort->port);
+                    if (mspPort->pendingReply.totalLen || mspPort->pendingPostProcessFn) {
+                        break; // the reply did not fit, continue with the remaining requests once it is queued
+                    }
+                }
             }
         }
         else {
@@ -536,7 +701,7 @@ bool mspSerialWaiting(void)
             continue;
         }
 
-        if (serialRxBytesWaiting(mspPort->port)) {
+        if (serialRxBytesWaiting(mspPort->port) || mspPort->pendingReply.totalLen || mspPort->pendingPostProcessFn) {
             return true;
         }
     }
@@ -549,6 +714,24 @@ void mspSerialInit(void)
     mspSerialAllocatePorts();
 }
 
+// Returns the number of bytes written, 0 if the port is still busy with a reply.
+int mspSerialPushPort(mspPort_t *mspPort, uint8_t cmd, uint8_t *data, int datalen, mspDirection_e direction)
+{
+    // don't interleave with a reply that is still being queued
+    if (!mspPort->port || mspPort->pendingReply.totalLen) {
+        return 0;
+    }
+
+    mspPacket_t push = {
+        .buf = { .ptr = data, .end = data + datalen, },
+        .cmd = cmd,
+        .result = 0,
+        .direction = direction,
+    };
+
+    return mspSerialEncode(mspPort, &push, MSP_V1, false);
+}
+
 int mspSerialPush(uint8_t cmd, uint8_t *data, int datalen, mspDirection_e direction)
 {
     int ret = 0;
@@ -564,18 +747,30 @@ int mspSerialPush(uint8_t cmd, uint8_t *data, int datalen, mspDirection_e direct
             continue;
         }
 
-        mspPacket_t push = {
-            .buf = { .ptr = data, .end = data + datalen, },
-            .cmd = cmd,
-            .result = 0,
-            .direction = direction,
-        };
-
-        ret = mspSerialEncode(mspPort, &push, MSP_V1);
+        const int written = mspSerialPushPort(mspPort, cmd, data, datalen, direction);
+        if (written) {
+            ret = written;
+        }
     }
     return ret; // return the number of bytes written
 }
 
+// The MSP port the request currently being processed came in on, NULL for requests from elsewhere (e.g. telemetry)
+mspPort_t *mspSerialCommandPort(void)
+{
+    return mspCommandPort;
+}
+
+mspPort_t *mspSerialFindPort(const serialPort_t *serialPort)
+{
+    for (int portIndex = 0; serialPort && portIndex < MAX_MSP_PORT_COUNT; portIndex++) {
+        if (mspPorts[portIndex].port == serialPort) {
+            return &mspPorts[portIndex];
+        }
+    }
+    return NULL;
+}
+
 
 uint32_t mspSerialTxBytesFree(void)
 {
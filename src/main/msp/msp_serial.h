@@ -63,7 +63,13 @@ typedef enum {
     MSP_PENDING_CLI
 } mspPendingSystemRequest_e;
 
+#ifndef MSP_PORT_INBUF_SIZE
+#if defined(STM32F1) || defined(STM32F3)
 #define MSP_PORT_INBUF_SIZE 192
+#else
+#define MSP_PORT_INBUF_SIZE 512
+#endif
+#endif
 #ifdef USE_FLASHFS
 #ifdef STM32F1
 #define MSP_PORT_DATAFLASH_BUFFER_SIZE 1024
@@ -91,7 +97,29 @@ typedef struct __attribute__((packed)) {
     uint16_t size;
 } mspHeaderV2_t;
 
-#define MSP_MAX_HEADER_SIZE     9
+#define MSP_MAX_HEADER_SIZE     12  // '$', magic, direction, V1 header, JUMBO size, V2 header
+
+typedef struct mspFrameSegment_s {
+    const uint8_t *ptr;
+    uint16_t len;
+} mspFrameSegment_t;
+
+#define MSP_FRAME_SEGMENT_COUNT 3   // header, payload, checksum
+
+// MSP frame gathered from its header, payload and checksum segments. The payload is not copied
+// or walked beforehand; its checksum is accumulated while it is queued into the serial TX buffer,
+// which also lets a reply be queued piecewise as TX buffer space becomes available.
+typedef struct mspFrame_s {
+    uint8_t hdr[MSP_MAX_HEADER_SIZE];
+    uint8_t crc[2];
+    mspFrameSegment_t segments[MSP_FRAME_SEGMENT_COUNT];
+    uint16_t totalLen;      // zero when the frame is idle
+    uint16_t sent;          // bytes of the frame queued so far
+    uint8_t mspVersion;
+    uint8_t checksum1;      // MSPv1 xor checksum, header included
+    uint8_t checksum2;      // MSPv2 crc8, header included
+    timeMs_t lastProgressMs;
+} mspFrame_t;
 
 struct serialPort_s;
 typedef struct mspPort_s {
@@ -109,6 +137,8 @@ typedef struct mspPort_s {
     uint8_t checksum1;
     uint8_t checksum2;
     bool sharedWithTelemetry;
+    mspFrame_t pendingReply;
+    mspPostProcessFnPtr pendingPostProcessFn; // run once the reply has left the TX buffer
 } mspPort_t;
 
 void mspSerialInit(void);
@@ -118,4 +148,7 @@ void mspSerialAllocatePorts(void);
 void mspSerialReleasePortIfAllocated(struct serialPort_s *serialPort);
 void mspSerialReleaseSharedTelemetryPorts(void);
 int mspSerialPush(uint8_t cmd, uint8_t *data, int datalen, mspDirection_e direction);
+int mspSerialPushPort(mspPort_t *mspPort, uint8_t cmd, uint8_t *data, int datalen, mspDirection_e direction);
+mspPort_t *mspSerialFindPort(const struct serialPort_s *serialPort);
+mspPort_t *mspSerialCommandPort(void);
 uint32_t mspSerialTxBytesFree(void);
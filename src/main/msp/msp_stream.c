@@ -0,0 +1,272 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * MSP telemetry streaming.
+ *
+ * A ground station subscribes to a set of MSP out commands, each with its own rate, and the
+ * replies are pushed from a low priority task instead of being polled one request at a time.
+ * Subscriptions belong to the MSP port that requested them and are only pushed to that port.
+ * When its TX buffer cannot take another frame the rates of that port are halved (down to
+ * 1 / (1 << MSP_STREAM_MAX_BACKOFF_SHIFT)) and recover again once the link keeps up.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_MSP_STREAM
+
+#include "common/streambuf.h"
+#include "common/utils.h"
+
+#include "drivers/serial.h"
+
+#include "msp/msp_serial.h"
+#include "msp/msp_stream.h"
+
+#include "scheduler/scheduler.h"
+
+#define MSP_STREAM_REPLY_BUFFER_SIZE    128
+#define MSP_STREAM_FRAME_OVERHEAD       6       // '$', 'M', '>', size, cmd, checksum
+#define MSP_STREAM_RECOVER_US           1000000 // congestion free time before the backoff is reduced
+
+typedef struct mspStreamSubscription_s {
+    mspPort_t *mspPort;
+    timeUs_t nextDueUs;
+    timeDelta_t intervalUs;
+    uint8_t cmd;
+} mspStreamSubscription_t;
+
+// state of a port with subscriptions or a subscription request, free when mspPort is NULL
+typedef struct mspStreamPort_s {
+    mspPort_t *mspPort;
+    timeUs_t lastCongestionUs;
+    uint8_t backoffShift;
+    bool congested;         // the TX buffer was full during the current run
+    // subscriptions of the last request from this port, applied to it once the reply is sent
+    mspStreamSubscription_t requested[MSP_STREAM_MAX_SUBSCRIPTIONS];
+    uint8_t requestedCount;
+} mspStreamPort_t;
+
+static mspStreamSubscription_t subscriptions[MSP_STREAM_MAX_SUBSCRIPTIONS];
+static uint8_t subscriptionCount;
+static mspStreamPort_t streamPorts[MAX_MSP_PORT_COUNT];
+
+static uint8_t replyBuffer[MSP_STREAM_REPLY_BUFFER_SIZE];
+
+static mspStreamPort_t *mspStreamFindPort(const mspPort_t *mspPort)
+{
+    for (unsigned i = 0; i < ARRAYLEN(streamPorts); i++) {
+        if (streamPorts[i].mspPort == mspPort) {
+            return &streamPorts[i];
+        }
+    }
+    return NULL;
+}
+
+// state of the port the request being processed came in on, NULL if it did not come in on an MSP port
+static mspStreamPort_t *mspStreamRequestPort(void)
+{
+    mspPort_t *mspPort = mspSerialCommandPort();
+    if (!mspPort) {
+        return NULL;
+    }
+
+    mspStreamPort_t *streamPort = mspStreamFindPort(mspPort);
+    if (!streamPort) {
+        streamPort = mspStreamFindPort(NULL);
+        if (streamPort) {
+            streamPort->mspPort = mspPort;
+            streamPort->backoffShift = 0;
+            streamPort->congested = false;
+            streamPort->requestedCount = 0;
+        }
+    }
+    return streamPort;
+}
+
+void mspStreamRequestClear(void)
+{
+    mspStreamPort_t *streamPort = mspStreamRequestPort();
+    if (streamPort) {
+        streamPort->requestedCount = 0;
+    }
+}
+
+bool mspStreamRequestAdd(uint8_t cmd, uint8_t rateHz)
+{
+    mspStreamPort_t *streamPort = mspStreamRequestPort();
+    if (!streamPort || rateHz == 0 || rateHz > MSP_STREAM_MAX_RATE_HZ) {
+        return false;
+    }
+
+    mspStreamSubscription_t *sub = NULL;
+    for (int i = 0; i < streamPort->requestedCount; i++) {
+        if (streamPort->requested[i].cmd == cmd) {
+            sub = &streamPort->requested[i];
+            break;
+        }
+    }
+    if (!sub) {
+        if (streamPort->requestedCount >= MSP_STREAM_MAX_SUBSCRIPTIONS) {
+            return false;
+        }
+        sub = &streamPort->requested[streamPort->requestedCount++];
+    }
+
+    sub->cmd = cmd;
+    sub->intervalUs = 1000000 / rateHz;
+    sub->nextDueUs = 0;
+    return true;
+}
+
+uint8_t mspStreamRequestCount(void)
+{
+    const mspStreamPort_t *streamPort = mspStreamRequestPort();
+    return streamPort ? streamPort->requestedCount : 0;
+}
+
+static void mspStreamRemoveSubscriptions(const mspPort_t *mspPort)
+{
+    int count = 0;
+    for (int i = 0; i < subscriptionCount; i++) {
+        if (subscriptions[i].mspPort != mspPort) {
+            subscriptions[count++] = subscriptions[i];
+        }
+    }
+    subscriptionCount = count;
+
+    setTaskEnabled(TASK_MSP_STREAM, subscriptionCount > 0);
+}
+
+static void mspStreamRemovePort(const mspPort_t *mspPort)
+{
+    mspStreamRemoveSubscriptions(mspPort);
+
+    mspStreamPort_t *streamPort = mspStreamFindPort(mspPort);
+    if (streamPort) {
+        streamPort->mspPort = NULL;
+    }
+}
+
+// MSP post process function, the request replaces the subscriptions of the port it came in on.
+void mspStreamApplyRequest(serialPort_t *serialPort)
+{
+    mspPort_t *mspPort = mspSerialFindPort(serialPort);
+    if (!mspPort) {
+        return;
+    }
+    mspStreamPort_t *streamPort = mspStreamFindPort(mspPort);
+    if (!streamPort) {
+        return;
+    }
+
+    mspStreamRemoveSubscriptions(mspPort);
+    if (!streamPort->requestedCount) {
+        streamPort->mspPort = NULL;
+        return;
+    }
+    streamPort->backoffShift = 0;
+
+    for (int i = 0; i < streamPort->requestedCount && subscriptionCount < MSP_STREAM_MAX_SUBSCRIPTIONS; i++) {
+        subscriptions[subscriptionCount] = streamPort->requested[i];
+        subscriptions[subscriptionCount].mspPort = mspPort;
+        subscriptionCount++;
+    }
+    streamPort->requestedCount = 0;
+
+    setTaskEnabled(TASK_MSP_STREAM, true);
+}
+
+static bool mspStreamSend(mspStreamSubscription_t *sub, mspProcessCommandFnPtr mspProcessCommandFn)
+{
+    mspPacket_t cmd = {
+        .buf = { .ptr = replyBuffer, .end = replyBuffer, },   // no request payload
+        .cmd = sub->cmd,
+        .direction = MSP_DIRECTION_REQUEST,
+    };
+    mspPacket_t reply = {
+        .buf = { .ptr = replyBuffer, .end = ARRAYEND(replyBuffer), },
+        .cmd = -1,
+        .direction = MSP_DIRECTION_REPLY,
+    };
+    mspPostProcessFnPtr mspPostProcessFn = NULL;
+
+    if (mspProcessCommandFn(&cmd, &reply, &mspPostProcessFn) != MSP_RESULT_ACK) {
+        return true;    // nothing to send, don't treat it as congestion
+    }
+    sbufSwitchToReader(&reply.buf, replyBuffer);
+    const int len = sbufBytesRemaining(&reply.buf);
+
+    if (serialTxBytesFree(sub->mspPort->port) < (uint32_t)(len + MSP_STREAM_FRAME_OVERHEAD)) {
+        return false;
+    }
+    return mspSerialPushPort(sub->mspPort, sub->cmd, replyBuffer, len, MSP_DIRECTION_REPLY) > 0;
+}
+
+void mspStreamProcess(timeUs_t currentTimeUs, mspProcessCommandFnPtr mspProcessCommandFn)
+{
+    for (unsigned i = 0; i < ARRAYLEN(streamPorts); i++) {
+        streamPorts[i].congested = false;
+    }
+
+    for (int i = 0; i < subscriptionCount; i++) {
+        mspStreamSubscription_t *sub = &subscriptions[i];
+        mspStreamPort_t *streamPort = mspStreamFindPort(sub->mspPort);
+        if (!sub->mspPort->port || !streamPort) {
+            // the port was released, e.g. to the CLI or a passthrough
+            mspStreamRemovePort(sub->mspPort);
+            return;
+        }
+        if (cmpTimeUs(currentTimeUs, sub->nextDueUs) < 0 || streamPort->congested) {
+            continue;
+        }
+
+        const timeDelta_t intervalUs = sub->intervalUs << streamPort->backoffShift;
+        if (!mspStreamSend(sub, mspProcessCommandFn)) {
+            // TX buffer is full, slow every stream of this port down and leave its rest for the next run
+            if (streamPort->backoffShift < MSP_STREAM_MAX_BACKOFF_SHIFT) {
+                streamPort->backoffShift++;
+            }
+            streamPort->lastCongestionUs = currentTimeUs;
+            streamPort->congested = true;
+            sub->nextDueUs = currentTimeUs + (sub->intervalUs << streamPort->backoffShift);
+            continue;
+        }
+
+        // keep the requested cadence, but don't try to catch up on missed frames
+        sub->nextDueUs += intervalUs;
+        if (cmpTimeUs(sub->nextDueUs, currentTimeUs) <= 0) {
+            sub->nextDueUs = currentTimeUs + intervalUs;
+        }
+    }
+
+    for (unsigned i = 0; i < ARRAYLEN(streamPorts); i++) {
+        mspStreamPort_t *streamPort = &streamPorts[i];
+        if (streamPort->mspPort && streamPort->backoffShift && cmpTimeUs(currentTimeUs, streamPort->lastCongestionUs) >= MSP_STREAM_RECOVER_US) {
+            streamPort->backoffShift--;
+            streamPort->lastCongestionUs = currentTimeUs;
+        }
+    }
+}
+#endif
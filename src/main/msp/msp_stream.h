@@ -0,0 +1,37 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/time.h"
+
+#include "interface/msp.h"
+
+#define MSP_STREAM_MAX_SUBSCRIPTIONS    8
+#define MSP_STREAM_MAX_RATE_HZ          100
+#define MSP_STREAM_MAX_BACKOFF_SHIFT    3   // rates drop to at most 1/8 of the requested rate under congestion
+
+struct serialPort_s;
+
+void mspStreamRequestClear(void);
+bool mspStreamRequestAdd(uint8_t cmd, uint8_t rateHz);
+uint8_t mspStreamRequestCount(void);
+void mspStreamApplyRequest(struct serialPort_s *serialPort);
+void mspStreamProcess(timeUs_t currentTimeUs, mspProcessCommandFnPtr mspProcessCommandFn);
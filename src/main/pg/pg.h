@@ -24,6 +24,7 @@
 #include <stdbool.h>
 
 #include "build/build_config.h"
+#include "common/utils.h"
 
 typedef uint16_t pgn_t;
 
@@ -40,6 +41,10 @@ typedef enum {
     PGR_SIZE_SYSTEM_FLAG =  0x0000 // documentary
 } pgRegistryInternal_e;
 
+// Upper bound on the size of a single group, every registration is checked against it at build time.
+// Code that needs a scratch image of an arbitrary group sizes its buffer by it.
+#define PG_MAX_SIZE 512
+
 // function that resets a single parameter group instance
 typedef void (pgResetFunc)(void * /* base */, int /* size */);
 
@@ -114,6 +119,7 @@ extern const uint8_t __pg_resetdata_end[];
 
 // Register system config
 #define PG_REGISTER_I(_type, _name, _pgn, _version, _reset)             \
+    STATIC_ASSERT(sizeof(_type) <= PG_MAX_SIZE, _name ## _exceeds_PG_MAX_SIZE); \
     _type _name ## _System;                                             \
     _type _name ## _Copy;                                               \
     /* Force external linkage for g++. Catch multi registration */      \
@@ -144,6 +150,7 @@ extern const uint8_t __pg_resetdata_end[];
 
 // Register system config array
 #define PG_REGISTER_ARRAY_I(_type, _size, _name, _pgn, _version, _reset)  \
+    STATIC_ASSERT(sizeof(_type) * _size <= PG_MAX_SIZE, _name ## _exceeds_PG_MAX_SIZE); \
     _type _name ## _SystemArray[_size];                                 \
     _type _name ## _CopyArray[_size];                                   \
     extern const pgRegistry_t _name ##_Registry;                        \
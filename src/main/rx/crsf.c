@@ -49,6 +49,8 @@
 #include "telemetry/crsf.h"
 
 #define CRSF_TIME_NEEDED_PER_FRAME_US   1100 // 700 ms + 400 ms for potential ad-hoc request
+#define CRSF_TELEMETRY_MARGIN_US        300  // line turnaround and clock tolerance on both ends
+#define CRSF_RC_FRAME_INTERVAL_MAX_US   50000 // anything longer is a lost frame, not the frame rate
 #define CRSF_TIME_BETWEEN_FRAMES_US     6667 // At fastest, frames are sent by the transmitter every 6.667 milliseconds, 150 Hz
 
 #define CRSF_DIGITAL_CHANNEL_MIN 172
@@ -60,10 +62,25 @@ STATIC_UNIT_TESTED bool crsfFrameDone = false;
 STATIC_UNIT_TESTED crsfFrame_t crsfFrame;
 STATIC_UNIT_TESTED uint32_t crsfChannelData[CRSF_MAX_CHANNEL];
 
+// The frame buffer is filled from the serial receive interrupt while the last completed frame is
+// decoded from the PID loop or TASK_RX. The sequence counts frame starts, a decoded copy is only
+// used if no new frame started since the completed one, see crsfFrameStatus().
+static uint32_t crsfFrameSequence;
+static uint32_t crsfFrameDoneSequence;
+
 static serialPort_t *serialPort;
 static uint32_t crsfFrameStartAtUs = 0;
-static uint8_t telemetryBuf[CRSF_FRAME_SIZE_MAX];
-static uint8_t telemetryBufLen = 0;
+static uint8_t crsfFramePosition = 0;
+static uint8_t telemetryBuf[CRSF_TELEMETRY_WINDOW_SIZE];
+static uint16_t telemetryBufLen = 0;
+
+// When batching, telemetry is queued and sent once after each RC frame, in the gap before the next one.
+// The RC frame timing is recorded by the receive interrupt.
+static bool telemetryBatch = false;
+static volatile uint32_t rcFrameCount;
+static volatile uint32_t rcFrameEndUs;
+static volatile int32_t rcFrameGapUs;      // from the end of one RC frame to the start of the next
+static uint32_t telemetryWindowRcFrameCount;
 
 /*
  * CRSF protocol
@@ -114,22 +131,89 @@ struct crsfPayloadRcChannelsPacked_s {
 
 typedef struct crsfPayloadRcChannelsPacked_s crsfPayloadRcChannelsPacked_t;
 
-STATIC_UNIT_TESTED uint8_t crsfFrameCRC(void)
+static uint8_t crsfFrameCRCOf(const crsfFrame_t *frame)
 {
     // CRC includes type and payload
-    uint8_t crc = crc8_dvb_s2(0, crsfFrame.frame.type);
-    for (int ii = 0; ii < crsfFrame.frame.frameLength - CRSF_FRAME_LENGTH_TYPE_CRC; ++ii) {
-        crc = crc8_dvb_s2(crc, crsfFrame.frame.payload[ii]);
+    uint8_t crc = crc8_dvb_s2(0, frame->frame.type);
+    if (frame->frame.frameLength > CRSF_FRAME_LENGTH_TYPE_CRC) {
+        crc = crc8_dvb_s2_update(crc, frame->frame.payload, frame->frame.frameLength - CRSF_FRAME_LENGTH_TYPE_CRC);
     }
     return crc;
 }
 
+STATIC_UNIT_TESTED uint8_t crsfFrameCRC(void)
+{
+    return crsfFrameCRCOf(&crsfFrame);
+}
+
+static void crsfFrameStart(void)
+{
+    __atomic_store_n(&crsfFrameSequence, crsfFrameSequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void crsfRcFrameComplete(uint32_t currentTimeUs, int fullFrameLength)
+{
+    const uint32_t intervalUs = currentTimeUs - rcFrameEndUs;
+    if (rcFrameCount > 0 && intervalUs < CRSF_RC_FRAME_INTERVAL_MAX_US) {
+        // the next RC frame takes as long to arrive as this one did
+        rcFrameGapUs = intervalUs - fullFrameLength * 1000 / CRSF_TELEMETRY_BYTES_PER_MS;
+    }
+    rcFrameEndUs = currentTimeUs;
+    rcFrameCount++;
+}
+
+static void crsfFrameComplete(uint32_t currentTimeUs, int fullFrameLength)
+{
+    crsfFrameDoneSequence = crsfFrameSequence;
+    if (crsfFrame.frame.type == CRSF_FRAMETYPE_RC_CHANNELS_PACKED) {
+        crsfRcFrameComplete(currentTimeUs, fullFrameLength);
+    }
+    __atomic_store_n(&crsfFrameDone, true, __ATOMIC_RELEASE);
+#ifdef USE_RX_FRAME_EVENT
+    if (crsfFrame.frame.type == CRSF_FRAMETYPE_RC_CHANNELS_PACKED) {
+        rxFrameCompleteNotify(currentTimeUs);
+    }
+#else
+    UNUSED(currentTimeUs);
+#endif
+    if (crsfFrame.frame.type != CRSF_FRAMETYPE_RC_CHANNELS_PACKED) {
+        const uint8_t crc = crsfFrameCRC();
+        if (crc == crsfFrame.bytes[fullFrameLength - 1]) {
+            switch (crsfFrame.frame.type)
+            {
+#if defined(USE_TELEMETRY_CRSF) && defined(USE_MSP_OVER_TELEMETRY)
+                case CRSF_FRAMETYPE_MSP_REQ:
+                case CRSF_FRAMETYPE_MSP_WRITE: {
+                    uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + CRSF_FRAME_ORIGIN_DEST_SIZE;
+                    if (bufferCrsfMspFrame(frameStart, CRSF_FRAME_RX_MSP_FRAME_SIZE)) {
+                        crsfScheduleMspResponse();
+                    }
+                    break;
+                }
+#endif
+#if defined(USE_CRSF_CMS_TELEMETRY)
+                case CRSF_FRAMETYPE_DEVICE_PING:
+                    crsfScheduleDeviceInfoResponse();
+                    break;
+                case CRSF_FRAMETYPE_DISPLAYPORT_CMD: {
+                    uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + CRSF_FRAME_ORIGIN_DEST_SIZE;
+                    crsfProcessDisplayPortCmd(frameStart);
+                    break;
+                }
+#endif
+                default:
+                    break;
+            }
+        }
+    }
+}
+
 // Receive ISR callback, called back from serial port
 STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
 {
     UNUSED(data);
 
-    static uint8_t crsfFramePosition = 0;
     const uint32_t currentTimeUs = micros();
 
 #ifdef DEBUG_CRSF_PACKETS
@@ -144,6 +228,7 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
 
     if (crsfFramePosition == 0) {
         crsfFrameStartAtUs = currentTimeUs;
+        crsfFrameStart();
     }
     // assume frame is 5 bytes long until we have received the frame length
     // full frame length includes the length of the address and framelength fields
@@ -154,54 +239,58 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
         crsfFrameDone = crsfFramePosition < fullFrameLength ? false : true;
         if (crsfFrameDone) {
             crsfFramePosition = 0;
-            if (crsfFrame.frame.type != CRSF_FRAMETYPE_RC_CHANNELS_PACKED) {
-                const uint8_t crc = crsfFrameCRC();
-                if (crc == crsfFrame.bytes[fullFrameLength - 1]) {
-                    switch (crsfFrame.frame.type)
-                    {
-#if defined(USE_TELEMETRY_CRSF) && defined(USE_MSP_OVER_TELEMETRY)
-                        case CRSF_FRAMETYPE_MSP_REQ:
-                        case CRSF_FRAMETYPE_MSP_WRITE: {
-                            uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + CRSF_FRAME_ORIGIN_DEST_SIZE;
-                            if (bufferCrsfMspFrame(frameStart, CRSF_FRAME_RX_MSP_FRAME_SIZE)) {
-                                crsfScheduleMspResponse();
-                            }
-                            break;
-                        }
-#endif
-#if defined(USE_CRSF_CMS_TELEMETRY)
-                        case CRSF_FRAMETYPE_DEVICE_PING:
-                            crsfScheduleDeviceInfoResponse();
-                            break;
-                        case CRSF_FRAMETYPE_DISPLAYPORT_CMD: {
-                            uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + CRSF_FRAME_ORIGIN_DEST_SIZE;
-                            crsfProcessDisplayPortCmd(frameStart);
-                            break;
-                        }
-#endif
-                        default:
-                            break;
-                    }
-                }
-            }
+            crsfFrameComplete(currentTimeUs, fullFrameLength);
         }
     }
 }
 
+// Receive span callback, used when the serial port receives by DMA and hands over
+// everything that arrived before the line went idle, normally exactly one frame.
+STATIC_UNIT_TESTED void crsfDataReceiveSpan(const uint8_t *data, int len, void *callbackData)
+{
+    const uint32_t currentTimeUs = micros();
+    const bool frameStart = crsfFramePosition == 0 || currentTimeUs > crsfFrameStartAtUs + CRSF_TIME_NEEDED_PER_FRAME_US;
+
+    if (frameStart && len <= (int)sizeof(crsfFrame.bytes) && len > CRSF_FRAME_LENGTH_ADDRESS + CRSF_FRAME_LENGTH_FRAMELENGTH
+        && data[1] >= CRSF_FRAME_LENGTH_TYPE_CRC && data[1] + CRSF_FRAME_LENGTH_ADDRESS + CRSF_FRAME_LENGTH_FRAMELENGTH == len) {
+        crsfFrameStart();
+        memcpy(crsfFrame.bytes, data, len);
+        crsfFramePosition = 0;
+        crsfFrameStartAtUs = currentTimeUs;
+        crsfFrameComplete(currentTimeUs, len);
+        return;
+    }
+
+    // partial or back to back frames, resynchronise byte by byte
+    for (int i = 0; i < len; i++) {
+        crsfDataReceive(data[i], callbackData);
+    }
+}
+
 STATIC_UNIT_TESTED uint8_t crsfFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
 {
     UNUSED(rxRuntimeConfig);
 
-    if (crsfFrameDone) {
+    if (__atomic_load_n(&crsfFrameDone, __ATOMIC_ACQUIRE)) {
         crsfFrameDone = false;
-        if (crsfFrame.frame.type == CRSF_FRAMETYPE_RC_CHANNELS_PACKED) {
+
+        // The receive interrupt may already be writing the next frame into the buffer,
+        // so decode a copy and drop it if a new frame started before the copy was complete.
+        crsfFrame_t frame;
+        memcpy(&frame, &crsfFrame, sizeof(frame));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&crsfFrameSequence, __ATOMIC_RELAXED) != crsfFrameDoneSequence) {
+            return RX_FRAME_PENDING;
+        }
+
+        if (frame.frame.type == CRSF_FRAMETYPE_RC_CHANNELS_PACKED) {
             // CRC includes type and payload of each frame
-            const uint8_t crc = crsfFrameCRC();
-            if (crc != crsfFrame.frame.payload[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE]) {
+            const uint8_t crc = crsfFrameCRCOf(&frame);
+            if (crc != frame.frame.payload[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE]) {
                 return RX_FRAME_PENDING;
             }
             // unpack the RC channels
-            const crsfPayloadRcChannelsPacked_t* const rcChannels = (crsfPayloadRcChannelsPacked_t*)&crsfFrame.frame.payload;
+            const crsfPayloadRcChannelsPacked_t* const rcChannels = (crsfPayloadRcChannelsPacked_t*)&frame.frame.payload;
             crsfChannelData[0] = rcChannels->chan0;
             crsfChannelData[1] = rcChannels->chan1;
             crsfChannelData[2] = rcChannels->chan2;
@@ -238,19 +327,77 @@ STATIC_UNIT_TESTED uint16_t crsfReadRawRC(const rxRuntimeConfig_t *rxRuntimeConf
     return (0.62477120195241f * crsfChannelData[chan]) + 881;
 }
 
+void crsfRxSetTelemetryBatch(bool batch)
+{
+    telemetryBatch = batch;
+    telemetryBufLen = 0;
+}
+
+/*
+ * Without batching the frame replaces whatever wasn't sent yet. When batching, a complete telemetry
+ * frame is queued for the next telemetry window, frames that don't fit are dropped.
+ */
 void crsfRxWriteTelemetryData(const void *data, int len)
 {
-    len = MIN(len, (int)sizeof(telemetryBuf));
-    memcpy(telemetryBuf, data, len);
-    telemetryBufLen = len;
+    if (!telemetryBatch) {
+        len = MIN(len, (int)sizeof(telemetryBuf));
+        memcpy(telemetryBuf, data, len);
+        telemetryBufLen = len;
+        return;
+    }
+    if (len > crsfRxTelemetryBytesFree()) {
+        return;
+    }
+    memcpy(telemetryBuf + telemetryBufLen, data, len);
+    telemetryBufLen += len;
+}
+
+/*
+ * Room left in the next telemetry window. When batching, the window is what fits in the measured gap
+ * between two RC frames, nothing until the gap is known.
+ */
+int crsfRxTelemetryBytesFree(void)
+{
+    if (!telemetryBatch) {
+        return sizeof(telemetryBuf);
+    }
+    const int windowSize = constrain((rcFrameGapUs - CRSF_TELEMETRY_MARGIN_US) * CRSF_TELEMETRY_BYTES_PER_MS / 1000, 0, sizeof(telemetryBuf));
+    return MAX(windowSize - telemetryBufLen, 0);
 }
 
 void crsfRxSendTelemetryData(void)
 {
-    // if there is telemetry data to write
-    if (telemetryBufLen > 0) {
-        serialWriteBuf(serialPort, telemetryBuf, telemetryBufLen);
-        telemetryBufLen = 0; // reset telemetry buffer
+    if (!telemetryBatch) {
+        // if there is telemetry data to write
+        if (telemetryBufLen > 0) {
+            serialWriteBuf(serialPort, telemetryBuf, telemetryBufLen);
+            telemetryBufLen = 0; // reset telemetry buffer
+        }
+        return;
+    }
+
+    // one window after each RC frame, with what is left of the gap when this runs
+    const uint32_t frameCount = rcFrameCount;
+    if (telemetryBufLen == 0 || frameCount == telemetryWindowRcFrameCount) {
+        return;
+    }
+    telemetryWindowRcFrameCount = frameCount;
+    const int32_t timeLeftUs = rcFrameGapUs - CRSF_TELEMETRY_MARGIN_US - (int32_t)(micros() - rcFrameEndUs);
+    const int windowSize = MAX(timeLeftUs, 0) * CRSF_TELEMETRY_BYTES_PER_MS / 1000;
+
+    // whole frames only, the rest waits for the next window
+    int len = 0;
+    while (len < telemetryBufLen) {
+        const int frameLen = telemetryBuf[len + 1] + CRSF_FRAME_LENGTH_ADDRESS + CRSF_FRAME_LENGTH_FRAMELENGTH;
+        if (len + frameLen > windowSize) {
+            break;
+        }
+        len += frameLen;
+    }
+    if (len > 0) {
+        serialWriteBuf(serialPort, telemetryBuf, len);
+        telemetryBufLen -= len;
+        memmove(telemetryBuf, telemetryBuf + len, telemetryBufLen);
     }
 }
 
@@ -279,6 +426,9 @@ bool crsfRxInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
         CRSF_PORT_MODE,
         CRSF_PORT_OPTIONS | (rxConfig->serialrx_inverted ? SERIAL_INVERTED : 0)
         );
+    if (serialPort) {
+        serialSetRxSpanCallback(serialPort, crsfDataReceiveSpan);
+    }
 
     return serialPort != NULL;
 }
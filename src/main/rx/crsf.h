@@ -28,6 +28,13 @@
 
 #define CRSF_MAX_CHANNEL        16
 
+// A byte takes 10 bits, 23.8us at 420000 baud
+#define CRSF_TELEMETRY_BYTES_PER_MS (CRSF_BAUDRATE / 10 / 1000)
+
+// Upper limit for the telemetry bytes sent in one go. The window actually used is sized from the
+// measured gap between two RC frames, 6.05ms or 254 bytes at 150Hz, see crsfRxTelemetryBytesFree().
+#define CRSF_TELEMETRY_WINDOW_SIZE  (4 * CRSF_FRAME_SIZE_MAX)
+
 typedef struct crsfFrameDef_s {
     uint8_t deviceAddress;
     uint8_t frameLength;
@@ -40,7 +47,9 @@ typedef union crsfFrame_u {
     crsfFrameDef_t frame;
 } crsfFrame_t;
 
+void crsfRxSetTelemetryBatch(bool batch);
 void crsfRxWriteTelemetryData(const void *data, int len);
+int crsfRxTelemetryBytesFree(void);
 void crsfRxSendTelemetryData(void);
 
 struct rxConfig_s;
@@ -89,6 +89,7 @@ static bool rxIsInFailsafeMode = true;
 static uint8_t rxChannelCount;
 
 static timeUs_t rxNextUpdateAtUs = 0;
+static timeUs_t rxFrameTimeUs = 0;
 static uint32_t needRxSignalBefore = 0;
 static uint32_t needRxSignalMaxDelayUs;
 static uint32_t suspendRxSignalUntil = 0;
@@ -108,6 +109,15 @@ uint32_t rcInvalidPulsPeriod[MAX_SUPPORTED_RC_CHANNEL_COUNT];
 #define SKIP_RC_ON_SUSPEND_PERIOD 1500000           // 1.5 second period in usec (call frequency independent)
 #define SKIP_RC_SAMPLES_ON_RESUME  2                // flush 2 samples to drop wrong measurements (timing independent)
 
+#ifdef USE_RX_FRAME_EVENT
+// A frame event that the PID loop hasn't picked up within this time is left to TASK_RX
+#define RX_FRAME_EVENT_TIMEOUT_US  2000
+
+static volatile bool rxFrameEventPending = false;
+static volatile timeUs_t rxFrameEventTimeUs = 0;
+static bool rxFrameEventChannelsReady = false; // channels read by rxProcessFrameEvent, not yet seen by processRx
+#endif
+
 rxRuntimeConfig_t rxRuntimeConfig;
 static uint8_t rcSampleIndex = 0;
 
@@ -346,10 +356,8 @@ void resumeRxPwmPpmSignal(void)
 #endif
 }
 
-bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime)
+static bool rxUpdateCheckFrame(timeUs_t currentTimeUs)
 {
-    UNUSED(currentDeltaTime);
-
     bool signalReceived = false;
     bool useDataDrivenProcessing = true;
 
@@ -373,6 +381,11 @@ bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime)
     {
         const uint8_t frameStatus = rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig);
         if (frameStatus & RX_FRAME_COMPLETE) {
+#ifdef USE_RX_FRAME_EVENT
+            rxFrameTimeUs = rxFrameEventTimeUs ? rxFrameEventTimeUs : currentTimeUs;
+#else
+            rxFrameTimeUs = currentTimeUs;
+#endif
             rxIsInFailsafeMode = (frameStatus & RX_FRAME_FAILSAFE) != 0;
             bool rxFrameDropped = (frameStatus & RX_FRAME_DROPPED) != 0;
             signalReceived = !(rxIsInFailsafeMode || rxFrameDropped);
@@ -407,6 +420,76 @@ bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime)
     return rxDataProcessingRequired || auxiliaryProcessingRequired; // data driven or 50Hz
 }
 
+bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime)
+{
+    UNUSED(currentDeltaTime);
+
+#ifdef USE_RX_FRAME_EVENT
+    if (rxFrameEventChannelsReady) {
+        return true;
+    }
+    // leave a freshly completed frame to the PID loop, see rxProcessFrameEvent()
+    if (rxFrameEventPending && cmpTimeUs(currentTimeUs, rxFrameEventTimeUs) < RX_FRAME_EVENT_TIMEOUT_US) {
+        return rxDataProcessingRequired || auxiliaryProcessingRequired;
+    }
+    rxFrameEventPending = false;
+#endif
+
+    return rxUpdateCheckFrame(currentTimeUs);
+}
+
+#ifdef USE_RX_FRAME_EVENT
+/*
+ * Called by serial RX drivers from their receive callback once the last byte of a channel frame
+ * has arrived, frameEndUs is the arrival time of that byte.
+ */
+void rxFrameCompleteNotify(timeUs_t frameEndUs)
+{
+    rxFrameEventTimeUs = frameEndUs;
+    rxFrameEventPending = true;
+}
+
+/*
+ * Called from the PID loop. Decodes a frame signalled by rxFrameCompleteNotify() and updates
+ * rcData, so the caller can update rcCommand in the same iteration instead of waiting for TASK_RX
+ * to be scheduled. The remaining RX processing (modes, arming, RSSI) still runs in TASK_RX.
+ * Returns true if rcData was updated.
+ */
+FAST_CODE_NOINLINE bool rxProcessFrameEvent(timeUs_t currentTimeUs)
+{
+    if (!rxFrameEventPending) {
+        return false;
+    }
+    rxFrameEventPending = false;
+
+    // a previous update that TASK_RX hasn't seen yet is superseded by this one
+    const bool channelsReady = rxFrameEventChannelsReady;
+    rxFrameEventChannelsReady = false;
+    if (!rxUpdateCheckFrame(currentTimeUs) || !calculateRxChannelsAndUpdateFailsafe(currentTimeUs)) {
+        rxFrameEventChannelsReady = channelsReady;
+        return false;
+    }
+    rxFrameEventChannelsReady = true;
+    DEBUG_SET(DEBUG_RX_LATENCY, 3, currentTimeUs - rxFrameTimeUs);
+
+    return true;
+}
+
+// Returns true (once) when the last rcData update came through rxProcessFrameEvent()
+bool rxFrameEventConsume(void)
+{
+    const bool ready = rxFrameEventChannelsReady;
+    rxFrameEventChannelsReady = false;
+    return ready;
+}
+#endif
+
+// Arrival time of the last complete RX frame
+timeUs_t rxGetFrameTimeUs(void)
+{
+    return rxFrameTimeUs;
+}
+
 #if defined(USE_PWM) || defined(USE_PPM)
 static uint16_t calculateChannelMovingAverage(uint8_t chan, uint16_t sample)
 {
@@ -548,6 +631,13 @@ static void detectAndApplySignalLossBehaviour(void)
 
 bool calculateRxChannelsAndUpdateFailsafe(timeUs_t currentTimeUs)
 {
+#ifdef USE_RX_FRAME_EVENT
+    if (rxFrameEventChannelsReady) {
+        // rcData was already updated from the PID loop
+        return true;
+    }
+#endif
+
     if (auxiliaryProcessingRequired) {
         auxiliaryProcessingRequired = !rxRuntimeConfig.rcProcessFrameFn(&rxRuntimeConfig);
     }
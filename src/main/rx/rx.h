@@ -153,6 +153,10 @@ bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs);
 bool rxIsReceivingSignal(void);
 bool rxAreFlightChannelsValid(void);
 bool calculateRxChannelsAndUpdateFailsafe(timeUs_t currentTimeUs);
+void rxFrameCompleteNotify(timeUs_t frameEndUs);
+bool rxProcessFrameEvent(timeUs_t currentTimeUs);
+bool rxFrameEventConsume(void);
+timeUs_t rxGetFrameTimeUs(void);
 
 struct rxConfig_s;
 
@@ -21,6 +21,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -99,14 +100,30 @@ typedef union sbusFrame_u {
     struct sbusFrame_s frame;
 } sbusFrame_t;
 
+// The frame is filled from the serial receive interrupt and decoded from the PID loop or TASK_RX,
+// sequence counts frame starts so that a decode overtaken by the next frame can be dropped.
 typedef struct sbusFrameData_s {
     sbusFrame_t frame;
     uint32_t startAtUs;
+    uint32_t sequence;
+    uint32_t doneSequence;
     uint16_t stateFlags;
     uint8_t position;
     bool done;
 } sbusFrameData_t;
 
+static void sbusFrameStart(sbusFrameData_t *sbusFrameData)
+{
+    __atomic_store_n(&sbusFrameData->sequence, sbusFrameData->sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void sbusFrameComplete(sbusFrameData_t *sbusFrameData)
+{
+    sbusFrameData->doneSequence = sbusFrameData->sequence;
+    __atomic_store_n(&sbusFrameData->done, true, __ATOMIC_RELEASE);
+}
+
 
 // Receive ISR callback
 static void sbusDataReceive(uint16_t c, void *data)
@@ -126,6 +143,7 @@ static void sbusDataReceive(uint16_t c, void *data)
             return;
         }
         sbusFrameData->startAtUs = nowUs;
+        sbusFrameStart(sbusFrameData);
     }
 
     if (sbusFrameData->position < SBUS_FRAME_SIZE) {
@@ -133,34 +151,70 @@ static void sbusDataReceive(uint16_t c, void *data)
         if (sbusFrameData->position < SBUS_FRAME_SIZE) {
             sbusFrameData->done = false;
         } else {
-            sbusFrameData->done = true;
+            sbusFrameComplete(sbusFrameData);
             DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_FRAME_TIME, sbusFrameTime);
+#ifdef USE_RX_FRAME_EVENT
+            rxFrameCompleteNotify(nowUs);
+#endif
         }
     }
 }
 
+// Receive span callback, used when the serial port receives by DMA and hands over
+// everything that arrived before the line went idle, normally exactly one frame.
+static void sbusDataReceiveSpan(const uint8_t *data, int len, void *callbackData)
+{
+    sbusFrameData_t *sbusFrameData = callbackData;
+
+    if (len == SBUS_FRAME_SIZE && data[0] == SBUS_FRAME_BEGIN_BYTE) {
+        const uint32_t nowUs = micros();
+
+        sbusFrameStart(sbusFrameData);
+        memcpy(sbusFrameData->frame.bytes, data, SBUS_FRAME_SIZE);
+        sbusFrameData->position = 0;
+        sbusFrameData->startAtUs = nowUs;
+        sbusFrameComplete(sbusFrameData);
+#ifdef USE_RX_FRAME_EVENT
+        rxFrameCompleteNotify(nowUs);
+#endif
+        return;
+    }
+
+    for (int i = 0; i < len; i++) {
+        sbusDataReceive(data[i], callbackData);
+    }
+}
+
 static uint8_t sbusFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
 {
     sbusFrameData_t *sbusFrameData = rxRuntimeConfig->frameData;
-    if (!sbusFrameData->done) {
+    if (!__atomic_load_n(&sbusFrameData->done, __ATOMIC_ACQUIRE)) {
         return RX_FRAME_PENDING;
     }
     sbusFrameData->done = false;
 
-    DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_FRAME_FLAGS, sbusFrameData->frame.frame.channels.flags);
+    // decode a copy, unless the next frame started to overwrite the buffer while it was taken
+    sbusChannels_t channels;
+    memcpy(&channels, &sbusFrameData->frame.frame.channels, sizeof(channels));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&sbusFrameData->sequence, __ATOMIC_RELAXED) != sbusFrameData->doneSequence) {
+        return RX_FRAME_PENDING;
+    }
 
-    if (sbusFrameData->frame.frame.channels.flags & SBUS_FLAG_SIGNAL_LOSS) {
+    DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_FRAME_FLAGS, channels.flags);
+
+    if (channels.flags & SBUS_FLAG_SIGNAL_LOSS) {
         sbusFrameData->stateFlags |= SBUS_STATE_SIGNALLOSS;
         DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_STATE_FLAGS, sbusFrameData->stateFlags);
     }
-    if (sbusFrameData->frame.frame.channels.flags & SBUS_FLAG_FAILSAFE_ACTIVE) {
+    if (channels.flags & SBUS_FLAG_FAILSAFE_ACTIVE) {
         sbusFrameData->stateFlags |= SBUS_STATE_FAILSAFE;
         DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_STATE_FLAGS, sbusFrameData->stateFlags);
     }
 
     DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_STATE_FLAGS, sbusFrameData->stateFlags);
 
-    return sbusChannelsDecode(rxRuntimeConfig, &sbusFrameData->frame.frame.channels);
+    return sbusChannelsDecode(rxRuntimeConfig, &channels);
 }
 
 bool sbusInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
@@ -196,6 +250,9 @@ bool sbusInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
         portShared ? MODE_RXTX : MODE_RX,
         SBUS_PORT_OPTIONS | (rxConfig->serialrx_inverted ? 0 : SERIAL_INVERTED) | (rxConfig->halfDuplex ? SERIAL_BIDIR : 0)
         );
+    if (sBusPort) {
+        serialSetRxSpanCallback(sBusPort, sbusDataReceiveSpan);
+    }
 
     if (rxConfig->rssi_src_frame_errors) {
         rssiSource = RSSI_SOURCE_FRAME_ERRORS;
@@ -136,6 +136,10 @@ typedef enum {
     TASK_PINIOBOX,
 #endif
 
+#ifdef USE_MSP_STREAM
+    TASK_MSP_STREAM,
+#endif
+
     /* Count of real tasks */
     TASK_COUNT,
 
@@ -24,6 +24,7 @@
 
 #include "platform.h"
 
+#include "common/filter.h"
 #include "common/maths.h"
 
 #include "pg/pg.h"
@@ -146,6 +147,11 @@ static int32_t baroGroundAltitude = 0;
 static int32_t baroGroundPressure = 8*101325;
 static uint32_t baroPressureSum = 0;
 
+#define PRESSURE_SAMPLES_MEDIAN 3
+
+static medianFilter_t baroMedianFilter;
+static float baroMedianFilterBuffer[MEDIAN_FILTER_BUFFER_SIZE(PRESSURE_SAMPLES_MEDIAN)];
+
 bool baroDetect(baroDev_t *dev, baroSensor_e baroHardwareToUse)
 {
     // Detect what pressure sensors are available. baro->update() is set to sensor-specific update function
@@ -246,6 +252,8 @@ bool baroDetect(baroDev_t *dev, baroSensor_e baroHardwareToUse)
         return false;
     }
 
+    medianFilterInit(&baroMedianFilter, PRESSURE_SAMPLES_MEDIAN, baroMedianFilterBuffer);
+
     detectedSensors[SENSOR_INDEX_BARO] = baroHardware;
     sensorsSet(SENSOR_BARO);
     return true;
@@ -263,26 +271,13 @@ void baroSetCalibrationCycles(uint16_t calibrationCyclesRequired)
 
 static bool baroReady = false;
 
-#define PRESSURE_SAMPLES_MEDIAN 3
-
 static int32_t applyBarometerMedianFilter(int32_t newPressureReading)
 {
-    static int32_t barometerFilterSamples[PRESSURE_SAMPLES_MEDIAN];
-    static int currentFilterSampleIndex = 0;
-    static bool medianFilterReady = false;
-    int nextSampleIndex;
-
-    nextSampleIndex = (currentFilterSampleIndex + 1);
-    if (nextSampleIndex == PRESSURE_SAMPLES_MEDIAN) {
-        nextSampleIndex = 0;
-        medianFilterReady = true;
-    }
-
-    barometerFilterSamples[currentFilterSampleIndex] = newPressureReading;
-    currentFilterSampleIndex = nextSampleIndex;
+    // pressure in Pa is exact in a float
+    const int32_t median = lrintf(medianFilterApply(&baroMedianFilter, newPressureReading));
 
-    if (medianFilterReady)
-        return quickMedianFilter3(barometerFilterSamples);
+    if (baroMedianFilter.count == PRESSURE_SAMPLES_MEDIAN)
+        return median;
     else
         return newPressureReading;
 }
@@ -74,6 +74,8 @@
 #include "fc/config.h"
 #include "fc/runtime_config.h"
 
+#include "flight/rpm_filter.h"
+
 #include "io/beeper.h"
 #include "io/statusindicator.h"
 
@@ -81,6 +83,8 @@
 
 #include "sensors/boardalignment.h"
 #include "sensors/gyro.h"
+#include "sensors/gyro_bias.h"
+#include "sensors/gyro_combine.h"
 #ifdef USE_GYRO_DATA_ANALYSE
 #include "sensors/gyroanalyse.h"
 #endif
@@ -102,6 +106,9 @@ FAST_RAM_ZERO_INIT gyro_t gyro;
 static FAST_RAM_ZERO_INIT uint8_t gyroDebugMode;
 
 static uint8_t gyroToUse = 0;
+#if defined(USE_DUAL_GYRO) && !defined(USE_GYRO_IMUF9001)
+static FAST_RAM_ZERO_INIT bool gyroFilterCombined;    // both gyros are filtered once, after combining them
+#endif
 static FAST_RAM_ZERO_INIT bool overflowDetected;
 
 #ifdef USE_GYRO_OVERFLOW_CHECK
@@ -125,6 +132,9 @@ static FAST_RAM_ZERO_INIT int16_t gyroSensorTemperature;
 
 static bool gyroHasOverflowProtection = true;
 
+// arming takes the background gyro bias estimate instead of calibrating if it is at most this old
+#define GYRO_BIAS_MAX_AGE_US    10000000
+
 typedef struct gyroCalibration_s {
     float sum[XYZ_AXIS_COUNT];
     stdev_t var[XYZ_AXIS_COUNT];
@@ -142,6 +152,12 @@ typedef union gyroLowpassFilter_u {
 typedef struct gyroSensor_s {
     gyroDev_t gyroDev;
     gyroCalibration_t calibration;
+#ifndef USE_GYRO_IMUF9001
+    gyroBias_t bias;
+#ifdef USE_DUAL_GYRO
+    gyroNoise_t noise;
+#endif
+#endif
 
     // lowpass gyro soft filter
     filterApplyFnPtr lowpassFilterApplyFn;
@@ -161,6 +177,10 @@ typedef struct gyroSensor_s {
     filterApplyFnPtr notchFilterDynApplyFn;
     biquadFilter_t notchFilterDyn[XYZ_AXIS_COUNT];
 
+#ifdef USE_RPM_FILTER
+    uint8_t rpmFilterIndex;     // which set of rpm notch states this sensor runs through
+#endif
+
     // overflow and recovery
     timeUs_t overflowTimeUs;
     bool overflowDetected;
@@ -203,7 +223,7 @@ static void gyroInitLowpassFilterLpf(gyroSensor_t *gyroSensor, int slot, int typ
 #define GYRO_OVERFLOW_TRIGGER_THRESHOLD 31980  // 97.5% full scale (1950dps for 2000dps gyro)
 #define GYRO_OVERFLOW_RESET_THRESHOLD 30340    // 92.5% full scale (1850dps for 2000dps gyro)
 
-PG_REGISTER_WITH_RESET_TEMPLATE(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 4);
+PG_REGISTER_WITH_RESET_TEMPLATE(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 5);
 
 #ifndef GYRO_CONFIG_USE_GYRO_DEFAULT
 #define GYRO_CONFIG_USE_GYRO_DEFAULT GYRO_CONFIG_USE_GYRO_1
@@ -224,6 +244,7 @@ PG_RESET_TEMPLATE(gyroConfig_t, gyroConfig,
     .gyro_high_fsr = false,
     .gyro_use_32khz = true,
     .gyro_to_use = GYRO_CONFIG_USE_GYRO_DEFAULT,
+    .gyro_combine = GYRO_COMBINE_AVERAGE,
     .gyro_soft_notch_hz_1 = 0,
     .gyro_soft_notch_cutoff_1 = 0,
     .gyro_soft_notch_hz_2 = 0,
@@ -258,6 +279,7 @@ PG_RESET_TEMPLATE(gyroConfig_t, gyroConfig,
     .gyro_high_fsr = false,
     .gyro_use_32khz = false,
     .gyro_to_use = GYRO_CONFIG_USE_GYRO_DEFAULT,
+    .gyro_combine = GYRO_COMBINE_AVERAGE,
     .gyro_soft_notch_hz_1 = 0,
     .gyro_soft_notch_cutoff_1 = 0,
     .gyro_soft_notch_hz_2 = 0,
@@ -548,6 +570,12 @@ static bool gyroInitSensor(gyroSensor_t *gyroSensor)
     gyroSensor->gyroDev.hardware_lpf = gyroConfig()->gyro_hardware_lpf;
     gyroSensor->gyroDev.hardware_32khz_lpf = gyroConfig()->gyro_32khz_hardware_lpf;
     gyroSensor->gyroDev.initFn(&gyroSensor->gyroDev);
+#ifndef USE_GYRO_IMUF9001
+    gyroBiasInit(&gyroSensor->bias, gyro.targetLooptime, gyroConfig()->gyroCalibrationDuration * 10000, gyroConfig()->gyroMovementCalibrationThreshold);
+#ifdef USE_DUAL_GYRO
+    gyroNoiseInit(&gyroSensor->noise, gyro.targetLooptime);
+#endif
+#endif
 
 
 #ifndef USE_GYRO_IMUF9001
@@ -685,6 +713,9 @@ bool gyroInit(void)
 #endif
     gyroSensor2.gyroDev.bus.bustype = BUSTYPE_SPI;
     spiBusSetInstance(&gyroSensor2.gyroDev.bus, GYRO_2_SPI_INSTANCE);
+#ifdef USE_RPM_FILTER
+    gyroSensor2.rpmFilterIndex = 1;
+#endif
     if (gyroToUse == GYRO_CONFIG_USE_GYRO_2 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
         ret = gyroInitSensor(&gyroSensor2);
         if (!ret) {
@@ -706,6 +737,9 @@ bool gyroInit(void)
 
         }
     }
+#ifndef USE_GYRO_IMUF9001
+    gyroFilterCombined = gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH && gyroConfig()->gyro_combine == GYRO_COMBINE_NOISE_WEIGHTED;
+#endif
 #endif // USE_DUAL_GYRO
     return ret;
 }
@@ -925,8 +959,64 @@ static void gyroSetCalibrationCycles(gyroSensor_t *gyroSensor)
     gyroSensor->calibration.cyclesRemaining = gyroCalculateCalibratingCycles();
 }
 
+#ifndef USE_GYRO_IMUF9001
+static void gyroSetZeroFromBias(gyroSensor_t *gyroSensor)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyroSensor->gyroDev.gyroZero[axis] = gyroSensor->bias.zero[axis];
+    }
+    gyroSensor->gyroDev.gyroZero[Z] -= ((float)gyroConfig()->gyro_offset_yaw / 100);
+
+    static quaternion vStdDev = VECTOR_INITIALIZE;
+    vStdDev.x = gyroSensor->bias.stdDev[X];
+    vStdDev.y = gyroSensor->bias.stdDev[Y];
+    vStdDev.z = gyroSensor->bias.stdDev[Z];
+    vGyroStdDevModulus = quaternionModulus(&vStdDev) / 1000.0f;
+}
+
+/*
+ * Takes the gyro offsets from the background estimator instead of running a calibration, if every
+ * gyro in use was still for a whole window not long ago.
+ */
+static bool gyroApplyBiasEstimate(void)
+{
+    const timeUs_t currentTimeUs = micros();
+
+#ifdef USE_DUAL_GYRO
+    const bool useGyro1 = gyroToUse != GYRO_CONFIG_USE_GYRO_2;
+    const bool useGyro2 = gyroToUse != GYRO_CONFIG_USE_GYRO_1;
+    if ((useGyro1 && !gyroBiasIsFresh(&gyroSensor1.bias, currentTimeUs, GYRO_BIAS_MAX_AGE_US))
+        || (useGyro2 && !gyroBiasIsFresh(&gyroSensor2.bias, currentTimeUs, GYRO_BIAS_MAX_AGE_US))) {
+        return false;
+    }
+    if (useGyro1) {
+        gyroSetZeroFromBias(&gyroSensor1);
+    }
+    if (useGyro2) {
+        gyroSetZeroFromBias(&gyroSensor2);
+    }
+#else
+    if (!gyroBiasIsFresh(&gyroSensor1.bias, currentTimeUs, GYRO_BIAS_MAX_AGE_US)) {
+        return false;
+    }
+    gyroSetZeroFromBias(&gyroSensor1);
+#endif
+
+    beeper(BEEPER_GYRO_CALIBRATED);
+    return true;
+}
+#endif
+
 void gyroStartCalibration(bool isFirstArmingCalibration)
 {
+#ifndef USE_GYRO_IMUF9001
+    // arming doesn't have to wait for a calibration if the background estimate is recent
+    if (isFirstArmingCalibration && !firstArmingCalibrationWasStarted && gyroApplyBiasEstimate()) {
+        firstArmingCalibrationWasStarted = true;
+        return;
+    }
+#endif
+
     if (!(isFirstArmingCalibration && firstArmingCalibrationWasStarted)) {
         gyroSetCalibrationCycles(&gyroSensor1);
 #ifdef USE_DUAL_GYRO
@@ -1119,9 +1209,25 @@ static FAST_CODE void checkForYawSpin(gyroSensor_t *gyroSensor, timeUs_t current
 #include "gyro_filter_impl.h"
 #undef GYRO_FILTER_FUNCTION_NAME
 #undef GYRO_FILTER_DEBUG_SET
+
+static FAST_CODE void gyroFilterSensor(gyroSensor_t *gyroSensor)
+{
+    if (gyroDebugMode == DEBUG_NONE) {
+        filterGyro(gyroSensor);
+    } else {
+        filterGyroDebug(gyroSensor);
+    }
+
+#ifdef USE_GYRO_DATA_ANALYSE
+    if (isDynamicFilterActive()) {
+        gyroDataAnalyse(&gyroSensor->gyroAnalyseState, gyroSensor->notchFilterDyn);
+    }
+#endif
+}
 #endif
 
-static FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t* gyroSensor, timeUs_t currentTimeUs)
+// with filter false the sensor is left with its unfiltered rate, to be filtered after combining it with the other gyro
+static FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t* gyroSensor, timeUs_t currentTimeUs, bool filter)
 {
     #ifndef USE_DMA_SPI_DEVICE
         if (!gyroSensor->gyroDev.readFn(&gyroSensor->gyroDev)) {
@@ -1153,6 +1259,16 @@ static FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t* gyroSensor, timeUs
     }
 #else
     if (isGyroSensorCalibrationComplete(gyroSensor)) {
+        if (ARMING_FLAG(ARMED)) {
+            gyroBiasRestart(&gyroSensor->bias);
+        } else {
+            // gyroDev_t is packed, take the samples out before handing them over
+            const int16_t gyroADCRaw[XYZ_AXIS_COUNT] = {
+                gyroSensor->gyroDev.gyroADCRaw[X], gyroSensor->gyroDev.gyroADCRaw[Y], gyroSensor->gyroDev.gyroADCRaw[Z]
+            };
+            gyroBiasPush(&gyroSensor->bias, gyroADCRaw, currentTimeUs);
+        }
+
         // move 16-bit gyro data into 32-bit variables to avoid overflows in calculations
 
 #if defined(USE_GYRO_SLEW_LIMITER)
@@ -1174,12 +1290,22 @@ static FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t* gyroSensor, timeUs
 #endif
 
 #ifndef USE_GYRO_IMUF9001
+    // scale gyro output to degrees per second
+    gyroSensor->gyroDev.gyroADCf[X] = gyroSensor->gyroDev.gyroADC[X] * gyroSensor->gyroDev.scale;
+    gyroSensor->gyroDev.gyroADCf[Y] = gyroSensor->gyroDev.gyroADC[Y] * gyroSensor->gyroDev.scale;
+    gyroSensor->gyroDev.gyroADCf[Z] = gyroSensor->gyroDev.gyroADC[Z] * gyroSensor->gyroDev.scale;
 
-    if (gyroDebugMode == DEBUG_NONE) {
-        filterGyro(gyroSensor);
-    } else {
-        filterGyroDebug(gyroSensor);
+    if (filter) {
+        gyroFilterSensor(gyroSensor);
+    }
+#else
+    UNUSED(filter);
+#ifdef USE_RPM_FILTER
+    // IMU-F does all other filtering, only the motor notches run here
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyroSensor->gyroDev.gyroADCf[axis] = rpmFilterGyro(gyroSensor->rpmFilterIndex, axis, gyroSensor->gyroDev.gyroADCf[axis]);
     }
+#endif
 #endif // USE_GYRO_IMUF9001
 
 
@@ -1195,14 +1321,6 @@ static FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t* gyroSensor, timeUs
     }
 #endif
 
-#ifndef USE_GYRO_IMUF9001
-#ifdef USE_GYRO_DATA_ANALYSE
-    if (isDynamicFilterActive()) {
-        gyroDataAnalyse(&gyroSensor->gyroAnalyseState, gyroSensor->notchFilterDyn);
-    }
-#endif
-#endif //USE_GYRO_IMUF9001
-
 
 #if (!defined(USE_GYRO_OVERFLOW_CHECK) && !defined(USE_YAW_SPIN_RECOVERY))
     UNUSED(currentTimeUs);
@@ -1224,6 +1342,35 @@ FAST_CODE_NOINLINE void gyroDmaSpiStartRead(void)
 }
 #endif
 
+#if defined(USE_DUAL_GYRO) && !defined(USE_GYRO_IMUF9001)
+/*
+ * Combines the unfiltered rates of both gyros, each weighted by its live noise, and runs the result
+ * once through the filters of the first gyro. This halves the filtering cost of using both gyros,
+ * the filters of the second gyro are left idle.
+ */
+static FAST_CODE void gyroCombineNoiseWeighted(void)
+{
+    gyroNoiseUpdate(&gyroSensor1.noise, gyroSensor1.gyroDev.gyroADCf);
+    gyroNoiseUpdate(&gyroSensor2.noise, gyroSensor2.gyroDev.gyroADCf);
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float weight = gyroCombineWeight(gyroNoiseVariance(&gyroSensor1.noise, axis), gyroNoiseVariance(&gyroSensor2.noise, axis));
+        gyroSensor1.gyroDev.gyroADCf[axis] = weight * gyroSensor1.gyroDev.gyroADCf[axis] + (1.0f - weight) * gyroSensor2.gyroDev.gyroADCf[axis];
+        if (axis == X) {
+            DEBUG_SET(DEBUG_DUAL_GYRO_COMBINE, 0, lrintf(weight * 1000));   // share of the first gyro in roll, per mille
+        } else if (axis == Y) {
+            DEBUG_SET(DEBUG_DUAL_GYRO_COMBINE, 3, lrintf(weight * 1000));
+        }
+    }
+
+    gyroFilterSensor(&gyroSensor1);
+
+    gyro.gyroADCf[X] = gyroSensor1.gyroDev.gyroADCf[X];
+    gyro.gyroADCf[Y] = gyroSensor1.gyroDev.gyroADCf[Y];
+    gyro.gyroADCf[Z] = gyroSensor1.gyroDev.gyroADCf[Z];
+}
+#endif
+
 FAST_CODE_NOINLINE void gyroUpdate(timeUs_t currentTimeUs)
 {
     const timeDelta_t sampleDeltaUs = currentTimeUs - accumulationLastTimeSampledUs;
@@ -1233,7 +1380,7 @@ FAST_CODE_NOINLINE void gyroUpdate(timeUs_t currentTimeUs)
 #ifdef USE_DUAL_GYRO
     switch (gyroToUse) {
     case GYRO_CONFIG_USE_GYRO_1:
-        gyroUpdateSensor(&gyroSensor1, currentTimeUs);
+        gyroUpdateSensor(&gyroSensor1, currentTimeUs, true);
         if (isGyroSensorCalibrationComplete(&gyroSensor1)) {
             gyro.gyroADCf[X] = gyroSensor1.gyroDev.gyroADCf[X];
             gyro.gyroADCf[Y] = gyroSensor1.gyroDev.gyroADCf[Y];
@@ -1253,7 +1400,7 @@ FAST_CODE_NOINLINE void gyroUpdate(timeUs_t currentTimeUs)
         DEBUG_SET(DEBUG_DUAL_GYRO_COMBINE, 1, lrintf(gyro.gyroADCf[Y]));
         break;
     case GYRO_CONFIG_USE_GYRO_2:
-        gyroUpdateSensor(&gyroSensor2, currentTimeUs);
+        gyroUpdateSensor(&gyroSensor2, currentTimeUs, true);
         if (isGyroSensorCalibrationComplete(&gyroSensor2)) {
             gyro.gyroADCf[X] = gyroSensor2.gyroDev.gyroADCf[X];
             gyro.gyroADCf[Y] = gyroSensor2.gyroDev.gyroADCf[Y];
@@ -1272,21 +1419,16 @@ FAST_CODE_NOINLINE void gyroUpdate(timeUs_t currentTimeUs)
         DEBUG_SET(DEBUG_DUAL_GYRO_COMBINE, 2, lrintf(gyro.gyroADCf[X]));
         DEBUG_SET(DEBUG_DUAL_GYRO_COMBINE, 3, lrintf(gyro.gyroADCf[Y]));
         break;
-    case GYRO_CONFIG_USE_GYRO_BOTH:
-        gyroUpdateSensor(&gyroSensor1, currentTimeUs);
-        gyroUpdateSensor(&gyroSensor2, currentTimeUs);
-        if (isGyroSensorCalibrationComplete(&gyroSensor1) && isGyroSensorCalibrationComplete(&gyroSensor2)) {
-            gyro.gyroADCf[X] = (gyroSensor1.gyroDev.gyroADCf[X] + gyroSensor2.gyroDev.gyroADCf[X]) * 0.5f;
-            gyro.gyroADCf[Y] = (gyroSensor1.gyroDev.gyroADCf[Y] + gyroSensor2.gyroDev.gyroADCf[Y]) * 0.5f;
-            gyro.gyroADCf[Z] = (gyroSensor1.gyroDev.gyroADCf[Z] + gyroSensor2.gyroDev.gyroADCf[Z]) * 0.5f;
-#ifdef USE_GYRO_OVERFLOW_CHECK
-            overflowDetected = gyroSensor1.overflowDetected || gyroSensor2.overflowDetected;
-#endif
-#ifdef USE_YAW_SPIN_RECOVERY
-            yawSpinDetected = gyroSensor1.yawSpinDetected || gyroSensor2.yawSpinDetected;
+    case GYRO_CONFIG_USE_GYRO_BOTH: {
+#ifdef USE_GYRO_IMUF9001
+        const bool filterEach = true;
+#else
+        const bool filterEach = !gyroFilterCombined;
 #endif
-        }
+        gyroUpdateSensor(&gyroSensor1, currentTimeUs, filterEach);
+        gyroUpdateSensor(&gyroSensor2, currentTimeUs, filterEach);
 
+        // before combining, the first gyro is overwritten with the combined rate when filtering once
         DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 0, gyroSensor1.gyroDev.gyroADCRaw[X]);
         DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 1, gyroSensor1.gyroDev.gyroADCRaw[Y]);
         DEBUG_SET(DEBUG_DUAL_GYRO, 0, lrintf(gyroSensor1.gyroDev.gyroADCf[X]));
@@ -1295,15 +1437,36 @@ FAST_CODE_NOINLINE void gyroUpdate(timeUs_t currentTimeUs)
         DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 3, gyroSensor2.gyroDev.gyroADCRaw[Y]);
         DEBUG_SET(DEBUG_DUAL_GYRO, 2, lrintf(gyroSensor2.gyroDev.gyroADCf[X]));
         DEBUG_SET(DEBUG_DUAL_GYRO, 3, lrintf(gyroSensor2.gyroDev.gyroADCf[Y]));
-        DEBUG_SET(DEBUG_DUAL_GYRO_COMBINE, 1, lrintf(gyro.gyroADCf[X]));
-        DEBUG_SET(DEBUG_DUAL_GYRO_COMBINE, 2, lrintf(gyro.gyroADCf[Y]));
         DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 0, lrintf(gyroSensor1.gyroDev.gyroADCf[X] - gyroSensor2.gyroDev.gyroADCf[X]));
         DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 1, lrintf(gyroSensor1.gyroDev.gyroADCf[Y] - gyroSensor2.gyroDev.gyroADCf[Y]));
         DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 2, lrintf(gyroSensor1.gyroDev.gyroADCf[Z] - gyroSensor2.gyroDev.gyroADCf[Z]));
+
+        if (isGyroSensorCalibrationComplete(&gyroSensor1) && isGyroSensorCalibrationComplete(&gyroSensor2)) {
+            if (filterEach) {
+                gyro.gyroADCf[X] = (gyroSensor1.gyroDev.gyroADCf[X] + gyroSensor2.gyroDev.gyroADCf[X]) * 0.5f;
+                gyro.gyroADCf[Y] = (gyroSensor1.gyroDev.gyroADCf[Y] + gyroSensor2.gyroDev.gyroADCf[Y]) * 0.5f;
+                gyro.gyroADCf[Z] = (gyroSensor1.gyroDev.gyroADCf[Z] + gyroSensor2.gyroDev.gyroADCf[Z]) * 0.5f;
+            }
+#ifndef USE_GYRO_IMUF9001
+            else {
+                gyroCombineNoiseWeighted();
+            }
+#endif
+#ifdef USE_GYRO_OVERFLOW_CHECK
+            overflowDetected = gyroSensor1.overflowDetected || gyroSensor2.overflowDetected;
+#endif
+#ifdef USE_YAW_SPIN_RECOVERY
+            yawSpinDetected = gyroSensor1.yawSpinDetected || gyroSensor2.yawSpinDetected;
+#endif
+        }
+
+        DEBUG_SET(DEBUG_DUAL_GYRO_COMBINE, 1, lrintf(gyro.gyroADCf[X]));
+        DEBUG_SET(DEBUG_DUAL_GYRO_COMBINE, 2, lrintf(gyro.gyroADCf[Y]));
         break;
     }
+    }
 #else
-    gyroUpdateSensor(&gyroSensor1, currentTimeUs);
+    gyroUpdateSensor(&gyroSensor1, currentTimeUs, true);
     gyro.gyroADCf[X] = gyroSensor1.gyroDev.gyroADCf[X];
     gyro.gyroADCf[Y] = gyroSensor1.gyroDev.gyroADCf[Y];
     gyro.gyroADCf[Z] = gyroSensor1.gyroDev.gyroADCf[Z];
@@ -1375,18 +1538,19 @@ int16_t gyroGetTemperature(void)
     return gyroSensorTemperature;
 }
 
-int16_t gyroRateDps(int axis)
+// converts a rate in deg/s back to the sensor units of the gyro in use
+int16_t gyroRateToRaw(float rateDps)
 {
 #ifdef USE_DUAL_GYRO
     if (gyroToUse == GYRO_CONFIG_USE_GYRO_2) {
-        return lrintf(gyro.gyroADCf[axis] / gyroSensor2.gyroDev.scale);
+        return lrintf(rateDps / gyroSensor2.gyroDev.scale);
     } else {
-        return lrintf(gyro.gyroADCf[axis] / gyroSensor1.gyroDev.scale);
+        return lrintf(rateDps / gyroSensor1.gyroDev.scale);
     }
 #elif defined(USE_GYRO_IMUF9001)
-    return lrintf(gyro.gyroADCf[axis]);
+    return lrintf(rateDps);
 #else
-    return lrintf(gyro.gyroADCf[axis] / gyroSensor1.gyroDev.scale);
+    return lrintf(rateDps / gyroSensor1.gyroDev.scale);
 #endif
 }
 
@@ -65,6 +65,12 @@ typedef enum {
 #define GYRO_CONFIG_USE_GYRO_2      1
 #define GYRO_CONFIG_USE_GYRO_BOTH   2
 
+// how the two gyros are combined when both are used
+typedef enum {
+    GYRO_COMBINE_AVERAGE = 0,       // filter each gyro, then average
+    GYRO_COMBINE_NOISE_WEIGHTED     // weight each gyro by its noise, then filter once
+} gyroCombine_e;
+
 typedef enum {
     FILTER_LOWPASS = 0,
     FILTER_LOWPASS2
@@ -90,6 +96,7 @@ typedef struct gyroConfig_s {
     uint8_t  gyro_high_fsr;
     uint8_t  gyro_use_32khz;
     uint8_t  gyro_to_use;
+    uint8_t  gyro_combine;
 
     uint16_t gyro_lowpass_hz;
     uint16_t gyro_lowpass2_hz;
@@ -150,7 +157,7 @@ bool isFirstArmingGyroCalibrationRunning(void);
 bool isGyroCalibrationComplete(void);
 void gyroReadTemperature(void);
 int16_t gyroGetTemperature(void);
-int16_t gyroRateDps(int axis);
+int16_t gyroRateToRaw(float rateDps);
 bool gyroOverflowDetected(void);
 bool gyroYawSpinDetected(void);
 uint16_t gyroAbsRateDps(int axis);
@@ -0,0 +1,118 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Background gyro calibration.
+ *
+ * While disarmed the raw gyro is fed at about 1kHz into a running mean and variance per axis. A
+ * window that reaches its full length with the variance of every axis below the movement threshold
+ * was still, and its mean becomes the latest bias estimate. As soon as any axis goes over the
+ * threshold the window starts over, so a craft that is being handled doesn't waste a whole window
+ * before it gets another chance.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+
+#include "sensors/gyro_bias.h"
+
+// a window isn't judged on fewer samples than this, the variance of the first few means little
+#define GYRO_BIAS_MIN_SAMPLES_FOR_MOVEMENT  16u
+
+void gyroBiasInit(gyroBias_t *bias, uint32_t looptimeUs, uint32_t windowUs, float stillThreshold)
+{
+    bias->decimation = constrain(GYRO_BIAS_SAMPLE_INTERVAL_US / MAX(looptimeUs, 1u), 1, UINT8_MAX);
+    bias->decimationCount = 0;
+    bias->windowSamples = MAX(windowUs / (bias->decimation * looptimeUs), GYRO_BIAS_MIN_SAMPLES_FOR_MOVEMENT);
+    bias->maxVariance = sq(stillThreshold);
+    bias->valid = false;
+    gyroBiasRestart(bias);
+}
+
+void gyroBiasRestart(gyroBias_t *bias)
+{
+    bias->count = 0;
+}
+
+/*
+ * Feeds one raw gyro sample. Returns true when it completed a still window, the new estimate is
+ * then in zero and stdDev.
+ */
+FAST_CODE bool gyroBiasPush(gyroBias_t *bias, const int16_t *raw, timeUs_t currentTimeUs)
+{
+    if (++bias->decimationCount < bias->decimation) {
+        return false;
+    }
+    bias->decimationCount = 0;
+
+    if (bias->maxVariance <= 0.0f) {
+        return false;
+    }
+
+    const uint32_t count = ++bias->count;
+    const float countInv = 1.0f / count;
+    // the variance limit scaled to the sum of squares, compared without dividing each axis
+    const float maxM2 = bias->maxVariance * (count - 1);
+    bool moving = false;
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float x = raw[axis];
+        if (count == 1) {
+            bias->mean[axis] = x;
+            bias->m2[axis] = 0.0f;
+            continue;
+        }
+        const float delta = x - bias->mean[axis];
+        bias->mean[axis] += delta * countInv;
+        bias->m2[axis] += delta * (x - bias->mean[axis]);
+        moving |= bias->m2[axis] > maxM2;
+    }
+
+    if (moving && count >= GYRO_BIAS_MIN_SAMPLES_FOR_MOVEMENT) {
+        gyroBiasRestart(bias);
+        return false;
+    }
+    if (count < bias->windowSamples) {
+        return false;
+    }
+
+    if (!moving) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            bias->zero[axis] = bias->mean[axis];
+            bias->stdDev[axis] = sqrtf(bias->m2[axis] / (count - 1));
+        }
+        bias->stillUs = currentTimeUs;
+        bias->valid = true;
+    }
+    gyroBiasRestart(bias);
+
+    return !moving;
+}
+
+// true if there is an estimate from a still window that ended at most maxAgeUs ago
+bool gyroBiasIsFresh(const gyroBias_t *bias, timeUs_t currentTimeUs, timeDelta_t maxAgeUs)
+{
+    return bias->valid && cmpTimeUs(currentTimeUs, bias->stillUs) <= maxAgeUs;
+}
@@ -0,0 +1,58 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/axis.h"
+#include "common/time.h"
+
+// the estimator looks at the gyro about this often, plenty for a bias that only drifts with temperature
+#define GYRO_BIAS_SAMPLE_INTERVAL_US    1000
+
+/*
+ * Background gyro bias estimator. Keeps running mean and variance (Welford) of the raw gyro over
+ * windows of a fixed length and remembers the mean and noise of the last window in which the
+ * craft was still on all axes.
+ */
+typedef struct gyroBias_s {
+    // window in progress, the count is shared by the three axes
+    float mean[XYZ_AXIS_COUNT];
+    float m2[XYZ_AXIS_COUNT];
+    uint32_t count;
+
+    uint32_t windowSamples;
+    float maxVariance;              // a window with more variance on any axis isn't still, 0 if stillness can't be judged
+    uint8_t decimation;
+    uint8_t decimationCount;
+
+    // last still window
+    float zero[XYZ_AXIS_COUNT];
+    float stdDev[XYZ_AXIS_COUNT];
+    timeUs_t stillUs;               // when it ended
+    bool valid;
+} gyroBias_t;
+
+void gyroBiasInit(gyroBias_t *bias, uint32_t looptimeUs, uint32_t windowUs, float stillThreshold);
+void gyroBiasRestart(gyroBias_t *bias);
+bool gyroBiasPush(gyroBias_t *bias, const int16_t *raw, timeUs_t currentTimeUs);
+bool gyroBiasIsFresh(const gyroBias_t *bias, timeUs_t currentTimeUs, timeDelta_t maxAgeUs);
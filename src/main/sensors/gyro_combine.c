@@ -0,0 +1,82 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Noise weighted combination of two gyros.
+ *
+ * Two independent measurements of the same rate are combined with the least noise by weighting each
+ * with the inverse of its noise variance. The weights follow the live high frequency noise of each
+ * gyro per axis, so the sensor with the higher noise floor contributes less. The estimate hardly
+ * sees the motor band, see gyroNoise_t.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_DUAL_GYRO
+
+#include "common/maths.h"
+
+#include "sensors/gyro_combine.h"
+
+void gyroNoiseInit(gyroNoise_t *noise, uint32_t looptimeUs)
+{
+    const float k = pt1FilterGain(GYRO_COMBINE_NOISE_LPF_HZ, looptimeUs * 1e-6f);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        pt1FilterInit(&noise->variance[axis], k);
+    }
+    noise->samples = 0;
+}
+
+FAST_CODE void gyroNoiseUpdate(gyroNoise_t *noise, const float *gyroADCf)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        if (noise->samples >= 2) {
+            const float secondDifference = gyroADCf[axis] - 2.0f * noise->previous[0][axis] + noise->previous[1][axis];
+            pt1FilterApply(&noise->variance[axis], sq(secondDifference));
+        }
+        noise->previous[1][axis] = noise->previous[0][axis];
+        noise->previous[0][axis] = gyroADCf[axis];
+    }
+    if (noise->samples < 2) {
+        noise->samples++;
+    }
+}
+
+float gyroNoiseVariance(const gyroNoise_t *noise, int axis)
+{
+    return noise->variance[axis].state;
+}
+
+/*
+ * Returns the share of the first gyro in the combined rate, the second gets the rest.
+ */
+FAST_CODE float gyroCombineWeight(float variance1, float variance2)
+{
+    const float sum = variance1 + variance2;
+    if (sum < 1e-6f) {
+        return 0.5f;
+    }
+    return constrainf(variance2 / sum, GYRO_COMBINE_WEIGHT_MIN, 1.0f - GYRO_COMBINE_WEIGHT_MIN);
+}
+#endif
@@ -0,0 +1,50 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/axis.h"
+#include "common/filter.h"
+
+// neither gyro gets less than this share of the combined rate, so a sensor that goes quiet because it is stuck can't take over
+#define GYRO_COMBINE_WEIGHT_MIN     0.2f
+#define GYRO_COMBINE_NOISE_LPF_HZ   1
+
+/*
+ * Live noise estimate of one gyro, from the smoothed square of the second difference of its
+ * unfiltered rate. The second difference has a power gain of (2 * sin(pi * f / fs))^4: 16 at Nyquist,
+ * but only 6e-4 at 200Hz with an 8kHz loop. Flight motion and most of the motor band drop out, so
+ * this follows the high frequency noise floor of the sensor, not its motor noise. It is six times
+ * the noise variance for white noise, only the ratio between the two gyros is used.
+ */
+typedef struct gyroNoise_s {
+    pt1Filter_t variance[XYZ_AXIS_COUNT];
+    float previous[2][XYZ_AXIS_COUNT];
+    uint8_t samples;                    // up to the two needed before the first difference
+} gyroNoise_t;
+
+void gyroNoiseInit(gyroNoise_t *noise, uint32_t looptimeUs);
+void gyroNoiseUpdate(gyroNoise_t *noise, const float *gyroADCf);
+float gyroNoiseVariance(const gyroNoise_t *noise, int axis);
+float gyroCombineWeight(float variance1, float variance2);
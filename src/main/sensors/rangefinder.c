@@ -30,6 +30,7 @@
 #include "build/build_config.h"
 #include "build/debug.h"
 
+#include "common/filter.h"
 #include "common/maths.h"
 #include "common/utils.h"
 #include "common/time.h"
@@ -186,6 +187,11 @@ void rangefinderResetDynamicThreshold(void)
     rangefinder.dynamicDistanceThreshold = 0;
 }
 
+#define DISTANCE_SAMPLES_MEDIAN 5
+
+static medianFilter_t distanceMedianFilter;
+static float distanceMedianFilterBuffer[MEDIAN_FILTER_BUFFER_SIZE(DISTANCE_SAMPLES_MEDIAN)];
+
 bool rangefinderInit(void)
 {
     if (!rangefinderDetect(&rangefinder.dev, rangefinderConfig()->rangefinder_hardware)) {
@@ -200,6 +206,7 @@ bool rangefinderInit(void)
     rangefinder.snr = 0;
 
     rangefinderResetDynamicThreshold();
+    medianFilterInit(&distanceMedianFilter, DISTANCE_SAMPLES_MEDIAN, distanceMedianFilterBuffer);
 
     // XXX Interface to CF/BF legacy(?) altitude estimation code.
     // XXX Will be gone once iNav's estimator is ported.
@@ -212,20 +219,12 @@ bool rangefinderInit(void)
 
 static int32_t applyMedianFilter(int32_t newReading)
 {
-    #define DISTANCE_SAMPLES_MEDIAN 5
-    static int32_t filterSamples[DISTANCE_SAMPLES_MEDIAN];
-    static int filterSampleIndex = 0;
-    static bool medianFilterReady = false;
+    static int32_t median;
 
     if (newReading > RANGEFINDER_OUT_OF_RANGE) {// only accept samples that are in range
-        filterSamples[filterSampleIndex] = newReading;
-        ++filterSampleIndex;
-        if (filterSampleIndex == DISTANCE_SAMPLES_MEDIAN) {
-            filterSampleIndex = 0;
-            medianFilterReady = true;
-        }
+        median = lrintf(medianFilterApply(&distanceMedianFilter, newReading));
     }
-    return medianFilterReady ? quickMedianFilter5(filterSamples) : newReading;
+    return distanceMedianFilter.count == DISTANCE_SAMPLES_MEDIAN ? median : newReading;
 }
 
 static int16_t computePseudoSnr(int32_t newReading) {
@@ -467,7 +467,7 @@ char _Min_Stack_Size;
 
 // fake EEPROM
 static FILE *eepromFd = NULL;
-uint8_t eepromData[EEPROM_SIZE];
+uint8_t eepromData[EEPROM_SIZE] __attribute__((aligned(FLASH_PAGE_SIZE)));
 
 void FLASH_Unlock(void) {
     if (eepromFd != NULL) {
@@ -516,8 +516,11 @@ void FLASH_Lock(void) {
 }
 
 FLASH_Status FLASH_ErasePage(uintptr_t Page_Address) {
-    UNUSED(Page_Address);
 //    printf("[FLASH_ErasePage]%x\n", Page_Address);
+    // erased flash reads back as 0xFF, the config log relies on it to find free space
+    if ((Page_Address >= (uintptr_t)eepromData) && (Page_Address < (uintptr_t)ARRAYEND(eepromData))) {
+        memset((void *)Page_Address, 0xFF, MIN((uintptr_t)FLASH_PAGE_SIZE, (uintptr_t)ARRAYEND(eepromData) - Page_Address));
+    }
     return FLASH_COMPLETE;
 }
 
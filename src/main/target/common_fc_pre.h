@@ -53,6 +53,8 @@
 #define USE_FAST_RAM
 #endif
 #define USE_DSHOT
+#define USE_DSHOT_TELEMETRY
+#define USE_RPM_FILTER
 #define I2C3_OVERCLOCK true
 #define USE_GYRO_DATA_ANALYSE
 #define USE_ADC
@@ -71,6 +73,8 @@
 #define USE_ITCM_RAM
 #define USE_FAST_RAM
 #define USE_DSHOT
+#define USE_DSHOT_TELEMETRY
+#define USE_RPM_FILTER
 #define I2C3_OVERCLOCK true
 #define I2C4_OVERCLOCK true
 #define USE_GYRO_DATA_ANALYSE
@@ -133,6 +137,7 @@
 #define USE_SERIALRX_SPEKTRUM   // SRXL, DSM2 and DSMX protocol
 #define USE_SERIALRX_SUMD       // Graupner Hott protocol
 #define USE_SERIALRX_XBUS       // JR
+#define USE_RX_FRAME_EVENT      // Serial RX frames are picked up by the PID loop as soon as they are complete
 
 
 
@@ -157,6 +162,7 @@
 #if (FLASH_SIZE > 128)
 #define USE_SERIALRX_SUMH       // Graupner legacy protocol
 #define USE_CAMERA_CONTROL
+#define USE_CRC_TABLE
 #define USE_CMS
 #define USE_EXTENDED_CMS_MENUS
 #define USE_DSHOT_DMAR
@@ -165,6 +171,7 @@
 #define USE_HUFFMAN
 #define USE_MSP_DISPLAYPORT
 #define USE_MSP_OVER_TELEMETRY
+#define USE_MSP_STREAM
 #define MSP_OVER_CLI
 #define USE_OSD
 #define USE_OSD_OVER_MSP_DISPLAYPORT
@@ -227,4 +234,5 @@
 #define USE_SIGNATURE
 #define USE_ABSOLUTE_CONTROL
 #define USE_TPA_CURVES
+#define USE_CRC_SLICE_BY_4
 #endif
@@ -62,10 +62,12 @@
 #include "sensors/sensors.h"
 
 #include "telemetry/telemetry.h"
+#include "telemetry/telemetry_scheduler.h"
 #include "telemetry/crsf.h"
 #include "telemetry/msp_shared.h"
 
 #define CRSF_CYCLETIME_US                   100000 // 100ms, 10 Hz
+#define CRSF_ATTITUDE_BATCH_RATE_HZ         50
 #define CRSF_DEVICEINFO_VERSION             0x01
 #define CRSF_DEVICEINFO_PARAMETER_COUNT     0
 
@@ -73,6 +75,7 @@
 #define CRSF_MSP_LENGTH_OFFSET 1
 
 static bool crsfTelemetryEnabled;
+static bool crsfTelemetryBatch;     // fill each telemetry window with as many frames as fit
 static bool deviceInfoReplyPending;
 static uint8_t crsfFrame[CRSF_FRAME_SIZE_MAX];
 
@@ -342,20 +345,13 @@ static void crsfFrameDisplayPortClear(sbuf_t *dst)
 
 #endif
 
-#define BV(x)  (1 << (x)) // bit value
+#define CRSF_SCHEDULE_COUNT_MAX 4
+#define CRSF_FRAME_FLIGHT_MODE_PAYLOAD_SIZE_MAX 5   // longest mode string plus terminator
+#define CRSF_FRAME_COST(payloadSize) ((payloadSize) + CRSF_FRAME_LENGTH_NON_PAYLOAD)   // bytes on the wire
 
-// schedule array to decide how often each type of frame is sent
-typedef enum {
-    CRSF_FRAME_START_INDEX = 0,
-    CRSF_FRAME_ATTITUDE_INDEX = CRSF_FRAME_START_INDEX,
-    CRSF_FRAME_BATTERY_SENSOR_INDEX,
-    CRSF_FRAME_FLIGHT_MODE_INDEX,
-    CRSF_FRAME_GPS_INDEX,
-    CRSF_SCHEDULE_COUNT_MAX
-} crsfFrameTypeIndex_e;
-
-static uint8_t crsfScheduleCount;
-static uint8_t crsfSchedule[CRSF_SCHEDULE_COUNT_MAX];
+// decides which frame goes into each telemetry slot
+static telemetrySchedulerItem_t crsfScheduleItems[CRSF_SCHEDULE_COUNT_MAX];
+static telemetryScheduler_t crsfScheduler;
 
 #if defined(USE_MSP_OVER_TELEMETRY)
 
@@ -381,39 +377,51 @@ void crsfSendMspResponse(uint8_t *payload)
 }
 #endif
 
-static void processCrsf(void)
+static void processCrsf(timeUs_t currentTimeUs)
 {
-    static uint8_t crsfScheduleIndex = 0;
-
-    const uint8_t currentSchedule = crsfSchedule[crsfScheduleIndex];
-
     sbuf_t crsfPayloadBuf;
     sbuf_t *dst = &crsfPayloadBuf;
+    uint32_t handled = 0;
+
+    // frames whose content hasn't changed give their slot to the next frame in line,
+    // when batching the slot takes every frame that fits, each at most once
+    for (int tries = 0; tries < crsfScheduler.count; tries++) {
+        const int index = telemetrySchedulerNext(&crsfScheduler, currentTimeUs, crsfRxTelemetryBytesFree());
+        if (index < 0 || (handled & BIT(index))) {
+            return;
+        }
+        handled |= BIT(index);
+        telemetrySchedulerMarkSent(&crsfScheduler, index, currentTimeUs);
 
-    if (currentSchedule & BV(CRSF_FRAME_ATTITUDE_INDEX)) {
-        crsfInitializeFrame(dst);
-        crsfFrameAttitude(dst);
-        crsfFinalize(dst);
-    }
-    if (currentSchedule & BV(CRSF_FRAME_BATTERY_SENSOR_INDEX)) {
-        crsfInitializeFrame(dst);
-        crsfFrameBatterySensor(dst);
-        crsfFinalize(dst);
-    }
-
-    if (currentSchedule & BV(CRSF_FRAME_FLIGHT_MODE_INDEX)) {
         crsfInitializeFrame(dst);
-        crsfFrameFlightMode(dst);
-        crsfFinalize(dst);
-    }
+        switch (crsfScheduler.items[index].id) {
+        case CRSF_FRAMETYPE_ATTITUDE:
+            crsfFrameAttitude(dst);
+            break;
+        case CRSF_FRAMETYPE_BATTERY_SENSOR:
+            crsfFrameBatterySensor(dst);
+            break;
+        case CRSF_FRAMETYPE_FLIGHT_MODE:
+            crsfFrameFlightMode(dst);
+            break;
 #ifdef USE_GPS
-    if (currentSchedule & BV(CRSF_FRAME_GPS_INDEX)) {
-        crsfInitializeFrame(dst);
-        crsfFrameGps(dst);
-        crsfFinalize(dst);
-    }
+        case CRSF_FRAMETYPE_GPS:
+            crsfFrameGps(dst);
+            break;
 #endif
-    crsfScheduleIndex = (crsfScheduleIndex + 1) % crsfScheduleCount;
+        default:
+            continue;
+        }
+
+        // frame content, skipping the sync byte and the frame length
+        const uint16_t contentHash = crc16_ccitt_update(0, &crsfFrame[2], sbufPtr(dst) - &crsfFrame[2]);
+        if (telemetrySchedulerValueChanged(&crsfScheduler, index, contentHash, currentTimeUs)) {
+            crsfFinalize(dst);
+            if (!crsfTelemetryBatch) {
+                return;
+            }
+        }
+    }
 }
 
 void crsfScheduleDeviceInfoResponse(void)
@@ -436,25 +444,27 @@ void initCrsfTelemetry(void)
 #if defined(USE_MSP_OVER_TELEMETRY)
     mspReplyPending = false;
 #endif
+    crsfTelemetryBatch = telemetryConfig()->crsf_telemetry_batch;
+    crsfRxSetTelemetryBatch(crsfTelemetryBatch);
 
 #if defined(USE_CMS) && defined(USE_CRSF_CMS_TELEMETRY)
     cmsDisplayPortRegister(displayPortCrsfInit());
 #endif
 
-    int index = 0;
+    // one slot per frame type every CRSF_CYCLETIME_US, slots left over by unchanged frames go to the most urgent ones.
+    // When batching every window after an RC frame takes the frames that are due, each at its own rate.
+    telemetrySchedulerInit(&crsfScheduler, crsfScheduleItems, CRSF_SCHEDULE_COUNT_MAX, !crsfTelemetryBatch);
     if (sensors(SENSOR_ACC)) {
-        crsfSchedule[index++] = BV(CRSF_FRAME_ATTITUDE_INDEX);
+        telemetrySchedulerAdd(&crsfScheduler, CRSF_FRAMETYPE_ATTITUDE, crsfTelemetryBatch ? CRSF_ATTITUDE_BATCH_RATE_HZ : 20, TELEMETRY_PRIORITY_MEDIUM, CRSF_FRAME_COST(CRSF_FRAME_ATTITUDE_PAYLOAD_SIZE));
     }
     if (isBatteryVoltageConfigured() || isAmperageConfigured()) {
-        crsfSchedule[index++] = BV(CRSF_FRAME_BATTERY_SENSOR_INDEX);
+        telemetrySchedulerAdd(&crsfScheduler, CRSF_FRAMETYPE_BATTERY_SENSOR, 10, TELEMETRY_PRIORITY_HIGH, CRSF_FRAME_COST(CRSF_FRAME_BATTERY_SENSOR_PAYLOAD_SIZE));
     }
-    crsfSchedule[index++] = BV(CRSF_FRAME_FLIGHT_MODE_INDEX);
+    telemetrySchedulerAdd(&crsfScheduler, CRSF_FRAMETYPE_FLIGHT_MODE, 5, TELEMETRY_PRIORITY_MEDIUM, CRSF_FRAME_COST(CRSF_FRAME_FLIGHT_MODE_PAYLOAD_SIZE_MAX));
     if (feature(FEATURE_GPS)) {
-        crsfSchedule[index++] = BV(CRSF_FRAME_GPS_INDEX);
+        telemetrySchedulerAdd(&crsfScheduler, CRSF_FRAMETYPE_GPS, 10, TELEMETRY_PRIORITY_MEDIUM, CRSF_FRAME_COST(CRSF_FRAME_GPS_PAYLOAD_SIZE));
     }
-    crsfScheduleCount = (uint8_t)index;
-
- }
+}
 
 bool checkCrsfTelemetryState(void)
 {
@@ -487,69 +497,107 @@ void crsfProcessDisplayPortCmd(uint8_t *frameStart)
 #endif
 
 /*
- * Called periodically by the scheduler
+ * Writes pending ad-hoc response frames: the most important one, or when batching as many as fit.
+ * Returns true if there was anything to respond to.
  */
-void handleCrsfTelemetry(timeUs_t currentTimeUs)
+static bool processCrsfAdHocFrames(void)
 {
-    static uint32_t crsfLastCycleTime;
-
-    if (!crsfTelemetryEnabled) {
-        return;
-    }
-    // Give the receiver a chance to send any outstanding telemetry data.
-    // This needs to be done at high frequency, to enable the RX to send the telemetry frame
-    // in between the RX frames.
-    crsfRxSendTelemetryData();
+    bool responded = false;
+    sbuf_t crsfPayloadBuf;
+    sbuf_t *dst = &crsfPayloadBuf;
 
-    // Send ad-hoc response frames as soon as possible
 #if defined(USE_MSP_OVER_TELEMETRY)
-    if (mspReplyPending) {
-        mspReplyPending = handleCrsfMspFrameBuffer(CRSF_FRAME_TX_MSP_FRAME_SIZE, &crsfSendMspResponse);
-        crsfLastCycleTime = currentTimeUs; // reset telemetry timing due to ad-hoc request
-        return;
+    // when batching, a chunk is only taken from the reply if the window has room for it
+    if (mspReplyPending && (!crsfTelemetryBatch || crsfRxTelemetryBytesFree() >= CRSF_FRAME_SIZE_MAX)) {
+        if (crsfTelemetryBatch && !mspRxBuffer.len) {
+            // rest of a reply that didn't fit in the last window
+            mspReplyPending = sendMspReply(CRSF_FRAME_TX_MSP_FRAME_SIZE, &crsfSendMspResponse);
+        } else {
+            mspReplyPending = handleCrsfMspFrameBuffer(CRSF_FRAME_TX_MSP_FRAME_SIZE, &crsfSendMspResponse);
+        }
+        // replies longer than one frame go out a chunk after the other while there is room
+        while (crsfTelemetryBatch && mspReplyPending && crsfRxTelemetryBytesFree() >= CRSF_FRAME_SIZE_MAX) {
+            mspReplyPending = sendMspReply(CRSF_FRAME_TX_MSP_FRAME_SIZE, &crsfSendMspResponse);
+        }
+        if (!crsfTelemetryBatch) {
+            return true;
+        }
+        responded = true;
     }
 #endif
 
-    if (deviceInfoReplyPending) {
-        sbuf_t crsfPayloadBuf;
-        sbuf_t *dst = &crsfPayloadBuf;
+    if (deviceInfoReplyPending && crsfRxTelemetryBytesFree() >= CRSF_FRAME_SIZE_MAX) {
         crsfInitializeFrame(dst);
         crsfFrameDeviceInfo(dst);
         crsfFinalize(dst);
         deviceInfoReplyPending = false;
-        crsfLastCycleTime = currentTimeUs; // reset telemetry timing due to ad-hoc request
-        return;
+        if (!crsfTelemetryBatch) {
+            return true;
+        }
+        responded = true;
     }
 
 #if defined(USE_CRSF_CMS_TELEMETRY)
-    if (crsfDisplayPortScreen()->reset) {
+    if (crsfDisplayPortScreen()->reset && crsfRxTelemetryBytesFree() >= CRSF_FRAME_SIZE_MAX) {
         crsfDisplayPortScreen()->reset = false;
-        sbuf_t crsfDisplayPortBuf;
-        sbuf_t *dst = &crsfDisplayPortBuf;
         crsfInitializeFrame(dst);
         crsfFrameDisplayPortClear(dst);
         crsfFinalize(dst);
-        crsfLastCycleTime = currentTimeUs;
-        return;
+        if (!crsfTelemetryBatch) {
+            return true;
+        }
+        responded = true;
     }
-    const int nextRow = crsfDisplayPortNextRow();
-    if (nextRow >= 0) {
-        sbuf_t crsfDisplayPortBuf;
-        sbuf_t *dst = &crsfDisplayPortBuf;
+    int nextRow;
+    while (crsfRxTelemetryBytesFree() >= CRSF_FRAME_SIZE_MAX && (nextRow = crsfDisplayPortNextRow()) >= 0) {
         crsfInitializeFrame(dst);
         crsfFrameDisplayPortRow(dst, nextRow);
         crsfFinalize(dst);
         crsfDisplayPortScreen()->pendingTransport[nextRow] = false;
-        crsfLastCycleTime = currentTimeUs;
-        return;
+        if (!crsfTelemetryBatch) {
+            return true;
+        }
+        responded = true;
     }
 #endif
 
+    return responded;
+}
+
+/*
+ * Called periodically by the scheduler
+ */
+void handleCrsfTelemetry(timeUs_t currentTimeUs)
+{
+    static uint32_t crsfLastCycleTime;
+
+    if (!crsfTelemetryEnabled) {
+        return;
+    }
+    // Give the receiver a chance to send any outstanding telemetry data.
+    // This needs to be done at high frequency, to enable the RX to send the telemetry frame
+    // in between the RX frames.
+    crsfRxSendTelemetryData();
+
+    if (crsfTelemetryBatch) {
+        // fill the window after the next RC frame, ad-hoc responses first, frames that are due
+        // but don't fit stay due for the window after
+        processCrsfAdHocFrames();
+        processCrsf(currentTimeUs);
+        return;
+    }
+
+    // Send ad-hoc response frames as soon as possible, they take the whole slot
+    if (processCrsfAdHocFrames()) {
+        crsfLastCycleTime = currentTimeUs; // reset telemetry timing due to ad-hoc request
+        return;
+    }
+
     // Actual telemetry data only needs to be sent at a low frequency, ie 10Hz
     // Spread out scheduled frames evenly so each frame is sent at the same frequency.
-    if (currentTimeUs >= crsfLastCycleTime + (CRSF_CYCLETIME_US / crsfScheduleCount)) {
+    if (currentTimeUs >= crsfLastCycleTime + (CRSF_CYCLETIME_US / crsfScheduler.count)) {
         crsfLastCycleTime = currentTimeUs;
-        processCrsf();
+        processCrsf(currentTimeUs);
     }
 }
 
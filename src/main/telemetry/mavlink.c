@@ -34,6 +34,8 @@
 #include "common/maths.h"
 #include "common/axis.h"
 #include "common/color.h"
+#include "common/crc.h"
+#include "common/utils.h"
 
 #include "config/feature.h"
 #include "pg/pg.h"
@@ -45,6 +47,7 @@
 #include "drivers/time.h"
 
 #include "fc/config.h"
+#include "fc/loop_state.h"
 #include "fc/rc_controls.h"
 #include "fc/runtime_config.h"
 
@@ -70,6 +73,7 @@
 #include "sensors/battery.h"
 
 #include "telemetry/telemetry.h"
+#include "telemetry/telemetry_scheduler.h"
 #include "telemetry/mavlink.h"
 
 // mavlink library uses unnames unions that's causes GCC to complain if -Wpedantic is used
@@ -79,9 +83,19 @@
 #include "common/mavlink.h"
 #pragma GCC diagnostic pop
 
-#define TELEMETRY_MAVLINK_INITIAL_PORT_MODE MODE_TX
-#define TELEMETRY_MAVLINK_MAXRATE 50
-#define TELEMETRY_MAVLINK_DELAY ((1000 * 1000) / TELEMETRY_MAVLINK_MAXRATE)
+#define TELEMETRY_MAVLINK_INITIAL_PORT_MODE MODE_RXTX
+#define TELEMETRY_MAVLINK_MAXRATE 100
+#define TELEMETRY_MAVLINK_MIN_INTERVAL_US ((1000 * 1000) / TELEMETRY_MAVLINK_MAXRATE)
+#define TELEMETRY_MAVLINK_MAX_INTERVAL_US (60 * 1000 * 1000)
+
+#define TELEMETRY_MAVLINK_SYSTEM_ID 0
+#define TELEMETRY_MAVLINK_COMPONENT_ID 200
+
+// messages sent at most this often are only repeated unchanged as a keepalive
+#define TELEMETRY_MAVLINK_COALESCE_INTERVAL_US 100000
+
+// not part of the MAVLink common message set bundled in lib/main/MAVLink yet
+#define MAVLINK_CMD_SET_MESSAGE_INTERVAL 511
 
 extern uint16_t rssi; // FIXME dependency on mw.c
 
@@ -89,51 +103,29 @@ static serialPort_t *mavlinkPort = NULL;
 static serialPortConfig_t *portConfig;
 
 static bool mavlinkTelemetryEnabled =  false;
+static bool mavlinkPortShared = false;     // the serial RX reads the port, incoming MAVLink is not parsed
 static portSharing_e mavlinkPortSharing;
 
-/* MAVLink datastream rates in Hz */
-static const uint8_t mavRates[] = {
-    [MAV_DATA_STREAM_EXTENDED_STATUS] = 2, //2Hz
-    [MAV_DATA_STREAM_RC_CHANNELS] = 5, //5Hz
-    [MAV_DATA_STREAM_POSITION] = 2, //2Hz
-    [MAV_DATA_STREAM_EXTRA1] = 10, //10Hz
-    [MAV_DATA_STREAM_EXTRA2] = 10 //2Hz
-};
+static void mavlinkInitMessageSchedule(void);
 
-#define MAXSTREAMS (sizeof(mavRates) / sizeof(mavRates[0]))
-
-static uint8_t mavTicks[MAXSTREAMS];
+static loopState_t loopState;  // all messages sent in one go describe the same PID loop
 static mavlink_message_t mavMsg;
+static mavlink_message_t mavRxMsg;
 static uint8_t mavBuffer[MAVLINK_MAX_PACKET_LEN];
-static uint32_t lastMavlinkMessage = 0;
 
-static int mavlinkStreamTrigger(enum MAV_DATA_STREAM streamNum)
+static void mavlinkSendMessage(const mavlink_message_t *msg)
 {
-    uint8_t rate = (uint8_t) mavRates[streamNum];
-    if (rate == 0) {
-        return 0;
-    }
+    const int length = MAVLINK_NUM_NON_PAYLOAD_BYTES + msg->len;
+    uint8_t *buf;
 
-    if (mavTicks[streamNum] == 0) {
-        // we're triggering now, setup the next trigger point
-        if (rate > TELEMETRY_MAVLINK_MAXRATE) {
-            rate = TELEMETRY_MAVLINK_MAXRATE;
-        }
-
-        mavTicks[streamNum] = (TELEMETRY_MAVLINK_MAXRATE / rate);
-        return 1;
+    // encode straight into the transmit buffer if it has a long enough contiguous run
+    if (serialReserveWrite(mavlinkPort, &buf) >= length) {
+        mavlink_msg_to_send_buffer(buf, msg);
+        serialCommitWrite(mavlinkPort, length);
+    } else {
+        mavlink_msg_to_send_buffer(mavBuffer, msg);
+        serialWriteBuf(mavlinkPort, mavBuffer, length);
     }
-
-    // count down at TASK_RATE_HZ
-    mavTicks[streamNum]--;
-    return 0;
-}
-
-
-static void mavlinkSerialWrite(uint8_t * buf, uint16_t length)
-{
-    for (int i = 0; i < length; i++)
-        serialWrite(mavlinkPort, buf[i]);
 }
 
 void freeMAVLinkTelemetryPort(void)
@@ -141,10 +133,12 @@ void freeMAVLinkTelemetryPort(void)
     closeSerialPort(mavlinkPort);
     mavlinkPort = NULL;
     mavlinkTelemetryEnabled = false;
+    mavlinkPortShared = false;
 }
 
 void initMAVLinkTelemetry(void)
 {
+    mavlinkInitMessageSchedule();
     portConfig = findSerialPortConfig(FUNCTION_TELEMETRY_MAVLINK);
     mavlinkPortSharing = determinePortSharing(portConfig, FUNCTION_TELEMETRY_MAVLINK);
 }
@@ -176,6 +170,7 @@ void checkMAVLinkTelemetryState(void)
         if (!mavlinkTelemetryEnabled && telemetrySharedPort != NULL) {
             mavlinkPort = telemetrySharedPort;
             mavlinkTelemetryEnabled = true;
+            mavlinkPortShared = true;
         }
     } else {
         bool newTelemetryEnabledValue = telemetryDetermineEnabledState(mavlinkPortSharing);
@@ -191,10 +186,8 @@ void checkMAVLinkTelemetryState(void)
     }
 }
 
-void mavlinkSendSystemStatus(void)
+static bool mavlinkPackSystemStatus(mavlink_message_t *msg)
 {
-    uint16_t msgLength;
-
     uint32_t onboardControlAndSensors = 35843;
 
     /*
@@ -221,7 +214,7 @@ void mavlinkSendSystemStatus(void)
         batteryRemaining = isBatteryVoltageConfigured() ? calculateBatteryPercentageRemaining() : batteryRemaining;
     }
 
-    mavlink_msg_sys_status_pack(0, 200, &mavMsg,
+    mavlink_msg_sys_status_pack(TELEMETRY_MAVLINK_SYSTEM_ID, TELEMETRY_MAVLINK_COMPONENT_ID, msg,
         // onboard_control_sensors_present Bitmask showing which onboard controllers and sensors are present.
         //Value of 0: not present. Value of 1: present. Indices: 0: 3D gyro, 1: 3D acc, 2: 3D mag, 3: absolute pressure,
         // 4: differential pressure, 5: GPS, 6: optical flow, 7: computer vision position, 8: laser based position,
@@ -252,14 +245,12 @@ void mavlinkSendSystemStatus(void)
         0,
         // errors_count4 Autopilot-specific errors
         0);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    return true;
 }
 
-void mavlinkSendRCChannelsAndRSSI(void)
+static bool mavlinkPackRCChannelsAndRSSI(mavlink_message_t *msg)
 {
-    uint16_t msgLength;
-    mavlink_msg_rc_channels_raw_pack(0, 200, &mavMsg,
+    mavlink_msg_rc_channels_raw_pack(TELEMETRY_MAVLINK_SYSTEM_ID, TELEMETRY_MAVLINK_COMPONENT_ID, msg,
         // time_boot_ms Timestamp (milliseconds since system boot)
         millis(),
         // port Servo output port (set of 8 outputs = 1 port). Most MAVs will just use one, but this allows to encode more than 8 servos.
@@ -282,18 +273,16 @@ void mavlinkSendRCChannelsAndRSSI(void)
         (rxRuntimeConfig.channelCount >= 8) ? rcData[7] : 0,
         // rssi Receive signal strength indicator, 0: 0%, 255: 100%
         constrain(scaleRange(getRssi(), 0, RSSI_MAX_VALUE, 0, 255), 0, 255));
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    return true;
 }
 
 #if defined(USE_GPS)
-void mavlinkSendPosition(void)
+static bool mavlinkPackGpsRawInt(mavlink_message_t *msg)
 {
-    uint16_t msgLength;
     uint8_t gpsFixType = 0;
 
     if (!sensors(SENSOR_GPS))
-        return;
+        return false;
 
     if (!STATE(GPS_FIX)) {
         gpsFixType = 1;
@@ -307,7 +296,7 @@ void mavlinkSendPosition(void)
         }
     }
 
-    mavlink_msg_gps_raw_int_pack(0, 200, &mavMsg,
+    mavlink_msg_gps_raw_int_pack(TELEMETRY_MAVLINK_SYSTEM_ID, TELEMETRY_MAVLINK_COMPONENT_ID, msg,
         // time_usec Timestamp (microseconds since UNIX epoch or microseconds since system boot)
         micros(),
         // fix_type 0-1: no fix, 2: 2D fix, 3: 3D fix. Some applications will not use the value of this field unless it is at least two, so always correctly fill in the fix.
@@ -328,11 +317,15 @@ void mavlinkSendPosition(void)
         gpsSol.groundCourse * 10,
         // satellites_visible Number of satellites visible. If unknown, set to 255
         gpsSol.numSat);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    return true;
+}
+
+static bool mavlinkPackGlobalPositionInt(mavlink_message_t *msg)
+{
+    if (!sensors(SENSOR_GPS))
+        return false;
 
-    // Global position
-    mavlink_msg_global_position_int_pack(0, 200, &mavMsg,
+    mavlink_msg_global_position_int_pack(TELEMETRY_MAVLINK_SYSTEM_ID, TELEMETRY_MAVLINK_COMPONENT_ID, msg,
         // time_usec Timestamp (microseconds since UNIX epoch or microseconds since system boot)
         micros(),
         // lat Latitude in 1E7 degrees
@@ -354,48 +347,82 @@ void mavlinkSendPosition(void)
         // Ground Z Speed (Altitude), expressed as m/s * 100
         0,
         // heading Current heading in degrees, in compass units (0..360, 0=north)
-        DECIDEGREES_TO_DEGREES(attitude.values.yaw)
+        DECIDEGREES_TO_DEGREES(loopState.attitude.values.yaw)
     );
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    return true;
+}
+
+static bool mavlinkPackGpsGlobalOrigin(mavlink_message_t *msg)
+{
+    if (!sensors(SENSOR_GPS))
+        return false;
 
-    mavlink_msg_gps_global_origin_pack(0, 200, &mavMsg,
+    mavlink_msg_gps_global_origin_pack(TELEMETRY_MAVLINK_SYSTEM_ID, TELEMETRY_MAVLINK_COMPONENT_ID, msg,
         // latitude Latitude (WGS84), expressed as * 1E7
         GPS_home[LAT],
         // longitude Longitude (WGS84), expressed as * 1E7
         GPS_home[LON],
         // altitude Altitude(WGS84), expressed as * 1000
         0);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    return true;
 }
 #endif
 
-void mavlinkSendAttitude(void)
+static bool mavlinkPackAttitude(mavlink_message_t *msg)
 {
-    uint16_t msgLength;
-    mavlink_msg_attitude_pack(0, 200, &mavMsg,
+    mavlink_msg_attitude_pack(TELEMETRY_MAVLINK_SYSTEM_ID, TELEMETRY_MAVLINK_COMPONENT_ID, msg,
         // time_boot_ms Timestamp (milliseconds since system boot)
         millis(),
         // roll Roll angle (rad)
-        DECIDEGREES_TO_RADIANS(attitude.values.roll),
+        DECIDEGREES_TO_RADIANS(loopState.attitude.values.roll),
         // pitch Pitch angle (rad)
-        DECIDEGREES_TO_RADIANS(-attitude.values.pitch),
+        DECIDEGREES_TO_RADIANS(-loopState.attitude.values.pitch),
         // yaw Yaw angle (rad)
-        DECIDEGREES_TO_RADIANS(attitude.values.yaw),
+        DECIDEGREES_TO_RADIANS(loopState.attitude.values.yaw),
+        // rollspeed Roll angular speed (rad/s)
+        0,
+        // pitchspeed Pitch angular speed (rad/s)
+        0,
+        // yawspeed Yaw angular speed (rad/s)
+        0);
+    return true;
+}
+
+static bool mavlinkPackAttitudeQuaternion(mavlink_message_t *msg)
+{
+    // same frame as the ATTITUDE message, so the two always agree
+    const float halfRoll = DECIDEGREES_TO_RADIANS(loopState.attitude.values.roll) / 2;
+    const float halfPitch = DECIDEGREES_TO_RADIANS(-loopState.attitude.values.pitch) / 2;
+    const float halfYaw = DECIDEGREES_TO_RADIANS(loopState.attitude.values.yaw) / 2;
+    const float cr = cos_approx(halfRoll);
+    const float sr = sin_approx(halfRoll);
+    const float cp = cos_approx(halfPitch);
+    const float sp = sin_approx(halfPitch);
+    const float cy = cos_approx(halfYaw);
+    const float sy = sin_approx(halfYaw);
+
+    mavlink_msg_attitude_quaternion_pack(TELEMETRY_MAVLINK_SYSTEM_ID, TELEMETRY_MAVLINK_COMPONENT_ID, msg,
+        // time_boot_ms Timestamp (milliseconds since system boot)
+        millis(),
+        // q1 Quaternion component 1, w (1 in null-rotation)
+        cr * cp * cy + sr * sp * sy,
+        // q2 Quaternion component 2, x (0 in null-rotation)
+        sr * cp * cy - cr * sp * sy,
+        // q3 Quaternion component 3, y (0 in null-rotation)
+        cr * sp * cy + sr * cp * sy,
+        // q4 Quaternion component 4, z (0 in null-rotation)
+        cr * cp * sy - sr * sp * cy,
         // rollspeed Roll angular speed (rad/s)
         0,
         // pitchspeed Pitch angular speed (rad/s)
         0,
         // yawspeed Yaw angular speed (rad/s)
         0);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    return true;
 }
 
-void mavlinkSendHUDAndHeartbeat(void)
+static bool mavlinkPackVfrHud(mavlink_message_t *msg)
 {
-    uint16_t msgLength;
     float mavAltitude = 0;
     float mavGroundSpeed = 0;
     float mavAirSpeed = 0;
@@ -427,22 +454,24 @@ void mavlinkSendHUDAndHeartbeat(void)
     }
 #endif
 
-    mavlink_msg_vfr_hud_pack(0, 200, &mavMsg,
+    mavlink_msg_vfr_hud_pack(TELEMETRY_MAVLINK_SYSTEM_ID, TELEMETRY_MAVLINK_COMPONENT_ID, msg,
         // airspeed Current airspeed in m/s
         mavAirSpeed,
         // groundspeed Current ground speed in m/s
         mavGroundSpeed,
         // heading Current heading in degrees, in compass units (0..360, 0=north)
-        DECIDEGREES_TO_DEGREES(attitude.values.yaw),
+        DECIDEGREES_TO_DEGREES(loopState.attitude.values.yaw),
         // throttle Current throttle setting in integer percent, 0 to 100
         scaleRange(constrain(rcData[THROTTLE], PWM_RANGE_MIN, PWM_RANGE_MAX), PWM_RANGE_MIN, PWM_RANGE_MAX, 0, 100),
         // alt Current altitude (MSL), in meters, if we have sonar or baro use them, otherwise use GPS (less accurate)
         mavAltitude,
         // climb Current climb rate in meters/second
         mavClimbRate);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    return true;
+}
 
+static bool mavlinkPackHeartbeat(mavlink_message_t *msg)
+{
 
     uint8_t mavModes = MAV_MODE_FLAG_MANUAL_INPUT_ENABLED;
     if (ARMING_FLAG(ARMED))
@@ -514,7 +543,7 @@ void mavlinkSendHUDAndHeartbeat(void)
         mavSystemState = MAV_STATE_STANDBY;
     }
 
-    mavlink_msg_heartbeat_pack(0, 200, &mavMsg,
+    mavlink_msg_heartbeat_pack(TELEMETRY_MAVLINK_SYSTEM_ID, TELEMETRY_MAVLINK_COMPONENT_ID, msg,
         // type Type of the MAV (quadrotor, helicopter, etc., up to 15 types, defined in MAV_TYPE ENUM)
         mavSystemType,
         // autopilot Autopilot type / class. defined in MAV_AUTOPILOT ENUM
@@ -525,33 +554,191 @@ void mavlinkSendHUDAndHeartbeat(void)
         mavCustomMode,
         // system_status System status flag, see MAV_STATE ENUM
         mavSystemState);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    return true;
+}
+
+typedef bool (*mavlinkPackFnPtr)(mavlink_message_t *msg);
+
+typedef struct mavlinkMessage_s {
+    uint8_t msgId;
+    uint8_t payloadLength;
+    uint8_t defaultRateHz;      // 0 if only sent once the ground station asks for it
+    uint8_t stream;             // MAV_DATA_STREAM the message is part of, MAV_DATA_STREAM_ENUM_END for none
+    uint8_t priority;
+    uint8_t timestampLength;    // leading payload bytes holding a timestamp, left out of the change check
+    bool coalesce;              // an unchanged message isn't repeated at slow rates
+    mavlinkPackFnPtr pack;
+} mavlinkMessage_t;
+
+static const mavlinkMessage_t mavlinkMessages[] = {
+    { MAVLINK_MSG_ID_HEARTBEAT, MAVLINK_MSG_ID_HEARTBEAT_LEN, 10, MAV_DATA_STREAM_ENUM_END, TELEMETRY_PRIORITY_HIGH, 0, false, mavlinkPackHeartbeat },
+    { MAVLINK_MSG_ID_SYS_STATUS, MAVLINK_MSG_ID_SYS_STATUS_LEN, 2, MAV_DATA_STREAM_EXTENDED_STATUS, TELEMETRY_PRIORITY_MEDIUM, 0, true, mavlinkPackSystemStatus },
+    { MAVLINK_MSG_ID_RC_CHANNELS_RAW, MAVLINK_MSG_ID_RC_CHANNELS_RAW_LEN, 5, MAV_DATA_STREAM_RC_CHANNELS, TELEMETRY_PRIORITY_LOW, 4, true, mavlinkPackRCChannelsAndRSSI },
+#if defined(USE_GPS)
+    { MAVLINK_MSG_ID_GPS_RAW_INT, MAVLINK_MSG_ID_GPS_RAW_INT_LEN, 2, MAV_DATA_STREAM_POSITION, TELEMETRY_PRIORITY_LOW, 8, true, mavlinkPackGpsRawInt },
+    { MAVLINK_MSG_ID_GLOBAL_POSITION_INT, MAVLINK_MSG_ID_GLOBAL_POSITION_INT_LEN, 2, MAV_DATA_STREAM_POSITION, TELEMETRY_PRIORITY_LOW, 4, true, mavlinkPackGlobalPositionInt },
+    { MAVLINK_MSG_ID_GPS_GLOBAL_ORIGIN, MAVLINK_MSG_ID_GPS_GLOBAL_ORIGIN_LEN, 2, MAV_DATA_STREAM_POSITION, TELEMETRY_PRIORITY_LOW, 0, true, mavlinkPackGpsGlobalOrigin },
+#endif
+    { MAVLINK_MSG_ID_ATTITUDE, MAVLINK_MSG_ID_ATTITUDE_LEN, 10, MAV_DATA_STREAM_EXTRA1, TELEMETRY_PRIORITY_MEDIUM, 4, true, mavlinkPackAttitude },
+    { MAVLINK_MSG_ID_ATTITUDE_QUATERNION, MAVLINK_MSG_ID_ATTITUDE_QUATERNION_LEN, 0, MAV_DATA_STREAM_ENUM_END, TELEMETRY_PRIORITY_MEDIUM, 4, true, mavlinkPackAttitudeQuaternion },
+    { MAVLINK_MSG_ID_VFR_HUD, MAVLINK_MSG_ID_VFR_HUD_LEN, 10, MAV_DATA_STREAM_EXTRA2, TELEMETRY_PRIORITY_LOW, 0, true, mavlinkPackVfrHud },
+};
+
+#define MAVLINK_MESSAGE_COUNT ARRAYLEN(mavlinkMessages)
+
+static telemetrySchedulerItem_t mavlinkScheduleItems[MAVLINK_MESSAGE_COUNT];
+static telemetryScheduler_t mavlinkScheduler;
+
+// an interval of 0 switches the message off
+static void mavlinkSetMessageInterval(int index, timeDelta_t intervalUs)
+{
+    if (intervalUs > 0) {
+        intervalUs = MAX(intervalUs, TELEMETRY_MAVLINK_MIN_INTERVAL_US);
+    }
+    telemetrySchedulerSetInterval(&mavlinkScheduler, index, intervalUs);
+}
+
+static void mavlinkSetMessageRate(int index, uint16_t rateHz)
+{
+    mavlinkSetMessageInterval(index, rateHz ? (1000 * 1000) / rateHz : 0);
 }
 
-void processMAVLinkTelemetry(void)
+static void mavlinkInitMessageSchedule(void)
 {
-    // is executed @ TELEMETRY_MAVLINK_MAXRATE rate
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTENDED_STATUS)) {
-        mavlinkSendSystemStatus();
+    telemetrySchedulerInit(&mavlinkScheduler, mavlinkScheduleItems, MAVLINK_MESSAGE_COUNT, false);
+    for (unsigned i = 0; i < MAVLINK_MESSAGE_COUNT; i++) {
+        const mavlinkMessage_t *message = &mavlinkMessages[i];
+        // the cost is the whole packet, so messages are only sent when they fit into the transmit buffer
+        telemetrySchedulerAdd(&mavlinkScheduler, message->msgId, TELEMETRY_MAVLINK_MAXRATE, message->priority, MAVLINK_NUM_NON_PAYLOAD_BYTES + message->payloadLength);
+        mavlinkSetMessageRate(i, message->defaultRateHz);
     }
+}
 
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_RC_CHANNELS)) {
-        mavlinkSendRCChannelsAndRSSI();
+static int mavlinkFindMessage(int msgId)
+{
+    for (unsigned i = 0; i < MAVLINK_MESSAGE_COUNT; i++) {
+        if (mavlinkMessages[i].msgId == msgId) {
+            return i;
+        }
     }
+    return -1;
+}
+
+static bool mavlinkIsForUs(uint8_t targetSystem, uint8_t targetComponent)
+{
+    return (targetSystem == 0 || targetSystem == TELEMETRY_MAVLINK_SYSTEM_ID)
+        && (targetComponent == 0 || targetComponent == TELEMETRY_MAVLINK_COMPONENT_ID);
+}
 
-#ifdef USE_GPS
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_POSITION)) {
-        mavlinkSendPosition();
+static uint8_t mavlinkSetMessageIntervalCommand(const mavlink_command_long_t *command)
+{
+    // param1 is the message id, param2 the interval in us, -1 to switch the message off and 0 for its default rate
+    const int index = mavlinkFindMessage(command->param1);
+    if (index < 0) {
+        return MAV_RESULT_DENIED;
     }
-#endif
 
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTRA1)) {
-        mavlinkSendAttitude();
+    if (command->param2 < 0) {
+        mavlinkSetMessageInterval(index, 0);
+    } else if (command->param2 == 0) {
+        mavlinkSetMessageRate(index, mavlinkMessages[index].defaultRateHz);
+    } else {
+        mavlinkSetMessageInterval(index, MIN(command->param2, TELEMETRY_MAVLINK_MAX_INTERVAL_US));
+    }
+    return MAV_RESULT_ACCEPTED;
+}
+
+static void mavlinkHandleCommandLong(const mavlink_message_t *msg)
+{
+    mavlink_command_long_t command;
+    mavlink_msg_command_long_decode(msg, &command);
+
+    if (!mavlinkIsForUs(command.target_system, command.target_component)) {
+        return;
+    }
+
+    uint8_t result;
+    switch (command.command) {
+    case MAVLINK_CMD_SET_MESSAGE_INTERVAL:
+        result = mavlinkSetMessageIntervalCommand(&command);
+        break;
+    default:
+        result = MAV_RESULT_UNSUPPORTED;
+        break;
+    }
+
+    // the ground station repeats the command if the ack is lost
+    if (serialTxBytesFree(mavlinkPort) >= MAVLINK_NUM_NON_PAYLOAD_BYTES + MAVLINK_MSG_ID_COMMAND_ACK_LEN) {
+        mavlink_msg_command_ack_pack(TELEMETRY_MAVLINK_SYSTEM_ID, TELEMETRY_MAVLINK_COMPONENT_ID, &mavMsg, command.command, result);
+        mavlinkSendMessage(&mavMsg);
+    }
+}
+
+static void mavlinkHandleRequestDataStream(const mavlink_message_t *msg)
+{
+    mavlink_request_data_stream_t request;
+    mavlink_msg_request_data_stream_decode(msg, &request);
+
+    if (!mavlinkIsForUs(request.target_system, request.target_component)) {
+        return;
     }
 
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTRA2)) {
-        mavlinkSendHUDAndHeartbeat();
+    const uint16_t rateHz = request.start_stop ? request.req_message_rate : 0;
+    for (unsigned i = 0; i < MAVLINK_MESSAGE_COUNT; i++) {
+        const uint8_t stream = mavlinkMessages[i].stream;
+        if (stream == request.req_stream_id || (request.req_stream_id == MAV_DATA_STREAM_ALL && stream != MAV_DATA_STREAM_ENUM_END)) {
+            mavlinkSetMessageRate(i, rateHz);
+        }
+    }
+}
+
+static void processMAVLinkIncoming(void)
+{
+    mavlink_status_t status;
+
+    while (serialRxBytesWaiting(mavlinkPort)) {
+        if (!mavlink_parse_char(MAVLINK_COMM_0, serialRead(mavlinkPort), &mavRxMsg, &status)) {
+            continue;
+        }
+
+        switch (mavRxMsg.msgid) {
+        case MAVLINK_MSG_ID_COMMAND_LONG:
+            mavlinkHandleCommandLong(&mavRxMsg);
+            break;
+        case MAVLINK_MSG_ID_REQUEST_DATA_STREAM:
+            mavlinkHandleRequestDataStream(&mavRxMsg);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+static void processMAVLinkTelemetry(timeUs_t currentTimeUs)
+{
+    loopStateRead(&loopState);
+
+    // send what is due for as long as it fits into the transmit buffer, most urgent first
+    int index;
+    while ((index = telemetrySchedulerNext(&mavlinkScheduler, currentTimeUs, MIN(serialTxBytesFree(mavlinkPort), (uint32_t)UINT16_MAX))) >= 0) {
+        telemetrySchedulerMarkSent(&mavlinkScheduler, index, currentTimeUs);
+
+        const mavlinkMessage_t *message = &mavlinkMessages[index];
+        if (!message->pack(&mavMsg)) {
+            continue;
+        }
+
+        if (message->coalesce && mavlinkScheduleItems[index].intervalUs >= TELEMETRY_MAVLINK_COALESCE_INTERVAL_US) {
+            const uint8_t *payload = (const uint8_t *)_MAV_PAYLOAD(&mavMsg) + message->timestampLength;
+            const uint16_t payloadHash = crc16_ccitt_update(0, payload, mavMsg.len - message->timestampLength);
+            if (!telemetrySchedulerValueChanged(&mavlinkScheduler, index, payloadHash, currentTimeUs)) {
+                // packing used up a sequence number, give it back so the ground station doesn't count a lost packet
+                mavlink_get_channel_status(MAVLINK_COMM_0)->current_tx_seq--;
+                continue;
+            }
+        }
+
+        mavlinkSendMessage(&mavMsg);
     }
 }
 
@@ -565,11 +752,11 @@ void handleMAVLinkTelemetry(void)
         return;
     }
 
-    uint32_t now = micros();
-    if ((now - lastMavlinkMessage) >= TELEMETRY_MAVLINK_DELAY) {
-        processMAVLinkTelemetry();
-        lastMavlinkMessage = now;
+    if (!mavlinkPortShared) {
+        processMAVLinkIncoming();
     }
+
+    processMAVLinkTelemetry(micros());
 }
 
 #endif
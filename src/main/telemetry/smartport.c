@@ -77,6 +77,7 @@
 #include "rx/rx.h"
 
 #include "telemetry/telemetry.h"
+#include "telemetry/telemetry_scheduler.h"
 #include "telemetry/smartport.h"
 #include "telemetry/msp_shared.h"
 
@@ -145,9 +146,11 @@ enum
 };
 
 // if adding more sensors then increase this value
-#define MAX_DATAIDS 17
+#define MAX_DATAIDS 16
 
-static uint16_t frSkyDataIdTable[MAX_DATAIDS];
+static telemetrySchedulerItem_t smartPortSchedulerItems[MAX_DATAIDS];
+static telemetryScheduler_t smartPortScheduler;
+static int smartPortSchedulerIndex = -1;    // item being answered, -1 for the ESC sensors
 
 #ifdef USE_ESC_SENSOR
 // number of sensors to send between sending the ESC sensors
@@ -161,14 +164,13 @@ static uint16_t frSkyEscDataIdTable[] = {
 };
 #endif
 
+#ifdef USE_ESC_SENSOR
 typedef struct frSkyTableInfo_s {
     uint16_t * table;
     uint8_t size;
     uint8_t index;
 } frSkyTableInfo_t;
 
-static frSkyTableInfo_t frSkyDataIdTableInfo = { frSkyDataIdTable, 0, 0 };
-#ifdef USE_ESC_SENSOR
 #define ESC_DATAID_COUNT ( sizeof(frSkyEscDataIdTable) / sizeof(uint16_t) )
 
 static frSkyTableInfo_t frSkyEscDataIdTableInfo = {frSkyEscDataIdTable, ESC_DATAID_COUNT, 0};
@@ -306,14 +308,23 @@ static void smartPortWriteFrameInternal(const smartPortPayload_t *payload)
     smartPortWriteFrameSerial(payload, smartPortSerialPort, 0);
 }
 
-static void smartPortSendPackage(uint16_t id, uint32_t val)
+/*
+ * Returns false without sending if the scheduler says the value hasn't changed since it was last sent,
+ * so the request slot can be used for another sensor.
+ */
+static bool smartPortSendPackage(uint16_t id, uint32_t val)
 {
+    if (smartPortSchedulerIndex >= 0 && !telemetrySchedulerValueChanged(&smartPortScheduler, smartPortSchedulerIndex, val, micros())) {
+        return false;
+    }
+
     smartPortPayload_t payload;
     payload.frameId = FSSP_DATA_FRAME;
     payload.valueId = id;
     payload.data = val;
 
     smartPortWriteFrame(&payload);
+    return true;
 }
 
 #ifdef USE_ESC_SENSOR
@@ -322,24 +333,25 @@ static bool reportExtendedEscSensors(void) {
 }
 #endif
 
-#define ADD_SENSOR(dataId) frSkyDataIdTableInfo.table[frSkyDataIdTableInfo.index++] = dataId
+// every answer takes one request slot; slots the rates don't use are filled with whatever is due soonest
+#define ADD_SENSOR(dataId, rateHz, priority) telemetrySchedulerAdd(&smartPortScheduler, dataId, rateHz, priority, 1)
 
 static void initSmartPortSensors(void)
 {
-    frSkyDataIdTableInfo.index = 0;
+    telemetrySchedulerInit(&smartPortScheduler, smartPortSchedulerItems, MAX_DATAIDS, true);
 
-    ADD_SENSOR(FSSP_DATAID_T1);
-    ADD_SENSOR(FSSP_DATAID_T2);
+    ADD_SENSOR(FSSP_DATAID_T1, 2, TELEMETRY_PRIORITY_MEDIUM);
+    ADD_SENSOR(FSSP_DATAID_T2, 1, TELEMETRY_PRIORITY_LOW);
 
     if (isBatteryVoltageConfigured()) {
 #ifdef USE_ESC_SENSOR
         if (!reportExtendedEscSensors())
 #endif
         {
-            ADD_SENSOR(FSSP_DATAID_VFAS);
+            ADD_SENSOR(FSSP_DATAID_VFAS, 5, TELEMETRY_PRIORITY_HIGH);
         }
 
-        ADD_SENSOR(FSSP_DATAID_A4);
+        ADD_SENSOR(FSSP_DATAID_A4, 5, TELEMETRY_PRIORITY_HIGH);
     }
 
     if (isAmperageConfigured()) {
@@ -347,37 +359,33 @@ static void initSmartPortSensors(void)
         if (!reportExtendedEscSensors())
 #endif
         {
-            ADD_SENSOR(FSSP_DATAID_CURRENT);
+            ADD_SENSOR(FSSP_DATAID_CURRENT, 5, TELEMETRY_PRIORITY_HIGH);
         }
 
-        ADD_SENSOR(FSSP_DATAID_FUEL);
+        ADD_SENSOR(FSSP_DATAID_FUEL, 1, TELEMETRY_PRIORITY_MEDIUM);
     }
 
     if (sensors(SENSOR_ACC)) {
-        ADD_SENSOR(FSSP_DATAID_HEADING);
-        ADD_SENSOR(FSSP_DATAID_ACCX);
-        ADD_SENSOR(FSSP_DATAID_ACCY);
-        ADD_SENSOR(FSSP_DATAID_ACCZ);
+        ADD_SENSOR(FSSP_DATAID_HEADING, 5, TELEMETRY_PRIORITY_MEDIUM);
+        ADD_SENSOR(FSSP_DATAID_ACCX, 2, TELEMETRY_PRIORITY_LOW);
+        ADD_SENSOR(FSSP_DATAID_ACCY, 2, TELEMETRY_PRIORITY_LOW);
+        ADD_SENSOR(FSSP_DATAID_ACCZ, 2, TELEMETRY_PRIORITY_LOW);
     }
 
     if (sensors(SENSOR_BARO)) {
-        ADD_SENSOR(FSSP_DATAID_ALTITUDE);
-        ADD_SENSOR(FSSP_DATAID_VARIO);
+        ADD_SENSOR(FSSP_DATAID_ALTITUDE, 5, TELEMETRY_PRIORITY_MEDIUM);
+        ADD_SENSOR(FSSP_DATAID_VARIO, 10, TELEMETRY_PRIORITY_MEDIUM);
     }
 
 #ifdef USE_GPS
     if (feature(FEATURE_GPS)) {
-        ADD_SENSOR(FSSP_DATAID_SPEED);
-        ADD_SENSOR(FSSP_DATAID_LATLONG);
-        ADD_SENSOR(FSSP_DATAID_LATLONG); // twice (one for lat, one for long)
-        ADD_SENSOR(FSSP_DATAID_HOME_DIST);
-        ADD_SENSOR(FSSP_DATAID_GPS_ALT);
+        ADD_SENSOR(FSSP_DATAID_SPEED, 2, TELEMETRY_PRIORITY_MEDIUM);
+        ADD_SENSOR(FSSP_DATAID_LATLONG, 4, TELEMETRY_PRIORITY_MEDIUM); // alternates between lat and long
+        ADD_SENSOR(FSSP_DATAID_HOME_DIST, 1, TELEMETRY_PRIORITY_LOW);
+        ADD_SENSOR(FSSP_DATAID_GPS_ALT, 1, TELEMETRY_PRIORITY_LOW);
     }
 #endif
 
-    frSkyDataIdTableInfo.size = frSkyDataIdTableInfo.index;
-    frSkyDataIdTableInfo.index = 0;
-
 #ifdef USE_ESC_SENSOR
     if (reportExtendedEscSensors()) {
         frSkyEscDataIdTableInfo.size = ESC_DATAID_COUNT;
@@ -465,6 +473,9 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
     static uint8_t smartPortIdCycleCnt = 0;
     static uint8_t t1Cnt = 0;
     static uint8_t t2Cnt = 0;
+#ifdef USE_GPS
+    static bool sendLongitude = false;
+#endif
     static uint8_t skipRequests = 0;
 #ifdef USE_ESC_SENSOR
     static uint8_t smartPortIdOffset = 0;
@@ -493,6 +504,7 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
 #endif
 
     bool doRun = true;
+    int sensorsTried = 0;
     while (doRun && *clearToSend && !skipRequests) {
         // Ensure we won't get stuck in the loop if there happens to be nothing available to send in a timely manner - dump the slot if we loop in there for too long.
         if (requestTimeout) {
@@ -514,13 +526,14 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
         }
 #endif
 
-        // we can send back any data we want, our tables keep track of the order and frequency of each data type we send
-        frSkyTableInfo_t * tableInfo = &frSkyDataIdTableInfo;
+        // we can send back any data we want, the scheduler keeps track of the order and frequency of each data type we send
+        uint16_t id = 0;
+        smartPortSchedulerIndex = -1;
 
 #ifdef USE_ESC_SENSOR
         if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD) {
             // send ESC sensors
-            tableInfo = &frSkyEscDataIdTableInfo;
+            frSkyTableInfo_t *tableInfo = &frSkyEscDataIdTableInfo;
             if (tableInfo->index == tableInfo->size) { // end of ESC table, return to other sensors
                 tableInfo->index = 0;
                 smartPortIdCycleCnt = 0;
@@ -528,26 +541,26 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                 if (smartPortIdOffset == getMotorCount() + 1) { // each motor and ESC_SENSOR_COMBINED
                     smartPortIdOffset = 0;
                 }
+            } else {
+                id = tableInfo->table[tableInfo->index++] + smartPortIdOffset;
             }
         }
-        if (smartPortIdCycleCnt < ESC_SENSOR_PERIOD) {
-            // send other sensors
-            tableInfo = &frSkyDataIdTableInfo;
+        if (smartPortIdCycleCnt < ESC_SENSOR_PERIOD)
 #endif
-            if (tableInfo->index == tableInfo->size) { // end of table reached, loop back
-                tableInfo->index = 0;
+        {
+            // send other sensors, each gets one look per request; if none of them is due or
+            // has changed there is nothing to send and the slot is left empty
+            const timeUs_t currentTimeUs = micros();
+            smartPortSchedulerIndex = sensorsTried++ < smartPortScheduler.count ? telemetrySchedulerNext(&smartPortScheduler, currentTimeUs, 1) : -1;
+            if (smartPortSchedulerIndex < 0) {
+                *clearToSend = false;
+
+                return;
             }
-#ifdef USE_ESC_SENSOR
+            telemetrySchedulerMarkSent(&smartPortScheduler, smartPortSchedulerIndex, currentTimeUs);
+            id = smartPortScheduler.items[smartPortSchedulerIndex].id;
         }
-#endif
-        uint16_t id = tableInfo->table[tableInfo->index];
-#ifdef USE_ESC_SENSOR
-        if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD) {
-            id += smartPortIdOffset;
-        }
-#endif
         smartPortIdCycleCnt++;
-        tableInfo->index++;
 
         int32_t tmpi;
         uint32_t tmp2 = 0;
@@ -565,8 +578,7 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                     cellCount = getBatteryCellCount();
                     vfasVoltage = cellCount ? getBatteryVoltage() / cellCount : 0;
                 }
-                smartPortSendPackage(id, vfasVoltage * 10); // given in 0.1V, convert to volts
-                *clearToSend = false;
+                *clearToSend = !smartPortSendPackage(id, vfasVoltage * 10); // given in 0.1V, convert to volts
                 break;
 #ifdef USE_ESC_SENSOR
             case FSSP_DATAID_VFAS1      :
@@ -579,14 +591,12 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
             case FSSP_DATAID_VFAS8      :
                 escData = getEscSensorData(id - FSSP_DATAID_VFAS1);
                 if (escData != NULL) {
-                    smartPortSendPackage(id, escData->voltage);
-                    *clearToSend = false;
+                    *clearToSend = !smartPortSendPackage(id, escData->voltage);
                 }
                 break;
 #endif
             case FSSP_DATAID_CURRENT    :
-                smartPortSendPackage(id, getAmperage() / 10); // given in 10mA steps, unknown requested unit
-                *clearToSend = false;
+                *clearToSend = !smartPortSendPackage(id, getAmperage() / 10); // given in 10mA steps, unknown requested unit
                 break;
 #ifdef USE_ESC_SENSOR
             case FSSP_DATAID_CURRENT1   :
@@ -599,15 +609,13 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
             case FSSP_DATAID_CURRENT8   :
                 escData = getEscSensorData(id - FSSP_DATAID_CURRENT1);
                 if (escData != NULL) {
-                    smartPortSendPackage(id, escData->current);
-                    *clearToSend = false;
+                    *clearToSend = !smartPortSendPackage(id, escData->current);
                 }
                 break;
             case FSSP_DATAID_RPM        :
                 escData = getEscSensorData(ESC_SENSOR_COMBINED);
                 if (escData != NULL) {
-                    smartPortSendPackage(id, calcEscRpm(escData->rpm));
-                    *clearToSend = false;
+                    *clearToSend = !smartPortSendPackage(id, calcEscRpm(escData->rpm));
                 }
                 break;
             case FSSP_DATAID_RPM1       :
@@ -620,15 +628,13 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
             case FSSP_DATAID_RPM8       :
                 escData = getEscSensorData(id - FSSP_DATAID_RPM1);
                 if (escData != NULL) {
-                    smartPortSendPackage(id, calcEscRpm(escData->rpm));
-                    *clearToSend = false;
+                    *clearToSend = !smartPortSendPackage(id, calcEscRpm(escData->rpm));
                 }
                 break;
             case FSSP_DATAID_TEMP        :
                 escData = getEscSensorData(ESC_SENSOR_COMBINED);
                 if (escData != NULL) {
-                    smartPortSendPackage(id, escData->temperature);
-                    *clearToSend = false;
+                    *clearToSend = !smartPortSendPackage(id, escData->temperature);
                 }
                 break;
             case FSSP_DATAID_TEMP1      :
@@ -641,38 +647,30 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
             case FSSP_DATAID_TEMP8      :
                 escData = getEscSensorData(id - FSSP_DATAID_TEMP1);
                 if (escData != NULL) {
-                    smartPortSendPackage(id, escData->temperature);
-                    *clearToSend = false;
+                    *clearToSend = !smartPortSendPackage(id, escData->temperature);
                 }
                 break;
 #endif
             case FSSP_DATAID_ALTITUDE   :
-                smartPortSendPackage(id, getEstimatedAltitude()); // unknown given unit, requested 100 = 1 meter
-                *clearToSend = false;
+                *clearToSend = !smartPortSendPackage(id, getEstimatedAltitude()); // unknown given unit, requested 100 = 1 meter
                 break;
             case FSSP_DATAID_FUEL       :
-                smartPortSendPackage(id, getMAhDrawn()); // given in mAh, unknown requested unit
-                *clearToSend = false;
+                *clearToSend = !smartPortSendPackage(id, getMAhDrawn()); // given in mAh, unknown requested unit
                 break;
             case FSSP_DATAID_VARIO      :
-                smartPortSendPackage(id, getEstimatedVario()); // unknown given unit but requested in 100 = 1m/s
-                *clearToSend = false;
+                *clearToSend = !smartPortSendPackage(id, getEstimatedVario()); // unknown given unit but requested in 100 = 1m/s
                 break;
             case FSSP_DATAID_HEADING    :
-                smartPortSendPackage(id, attitude.values.yaw * 10); // given in 10*deg, requested in 10000 = 100 deg
-                *clearToSend = false;
+                *clearToSend = !smartPortSendPackage(id, attitude.values.yaw * 10); // given in 10*deg, requested in 10000 = 100 deg
                 break;
             case FSSP_DATAID_ACCX       :
-                smartPortSendPackage(id, lrintf(100 * acc.accADC[X] / acc.dev.acc_1G)); // Multiply by 100 to show as x.xx g on Taranis
-                *clearToSend = false;
+                *clearToSend = !smartPortSendPackage(id, lrintf(100 * acc.accADC[X] / acc.dev.acc_1G)); // Multiply by 100 to show as x.xx g on Taranis
                 break;
             case FSSP_DATAID_ACCY       :
-                smartPortSendPackage(id, lrintf(100 * acc.accADC[Y] / acc.dev.acc_1G));
-                *clearToSend = false;
+                *clearToSend = !smartPortSendPackage(id, lrintf(100 * acc.accADC[Y] / acc.dev.acc_1G));
                 break;
             case FSSP_DATAID_ACCZ       :
-                smartPortSendPackage(id, lrintf(100 * acc.accADC[Z] / acc.dev.acc_1G));
-                *clearToSend = false;
+                *clearToSend = !smartPortSendPackage(id, lrintf(100 * acc.accADC[Z] / acc.dev.acc_1G));
                 break;
             case FSSP_DATAID_T1         :
                 // we send all the flags as decimal digits for easy reading
@@ -722,18 +720,15 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                     tmpi += 4000;
                 }
 
-                smartPortSendPackage(id, (uint32_t)tmpi);
-                *clearToSend = false;
+                *clearToSend = !smartPortSendPackage(id, (uint32_t)tmpi);
                 break;
             case FSSP_DATAID_T2         :
 #ifdef USE_GPS
                 if (sensors(SENSOR_GPS)) {
                     // provide GPS lock status
-                    smartPortSendPackage(id, (STATE(GPS_FIX) ? 1000 : 0) + (STATE(GPS_FIX_HOME) ? 2000 : 0) + gpsSol.numSat);
-                    *clearToSend = false;
+                    *clearToSend = !smartPortSendPackage(id, (STATE(GPS_FIX) ? 1000 : 0) + (STATE(GPS_FIX_HOME) ? 2000 : 0) + gpsSol.numSat);
                 } else if (feature(FEATURE_GPS)) {
-                    smartPortSendPackage(id, 0);
-                    *clearToSend = false;
+                    *clearToSend = !smartPortSendPackage(id, 0);
                 } else
 #endif
                 if (telemetryConfig()->pidValuesAsTelemetry) {
@@ -764,8 +759,7 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                     if (t2Cnt == 4) {
                         t2Cnt = 0;
                     }
-                    smartPortSendPackage(id, tmp2);
-                    *clearToSend = false;
+                    *clearToSend = !smartPortSendPackage(id, tmp2);
                 }
                 break;
 #ifdef USE_GPS
@@ -774,8 +768,7 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                     //convert to knots: 1cm/s = 0.0194384449 knots
                     //Speed should be sent in knots/1000 (GPS speed is in cm/s)
                     uint32_t tmpui = gpsSol.groundSpeed * 1944 / 100;
-                    smartPortSendPackage(id, tmpui);
-                    *clearToSend = false;
+                    *clearToSend = !smartPortSendPackage(id, tmpui);
                 }
                 break;
             case FSSP_DATAID_LATLONG    :
@@ -783,8 +776,8 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                     uint32_t tmpui = 0;
                     // the same ID is sent twice, one for longitude, one for latitude
                     // the MSB of the sent uint32_t helps FrSky keep track
-                    // the even/odd bit of our counter helps us keep track
-                    if (tableInfo->index & 1) {
+                    sendLongitude = !sendLongitude;
+                    if (sendLongitude) {
                         tmpui = abs(gpsSol.llh.lon);  // now we have unsigned value and one bit to spare
                         tmpui = (tmpui + tmpui / 2) / 25 | 0x80000000;  // 6/100 = 1.5/25, division by power of 2 is fast
                         if (gpsSol.llh.lon < 0) tmpui |= 0x40000000;
@@ -794,28 +787,24 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                         tmpui = (tmpui + tmpui / 2) / 25;  // 6/100 = 1.5/25, division by power of 2 is fast
                         if (gpsSol.llh.lat < 0) tmpui |= 0x40000000;
                     }
-                    smartPortSendPackage(id, tmpui);
-                    *clearToSend = false;
+                    *clearToSend = !smartPortSendPackage(id, tmpui);
                 }
                 break;
             case FSSP_DATAID_HOME_DIST  :
                 if (STATE(GPS_FIX)) {
-                    smartPortSendPackage(id, GPS_distanceToHome);
-                     *clearToSend = false;
+                    *clearToSend = !smartPortSendPackage(id, GPS_distanceToHome);
                 }
                 break;
             case FSSP_DATAID_GPS_ALT    :
                 if (STATE(GPS_FIX)) {
-                    smartPortSendPackage(id, gpsSol.llh.alt); // given in 0.01m
-                    *clearToSend = false;
+                    *clearToSend = !smartPortSendPackage(id, gpsSol.llh.alt); // given in 0.01m
                 }
                 break;
 #endif
             case FSSP_DATAID_A4         :
                 cellCount = getBatteryCellCount();
                 vfasVoltage = cellCount ? (getBatteryVoltage() * 10 / cellCount) : 0; // given in 0.1V, convert to volts
-                smartPortSendPackage(id, vfasVoltage);
-                *clearToSend = false;
+                *clearToSend = !smartPortSendPackage(id, vfasVoltage);
                 break;
             default:
                 break;
@@ -0,0 +1,155 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Telemetry sensor scheduler shared by the telemetry backends.
+ *
+ * Each sensor (or frame type) is registered with the rate it wants, a priority and what one update
+ * costs on the link. Whenever the backend has room on the link it asks for the next item to send:
+ * due items are picked by priority, and every whole period an item has been waiting raises its
+ * priority by one so that slow, low priority sensors still get through on a congested link.
+ * Backends can also drop an update whose value hasn't changed, leaving the slot to something else.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_TELEMETRY
+
+#include "common/maths.h"
+
+#include "telemetry/telemetry_scheduler.h"
+
+#define TELEMETRY_SCHEDULER_MAX_AGE_BOOST   64
+
+void telemetrySchedulerInit(telemetryScheduler_t *scheduler, telemetrySchedulerItem_t *items, uint8_t capacity, bool fillIdle)
+{
+    scheduler->items = items;
+    scheduler->capacity = capacity;
+    scheduler->count = 0;
+    scheduler->fillIdle = fillIdle;
+}
+
+bool telemetrySchedulerAdd(telemetryScheduler_t *scheduler, uint16_t id, uint8_t rateHz, telemetryPriority_e priority, uint8_t cost)
+{
+    if (rateHz == 0 || scheduler->count >= scheduler->capacity) {
+        return false;
+    }
+
+    telemetrySchedulerItem_t *item = &scheduler->items[scheduler->count++];
+    item->id = id;
+    item->intervalUs = 1000000 / rateHz;
+    item->priority = priority;
+    item->cost = cost;
+    item->dueUs = 0;
+    item->lastSentUs = 0;
+    item->lastValue = 0;
+    item->lastValueValid = false;
+    return true;
+}
+
+/*
+ * Returns the index of the item to send next within the given link budget, or -1 if there is none.
+ */
+int telemetrySchedulerNext(const telemetryScheduler_t *scheduler, timeUs_t currentTimeUs, uint16_t budget)
+{
+    int best = -1;
+    int bestScore = 0;
+    timeDelta_t bestLateness = 0;
+
+    for (int i = 0; i < scheduler->count; i++) {
+        const telemetrySchedulerItem_t *item = &scheduler->items[i];
+        if (item->intervalUs <= 0 || item->cost > budget) {
+            continue;
+        }
+
+        timeDelta_t lateness = cmpTimeUs(currentTimeUs, item->dueUs);
+        if (lateness < -item->intervalUs) {
+            // never sent, or not for so long that the timer wrapped
+            lateness = TELEMETRY_SCHEDULER_MAX_AGE_BOOST * item->intervalUs;
+        }
+
+        int score;
+        if (lateness >= 0) {
+            score = item->priority + MIN(lateness / item->intervalUs, TELEMETRY_SCHEDULER_MAX_AGE_BOOST);
+        } else if (scheduler->fillIdle) {
+            // below anything that is due, closest to due relative to its own period first so that
+            // idle slots are shared out in proportion to the requested rates
+            score = -1;
+            lateness = lateness * 1024 / item->intervalUs;
+        } else {
+            continue;
+        }
+
+        if (best < 0 || score > bestScore || (score == bestScore && lateness > bestLateness)) {
+            best = i;
+            bestScore = score;
+            bestLateness = lateness;
+        }
+    }
+
+    return best;
+}
+
+/*
+ * Changes the rate of an item at runtime, an interval of 0 switches it off. The new rate starts
+ * with an update right away.
+ */
+void telemetrySchedulerSetInterval(telemetryScheduler_t *scheduler, int index, timeDelta_t intervalUs)
+{
+    telemetrySchedulerItem_t *item = &scheduler->items[index];
+
+    item->intervalUs = MAX(intervalUs, 0);
+    item->dueUs = 0;
+}
+
+void telemetrySchedulerMarkSent(telemetryScheduler_t *scheduler, int index, timeUs_t currentTimeUs)
+{
+    telemetrySchedulerItem_t *item = &scheduler->items[index];
+    const timeDelta_t lateness = cmpTimeUs(currentTimeUs, item->dueUs);
+
+    if (lateness >= 0 && lateness < item->intervalUs) {
+        item->dueUs += item->intervalUs;    // keep the cadence
+    } else {
+        item->dueUs = currentTimeUs + item->intervalUs;
+    }
+}
+
+/*
+ * Returns false if value is the same as the one last sent for this item and the keepalive hasn't
+ * expired yet. Otherwise records value as sent and returns true.
+ */
+bool telemetrySchedulerValueChanged(telemetryScheduler_t *scheduler, int index, uint32_t value, timeUs_t currentTimeUs)
+{
+    telemetrySchedulerItem_t *item = &scheduler->items[index];
+
+    if (item->lastValueValid && item->lastValue == value
+        && cmpTimeUs(currentTimeUs, item->lastSentUs) < TELEMETRY_SCHEDULER_KEEPALIVE_US) {
+        return false;
+    }
+
+    item->lastValue = value;
+    item->lastValueValid = true;
+    item->lastSentUs = currentTimeUs;
+    return true;
+}
+#endif
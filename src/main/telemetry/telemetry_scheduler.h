@@ -0,0 +1,61 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+
+// an unchanged value is still sent at least this often so the receiving end doesn't flag the sensor as lost
+#define TELEMETRY_SCHEDULER_KEEPALIVE_US    1000000
+
+// a due item gains one priority step for every period it has been waiting
+typedef enum {
+    TELEMETRY_PRIORITY_LOW = 0,
+    TELEMETRY_PRIORITY_MEDIUM = 8,
+    TELEMETRY_PRIORITY_HIGH = 16,
+} telemetryPriority_e;
+
+typedef struct telemetrySchedulerItem_s {
+    timeUs_t dueUs;
+    timeUs_t lastSentUs;
+    timeDelta_t intervalUs;     // 0 if the item is switched off
+    uint32_t lastValue;
+    uint16_t id;            // backend specific sensor or frame id
+    uint8_t priority;
+    uint8_t cost;           // link budget units (bytes, slots) one update takes
+    bool lastValueValid;
+} telemetrySchedulerItem_t;
+
+typedef struct telemetryScheduler_s {
+    telemetrySchedulerItem_t *items;
+    uint8_t capacity;
+    uint8_t count;
+    bool fillIdle;          // also hand out items that aren't due yet, for polled links where an unused slot is lost
+} telemetryScheduler_t;
+
+void telemetrySchedulerInit(telemetryScheduler_t *scheduler, telemetrySchedulerItem_t *items, uint8_t capacity, bool fillIdle);
+bool telemetrySchedulerAdd(telemetryScheduler_t *scheduler, uint16_t id, uint8_t rateHz, telemetryPriority_e priority, uint8_t cost);
+int telemetrySchedulerNext(const telemetryScheduler_t *scheduler, timeUs_t currentTimeUs, uint16_t budget);
+void telemetrySchedulerSetInterval(telemetryScheduler_t *scheduler, int index, timeDelta_t intervalUs);
+void telemetrySchedulerMarkSent(telemetryScheduler_t *scheduler, int index, timeUs_t currentTimeUs);
+bool telemetrySchedulerValueChanged(telemetryScheduler_t *scheduler, int index, uint32_t value, timeUs_t currentTimeUs);
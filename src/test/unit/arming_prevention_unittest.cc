@@ -813,8 +813,10 @@ extern "C" {
     void pidStabilisationState(pidStabilisationState_e) {}
     void mixTable(timeUs_t , uint8_t) {};
     void writeMotors(void) {};
+    void loopStatePublish(timeUs_t) {};
     void writeServos(void) {};
     bool calculateRxChannelsAndUpdateFailsafe(timeUs_t) { return true; }
+    timeUs_t rxGetFrameTimeUs(void) { return 0; }
     bool isMixerUsingServos(void) { return false; }
     void gyroUpdate(timeUs_t) {}
     timeDelta_t getTaskDeltaTime(cfTaskId_e) { return 0; }
@@ -22,8 +22,12 @@
 
 #include <math.h>
 
+#include <algorithm>
+#include <chrono>
+
 extern "C" {
     #include "common/filter.h"
+    #include "common/maths.h"
 }
 
 #include "unittest_macros.h"
@@ -114,3 +118,125 @@ TEST(FilterUnittest, TestSlewFilter)
     slewFilterApply(&filter, 200.0f);
     EXPECT_EQ(200, filter.state);
 }
+
+static uint32_t randomState;
+
+static float randomSample(void)
+{
+    randomState = randomState * 1664525u + 1013904223u;
+    return (float)(randomState >> 20) - 2048.0f;
+}
+
+// median of the last count samples ending at sample[end], by sorting them
+static float referenceMedian(const float *sample, int end, int count)
+{
+    float sorted[255];
+    std::copy(sample + end + 1 - count, sample + end + 1, sorted);
+    std::sort(sorted, sorted + count);
+    return (count & 1) ? sorted[count / 2] : 0.5f * (sorted[count / 2 - 1] + sorted[count / 2]);
+}
+
+TEST(FilterUnittest, TestMedianFilterMatchesSort)
+{
+    static const uint8_t windowSizes[] = { 1, 2, 3, 5, 8, 31, 255 };
+    static float sample[2000];
+
+    for (unsigned w = 0; w < sizeof(windowSizes); w++) {
+        const int windowSize = windowSizes[w];
+        float buf[MEDIAN_FILTER_BUFFER_SIZE(255)];
+        medianFilter_t filter;
+        medianFilterInit(&filter, windowSize, buf);
+
+        randomState = windowSize;
+        for (int i = 0; i < 2000; i++) {
+            // with runs of equal values and steps, not just noise
+            sample[i] = (i % 97 < 20) ? 100.0f : randomSample() + ((i / 300) & 1) * 5000.0f;
+            const float median = medianFilterApply(&filter, sample[i]);
+            ASSERT_EQ(referenceMedian(sample, i, std::min(i + 1, windowSize)), median) << "window " << windowSize << " sample " << i;
+        }
+    }
+}
+
+TEST(FilterUnittest, TestMedianFilterRejectsSpikes)
+{
+    float buf[MEDIAN_FILTER_BUFFER_SIZE(5)];
+    medianFilter_t filter;
+    medianFilterInit(&filter, 5, buf);
+
+    for (int i = 0; i < 5; i++) {
+        medianFilterApply(&filter, 10.0f);
+    }
+    // single and double sample spikes don't get through a window of 5
+    EXPECT_EQ(10.0f, medianFilterApply(&filter, 2000.0f));
+    EXPECT_EQ(10.0f, medianFilterApply(&filter, -2000.0f));
+    EXPECT_EQ(10.0f, medianFilterApply(&filter, 10.0f));
+    EXPECT_EQ(10.0f, medianFilterApply(&filter, 2000.0f));
+    // a step does, once it fills more than half the window
+    EXPECT_EQ(2000.0f, medianFilterApply(&filter, 2000.0f));
+}
+
+#define BENCHMARK_SAMPLES   (32 * 1024)
+
+template <typename F>
+static void benchmarkNs(const char *name, F fn)
+{
+    volatile float sink = 0;
+    randomState = 1;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_SAMPLES; i++) {
+        sink = fn(randomSample());
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    printf("    %-26s %7.1f ns per sample\n", name, elapsed.count() / BENCHMARK_SAMPLES);
+    (void)sink;
+}
+
+TEST(FilterUnittest, BenchmarkMedianFilter)
+{
+    static float window[255];
+    static int next;
+    static float buf[MEDIAN_FILTER_BUFFER_SIZE(255)];
+    static medianFilter_t filter;
+
+    benchmarkNs("quickMedianFilter5f", [&](float x) {
+        window[next] = x;
+        next = (next + 1) % 5;
+        return quickMedianFilter5f(window);
+    });
+    benchmarkNs("quickMedianFilter9f", [&](float x) {
+        window[next] = x;
+        next = (next + 1) % 9;
+        return quickMedianFilter9f(window);
+    });
+
+    static const uint8_t windowSizes[] = { 5, 9, 31, 255 };
+    for (unsigned w = 0; w < sizeof(windowSizes); w++) {
+        const int windowSize = windowSizes[w];
+        char name[32];
+
+        medianFilterInit(&filter, windowSize, buf);
+        snprintf(name, sizeof(name), "medianFilterApply %d", windowSize);
+        benchmarkNs(name, [&](float x) { return medianFilterApply(&filter, x); });
+
+        next = 0;
+        snprintf(name, sizeof(name), "sort every sample %d", windowSize);
+        benchmarkNs(name, [&](float x) {
+            window[next] = x;
+            next = (next + 1) % windowSize;
+            float sorted[255];
+            std::copy(window, window + windowSize, sorted);
+            std::nth_element(sorted, sorted + windowSize / 2, sorted + windowSize);
+            return sorted[windowSize / 2];
+        });
+    }
+}
+
+// STUBS
+
+extern "C" {
+
+volatile bool isSetpointNew;
+
+float getSetpointRate(int) { return 0.0f; }
+
+}
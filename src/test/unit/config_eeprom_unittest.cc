@@ -0,0 +1,199 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "config/config_eeprom.h"
+
+    #include "drivers/system.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    typedef struct testConfig_s {
+        uint16_t value;
+    } testConfig_t;
+
+    PG_DECLARE(testConfig_t, testConfig);
+
+    PG_REGISTER_WITH_RESET_TEMPLATE(testConfig_t, testConfig, PG_BEEPER_CONFIG, 0);
+
+    PG_RESET_TEMPLATE(testConfig_t, testConfig,
+        .value = 1,
+    );
+
+    // the streamer erases whenever it reaches a page boundary, so the area has to start on one
+    uint8_t eepromData[EEPROM_SIZE] __attribute__((aligned(0x400)));
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_FLASH_PAGE_SIZE 0x400  // matches the UNIT_TEST page size in config_streamer.c
+#define TEST_FLASH_PAGES (EEPROM_SIZE / TEST_FLASH_PAGE_SIZE)
+
+// header, then one record of 10 bytes header + 2 bytes PG
+#define TEST_HEADER_SIZE 4
+#define TEST_RECORD_SIZE 12
+
+static int pagesErased;
+static bool failed;
+
+static uint16_t logGeneration(void)
+{
+    return eepromData[2] | (eepromData[3] << 8);
+}
+
+static void saveValue(uint16_t value)
+{
+    testConfigMutable()->value = value;
+    writeConfigToEEPROM();
+}
+
+static void expectLoadedValue(uint16_t value)
+{
+    testConfigMutable()->value = 0;
+    EXPECT_TRUE(isEEPROMVersionValid());
+    EXPECT_TRUE(isEEPROMStructureValid());
+    EXPECT_TRUE(loadEEPROM());
+    EXPECT_EQ(value, testConfig()->value);
+}
+
+TEST(ConfigEepromUnittest, CompactOnNeverErasedFlash)
+{
+    // flash that was never erased reads back as anything, not as 0xFF
+    memset(eepromData, 0, sizeof(eepromData));
+    pagesErased = 0;
+    failed = false;
+
+    saveValue(10);
+
+    // the whole area is erased, not just the page the log was written to
+    EXPECT_FALSE(failed);
+    EXPECT_EQ(TEST_FLASH_PAGES, pagesErased);
+    EXPECT_EQ(TEST_HEADER_SIZE + TEST_RECORD_SIZE, getEEPROMConfigSize());
+    expectLoadedValue(10);
+}
+
+TEST(ConfigEepromUnittest, AppendDoesNotErase)
+{
+    memset(eepromData, 0, sizeof(eepromData));
+    pagesErased = 0;
+    failed = false;
+
+    saveValue(10);
+    const uint16_t generation = logGeneration();
+
+    saveValue(11);
+    saveValue(12);
+
+    EXPECT_FALSE(failed);
+    EXPECT_EQ(TEST_FLASH_PAGES, pagesErased);
+    EXPECT_EQ(generation, logGeneration());
+    EXPECT_EQ(TEST_HEADER_SIZE + 3 * TEST_RECORD_SIZE, getEEPROMConfigSize());
+    expectLoadedValue(12);
+
+    // saving an unchanged config writes nothing
+    saveValue(12);
+    EXPECT_EQ(TEST_HEADER_SIZE + 3 * TEST_RECORD_SIZE, getEEPROMConfigSize());
+}
+
+TEST(ConfigEepromUnittest, AppendAcrossPagesAfterCompaction)
+{
+    memset(eepromData, 0, sizeof(eepromData));
+    pagesErased = 0;
+    failed = false;
+
+    // the compaction leaves every page behind the log erased
+    saveValue(0);
+    const uint16_t generation = logGeneration();
+
+    // fill the first page exactly, so the tail lands on the start of the second one
+    const int appends = (TEST_FLASH_PAGE_SIZE - TEST_HEADER_SIZE - TEST_RECORD_SIZE) / TEST_RECORD_SIZE;
+    for (int i = 1; i <= appends; i++) {
+        saveValue(i);
+    }
+
+    EXPECT_FALSE(failed);
+    EXPECT_EQ(TEST_FLASH_PAGE_SIZE, getEEPROMConfigSize());
+    expectLoadedValue(appends);
+
+    // the next record goes to the second page without another erase
+    saveValue(1000);
+
+    EXPECT_FALSE(failed);
+    EXPECT_EQ(TEST_FLASH_PAGES, pagesErased);
+    EXPECT_EQ(generation, logGeneration());
+    EXPECT_EQ(TEST_FLASH_PAGE_SIZE + TEST_RECORD_SIZE, getEEPROMConfigSize());
+    expectLoadedValue(1000);
+}
+
+TEST(ConfigEepromUnittest, CompactWhenAppendRunsIntoUnerasedFlash)
+{
+    memset(eepromData, 0, sizeof(eepromData));
+    pagesErased = 0;
+    failed = false;
+
+    saveValue(0);
+    const uint16_t generation = logGeneration();
+
+    // stale data right behind the tail, the append must not program over it
+    memset(eepromData + TEST_HEADER_SIZE + TEST_RECORD_SIZE + sizeof(uint32_t), 0, sizeof(uint32_t));
+    saveValue(1);
+
+    EXPECT_FALSE(failed);
+    EXPECT_EQ(2 * TEST_FLASH_PAGES, pagesErased);
+    EXPECT_EQ(generation + 1, logGeneration());
+    expectLoadedValue(1);
+}
+
+// STUBS
+
+extern "C" {
+
+void FLASH_Unlock(void) {}
+void FLASH_Lock(void) {}
+
+FLASH_Status FLASH_ErasePage(uintptr_t Page_Address)
+{
+    EXPECT_EQ(0U, (Page_Address - (uintptr_t)eepromData) % TEST_FLASH_PAGE_SIZE);
+    memset((void *)Page_Address, 0xFF, TEST_FLASH_PAGE_SIZE);
+    pagesErased++;
+    return FLASH_COMPLETE;
+}
+
+FLASH_Status FLASH_ProgramWord(uintptr_t addr, uint32_t value)
+{
+    // programming can only clear bits
+    *(uint32_t *)addr &= value;
+    return FLASH_COMPLETE;
+}
+
+void failureMode(failureMode_e mode)
+{
+    UNUSED(mode);
+    failed = true;
+}
+
+}
@@ -0,0 +1,159 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/crc.h"
+    #include "common/streambuf.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static const uint8_t checkString[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+
+// bitwise reference implementations
+static uint8_t crc8DvbS2Reference(uint8_t crc, const uint8_t *data, uint32_t length)
+{
+    while (length--) {
+        crc ^= *data++;
+        for (int ii = 0; ii < 8; ++ii) {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0xD5 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static uint16_t crc16CcittReference(uint16_t crc, const uint8_t *data, uint32_t length)
+{
+    while (length--) {
+        crc ^= (uint16_t)*data++ << 8;
+        for (int ii = 0; ii < 8; ++ii) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static void fillRandom(uint8_t *buf, int length)
+{
+    srand(1);
+    for (int i = 0; i < length; i++) {
+        buf[i] = rand();
+    }
+}
+
+TEST(CrcTest, CheckValues)
+{
+    EXPECT_EQ(0xBC, crc8_dvb_s2_update(0, checkString, sizeof(checkString)));
+    EXPECT_EQ(0x31C3, crc16_ccitt_update(0, checkString, sizeof(checkString)));
+    EXPECT_EQ(0x31, crc8_xor_update(0, checkString, sizeof(checkString)));
+
+    uint8_t crc8 = 0;
+    uint16_t crc16 = 0;
+    for (unsigned i = 0; i < sizeof(checkString); i++) {
+        crc8 = crc8_dvb_s2(crc8, checkString[i]);
+        crc16 = crc16_ccitt(crc16, checkString[i]);
+    }
+    EXPECT_EQ(0xBC, crc8);
+    EXPECT_EQ(0x31C3, crc16);
+}
+
+TEST(CrcTest, MatchesReferenceForAllLengthsAndSplits)
+{
+    uint8_t buf[64];
+    fillRandom(buf, sizeof(buf));
+
+    for (unsigned length = 0; length <= sizeof(buf); length++) {
+        const uint8_t crc8 = crc8DvbS2Reference(0x5A, buf, length);
+        const uint16_t crc16 = crc16CcittReference(0xA55A, buf, length);
+        EXPECT_EQ(crc8, crc8_dvb_s2_update(0x5A, buf, length));
+        EXPECT_EQ(crc16, crc16_ccitt_update(0xA55A, buf, length));
+
+        // streaming in two parts gives the same result
+        for (unsigned split = 0; split <= length; split += 3) {
+            EXPECT_EQ(crc8, crc8_dvb_s2_update(crc8_dvb_s2_update(0x5A, buf, split), buf + split, length - split));
+            EXPECT_EQ(crc16, crc16_ccitt_update(crc16_ccitt_update(0xA55A, buf, split), buf + split, length - split));
+        }
+    }
+}
+
+TEST(CrcTest, SbufAppend)
+{
+    uint8_t buf[16];
+    sbuf_t sbuf = { .ptr = buf, .end = buf + sizeof(buf) };
+    sbufWriteData(&sbuf, checkString, sizeof(checkString));
+    crc16_ccitt_sbuf_append(&sbuf, buf);
+    EXPECT_EQ(0xC3, buf[9]);
+    EXPECT_EQ(0x31, buf[10]);
+
+    sbuf.ptr = buf;
+    sbufWriteData(&sbuf, checkString, sizeof(checkString));
+    crc8_dvb_s2_sbuf_append(&sbuf, buf);
+    EXPECT_EQ(0xBC, buf[9]);
+}
+
+#define BENCHMARK_BUFFER_SIZE   4096
+#define BENCHMARK_BYTES         (4 * 1024 * 1024)
+
+template <typename F>
+static double benchmarkMBps(const char *name, F fn)
+{
+    volatile uint32_t sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int done = 0; done < BENCHMARK_BYTES; done += BENCHMARK_BUFFER_SIZE) {
+        sink += fn();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const double mbps = BENCHMARK_BYTES / (1024.0 * 1024.0) / elapsed.count();
+    printf("    %-22s %8.1f MB/s\n", name, mbps);
+    (void)sink;
+    return mbps;
+}
+
+TEST(CrcTest, Benchmark)
+{
+    static uint8_t buf[BENCHMARK_BUFFER_SIZE];
+    fillRandom(buf, sizeof(buf));
+
+    benchmarkMBps("crc8_dvb_s2 bitwise", [&]{ return crc8DvbS2Reference(0, buf, sizeof(buf)); });
+    benchmarkMBps("crc8_dvb_s2 per byte", [&]{
+        uint8_t crc = 0;
+        for (unsigned i = 0; i < sizeof(buf); i++) {
+            crc = crc8_dvb_s2(crc, buf[i]);
+        }
+        return crc;
+    });
+    benchmarkMBps("crc8_dvb_s2_update", [&]{ return crc8_dvb_s2_update(0, buf, sizeof(buf)); });
+    benchmarkMBps("crc16_ccitt bitwise", [&]{ return crc16CcittReference(0, buf, sizeof(buf)); });
+    benchmarkMBps("crc16_ccitt_update", [&]{ return crc16_ccitt_update(0, buf, sizeof(buf)); });
+    benchmarkMBps("crc8_xor_update", [&]{ return crc8_xor_update(0, buf, sizeof(buf)); });
+
+    EXPECT_EQ(crc8DvbS2Reference(0, buf, sizeof(buf)), crc8_dvb_s2_update(0, buf, sizeof(buf)));
+    EXPECT_EQ(crc16CcittReference(0, buf, sizeof(buf)), crc16_ccitt_update(0, buf, sizeof(buf)));
+}
@@ -0,0 +1,206 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "drivers/dshot.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// the encoders as they were before the lookup table, as reference
+
+static uint16_t referencePacket(uint16_t value, bool requestTelemetry)
+{
+    uint16_t packet = (value << 1) | (requestTelemetry ? 1 : 0);
+
+    int csum = 0;
+    int csum_data = packet;
+    for (int i = 0; i < 3; i++) {
+        csum ^=  csum_data;
+        csum_data >>= 4;
+    }
+    csum &= 0xf;
+
+    return (packet << 4) | csum;
+}
+
+static uint8_t referenceLoadDmaBuffer(uint32_t *dmaBuffer, int stride, uint16_t packet)
+{
+    for (int i = 0; i < 16; i++) {
+        dmaBuffer[i * stride] = (packet & 0x8000) ? MOTOR_BIT_1 : MOTOR_BIT_0;
+        packet <<= 1;
+    }
+
+    return DSHOT_DMA_BUFFER_SIZE;
+}
+
+TEST(DshotUnittest, TestPacketMatchesReference)
+{
+    for (uint16_t value = 0; value < 2048; value++) {
+        EXPECT_EQ(referencePacket(value, false), dshotEncodePacket(value, false));
+        EXPECT_EQ(referencePacket(value, true), dshotEncodePacket(value, true));
+    }
+
+    // throttle 1046 without telemetry, the example from the protocol description
+    EXPECT_EQ(0x82c6, dshotEncodePacket(1046, false));
+}
+
+TEST(DshotUnittest, TestDmaBufferMatchesReference)
+{
+    // burst layout, four channels interleaved, with a neighbouring channel that must be left alone
+    uint32_t expected[DSHOT_DMA_BUFFER_SIZE * 4];
+    uint32_t actual[DSHOT_DMA_BUFFER_SIZE * 4];
+
+    for (int stride = 1; stride <= 4; stride += 3) {
+        for (uint16_t value = 0; value < 2048; value++) {
+            for (int telemetry = 0; telemetry < 2; telemetry++) {
+                const uint16_t packet = dshotEncodePacket(value, telemetry);
+                memset(expected, 0x55, sizeof(expected));
+                memset(actual, 0x55, sizeof(actual));
+
+                EXPECT_EQ(referenceLoadDmaBuffer(&expected[stride - 1], stride, packet),
+                    dshotLoadDmaBuffer(&actual[stride - 1], stride, packet));
+                ASSERT_EQ(0, memcmp(expected, actual, sizeof(expected))) << "value " << value << " stride " << stride;
+            }
+        }
+    }
+}
+
+TEST(DshotUnittest, TestProshotDmaBuffer)
+{
+    uint32_t buffer[PROSHOT_DMA_BUFFER_SIZE * 4] = { 0 };
+
+    EXPECT_EQ(PROSHOT_DMA_BUFFER_SIZE, proshotLoadDmaBuffer(buffer, 4, 0x82c6));
+    EXPECT_EQ(PROSHOT_BASE_SYMBOL + 0x8 * PROSHOT_BIT_WIDTH, buffer[0]);
+    EXPECT_EQ(PROSHOT_BASE_SYMBOL + 0x2 * PROSHOT_BIT_WIDTH, buffer[4]);
+    EXPECT_EQ(PROSHOT_BASE_SYMBOL + 0xc * PROSHOT_BIT_WIDTH, buffer[8]);
+    EXPECT_EQ(PROSHOT_BASE_SYMBOL + 0x6 * PROSHOT_BIT_WIDTH, buffer[12]);
+    EXPECT_EQ(0u, buffer[1]);
+}
+
+// bidirectional telemetry, the ESC side of the protocol
+
+static const uint8_t gcrEncode[16] = {
+    0x19, 0x1b, 0x12, 0x13, 0x1d, 0x15, 0x16, 0x17,
+    0x1a, 0x09, 0x0a, 0x0b, 0x1e, 0x0d, 0x0e, 0x0f,
+};
+
+static uint16_t telemetryFrame(uint32_t periodUs)
+{
+    uint16_t exponent = 0;
+    while (periodUs > 0x1ff) {
+        periodUs >>= 1;
+        exponent++;
+    }
+    const uint16_t value = (exponent << 9) | periodUs;
+    const uint16_t csum = ~(value ^ (value >> 4) ^ (value >> 8)) & 0xf;
+
+    return (value << 4) | csum;
+}
+
+// timer captures of the edges of a reply, starting at startTick, each edge off by up to jitter ticks
+static int telemetryEdges(uint32_t *edges, uint16_t frame, uint32_t startTick, int jitter)
+{
+    uint32_t gcr = 1 << 20;     // start bit
+    for (int shift = 12; shift >= 0; shift -= 4) {
+        gcr |= gcrEncode[(frame >> shift) & 0xf] << (shift / 4 * 5);
+    }
+
+    int count = 0;
+    for (int bit = 20; bit >= 0; bit--) {
+        if (gcr & (1 << bit)) {
+            const int offset = (count % 3 - 1) * jitter;
+            edges[count++] = startTick + (20 - bit) * DSHOT_TELEMETRY_BIT_TICKS + offset;
+        }
+    }
+
+    return count;
+}
+
+TEST(DshotUnittest, TestTelemetryDecode)
+{
+    uint32_t edges[DSHOT_TELEMETRY_INPUT_LEN];
+
+    // from 1000 to 300000 eRPM, at different points in the timer period and with edge jitter
+    const uint32_t erpms[] = { 1000, 12345, 60000, 150000, 300000 };
+    for (unsigned i = 0; i < ARRAYLEN(erpms); i++) {
+        const uint32_t periodUs = 60000000 / erpms[i];
+        uint32_t resolvedUs = periodUs;
+        int exponent = 0;
+        while (resolvedUs > 0x1ff) {
+            resolvedUs >>= 1;
+            exponent++;
+        }
+        resolvedUs <<= exponent;
+        const uint16_t expected = (600000 + resolvedUs / 2) / resolvedUs;
+
+        for (uint32_t start = 0; start < 0x20000; start += 0xff00) {
+            for (int jitter = 0; jitter <= 3; jitter += 3) {
+                const int count = telemetryEdges(edges, telemetryFrame(periodUs), start, jitter);
+                EXPECT_EQ(expected, dshotDecodeTelemetry(edges, count)) << "erpm " << erpms[i] << " start " << start;
+            }
+        }
+        EXPECT_NEAR(erpms[i] / 100, expected, erpms[i] / 100 / 50 + 1);
+    }
+}
+
+TEST(DshotUnittest, TestTelemetryStopped)
+{
+    uint32_t edges[DSHOT_TELEMETRY_INPUT_LEN];
+    const uint16_t stopped = (0x0fff << 4) | (~(0x0fff ^ 0xff ^ 0xf) & 0xf);
+
+    EXPECT_EQ(0, dshotDecodeTelemetry(edges, telemetryEdges(edges, stopped, 100, 0)));
+}
+
+TEST(DshotUnittest, TestTelemetryRejectsCorruptReplies)
+{
+    uint32_t edges[DSHOT_TELEMETRY_INPUT_LEN];
+    const uint16_t frame = telemetryFrame(1000);
+
+    // bad checksum
+    int count = telemetryEdges(edges, frame ^ 0x1, 100, 0);
+    EXPECT_EQ(DSHOT_TELEMETRY_INVALID, dshotDecodeTelemetry(edges, count));
+
+    // a lost edge merges two runs
+    count = telemetryEdges(edges, frame, 100, 0);
+    memmove(&edges[3], &edges[4], (count - 4) * sizeof(edges[0]));
+    EXPECT_EQ(DSHOT_TELEMETRY_INVALID, dshotDecodeTelemetry(edges, count - 1));
+
+    // glitch edges closer together than a bit
+    count = telemetryEdges(edges, frame, 100, 0);
+    edges[count] = edges[count - 1] + 2;
+    EXPECT_EQ(DSHOT_TELEMETRY_INVALID, dshotDecodeTelemetry(edges, count + 1));
+
+    // too long to be a reply
+    count = telemetryEdges(edges, frame, 100, 0);
+    edges[count] = edges[count - 1] + 10 * DSHOT_TELEMETRY_BIT_TICKS;
+    EXPECT_EQ(DSHOT_TELEMETRY_INVALID, dshotDecodeTelemetry(edges, count + 1));
+
+    EXPECT_EQ(DSHOT_TELEMETRY_INVALID, dshotDecodeTelemetry(edges, 0));
+}
@@ -33,6 +33,7 @@ extern "C" {
     #include "pg/rx.h"
 
     #include "drivers/accgyro/accgyro.h"
+    #include "drivers/accgyro/accgyro_imuf9001.h"
     #include "drivers/compass/compass.h"
     #include "drivers/sensor.h"
 
@@ -67,6 +68,68 @@ extern "C" {
 #include "unittest_macros.h"
 #include "gtest/gtest.h"
 
+static float gyroRateZ;
+
+static void setImufQuat(float w, float x, float y, float z)
+{
+    imufQuat.w = w;
+    imufQuat.x = x;
+    imufQuat.y = y;
+    imufQuat.z = z;
+    imufQuatSequence++;
+}
+
+static void initImufAttitude(void)
+{
+    imuConfigMutable()->attitude_source = IMU_ATTITUDE_SOURCE_IMUF;
+    imuConfigure(800);
+    acc.isAccelUpdatedAtLeastOnce = true;
+    gyroRateZ = 0.0f;
+}
+
+TEST(FlightImuTest, TestImufQuaternionIsBodyAttitude)
+{
+    initImufAttitude();
+
+    // 30 degrees of roll, the IMU-F has already applied the board alignment
+    setImufQuat(cosf(degreesToRadians(15)), sinf(degreesToRadians(15)), 0.0f, 0.0f);
+    imuUpdateAttitude(1000000);
+
+    EXPECT_EQ(300, attitude.values.roll);
+    EXPECT_EQ(0, attitude.values.pitch);
+    EXPECT_EQ(0, attitude.values.yaw);
+
+    // a frame that isn't a unit quaternion is ignored, the last good one stays
+    setImufQuat(2.0f, 0.0f, 0.0f, 0.0f);
+    imuUpdateAttitude(1001000);
+
+    EXPECT_EQ(300, attitude.values.roll);
+}
+
+TEST(FlightImuTest, TestImufStaleFallsBackToMahony)
+{
+    initImufAttitude();
+
+    setImufQuat(1.0f, 0.0f, 0.0f, 0.0f);
+    imuUpdateAttitude(2000000);
+    EXPECT_EQ(0, attitude.values.yaw);
+
+    // Mahony would integrate the gyro, but the IMU-F quaternion is still recent
+    gyroRateZ = 1.0f;
+    imuUpdateAttitude(2010000);
+    imuUpdateAttitude(2040000);
+    EXPECT_EQ(0, attitude.values.yaw);
+
+    // no frame for longer than 50ms, Mahony takes over from the last IMU-F attitude
+    imuUpdateAttitude(2060000);
+    EXPECT_NE(0, attitude.values.yaw);
+
+    // and hands back as soon as frames come in again
+    setImufQuat(1.0f, 0.0f, 0.0f, 0.0f);
+    imuUpdateAttitude(2070000);
+    EXPECT_EQ(0, attitude.values.yaw);
+}
+
 // STUBS
 
 extern "C" {
@@ -103,8 +166,7 @@ uint16_t disableFlightMode(flightModeFlags_e mask)
 
 bool sensors(uint32_t mask)
 {
-    UNUSED(mask);
-    return false;
+    return mask == SENSOR_ACC;
 };
 
 uint32_t millis(void) { return 0; }
@@ -114,9 +176,23 @@ bool compassIsHealthy(quaternion *) { return true; }
 bool isBaroCalibrationComplete(void) { return true; }
 void performBaroCalibrationCycle(void) {}
 int32_t baroCalculateAltitude(void) { return 0; }
-bool gyroGetAverage(quaternion *) { return false; }
-bool accGetAverage(quaternion *) { return false; }
+bool gyroGetAverage(quaternion *average)
+{
+    average->w = 0;
+    average->x = 0;
+    average->y = 0;
+    average->z = gyroRateZ;
+    return true;
+}
+bool accGetAverage(quaternion *average)
+{
+    quaternionInitVector(average);
+    return false;
+}
 bool accIsHealthy(quaternion *) { return false; }
 bool compassGetAverage(quaternion *) { return false; }
 bool isBeeperOn(void){ return true; }
+
+volatile imuFrame_t imufQuat;
+volatile uint32_t imufQuatSequence;
 }
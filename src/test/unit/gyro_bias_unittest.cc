@@ -0,0 +1,136 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/axis.h"
+
+    #include "sensors/gyro_bias.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define LOOPTIME_US     125
+#define WINDOW_US       1250000
+#define THRESHOLD       48
+
+static uint32_t noiseState;
+
+// deterministic noise with a standard deviation of about amplitude / 3.5
+static float noise(float amplitude)
+{
+    noiseState = noiseState * 1664525u + 1013904223u;
+    return amplitude * ((float)(noiseState >> 8) / (1 << 24) - 0.5f);
+}
+
+// feeds duration of gyro samples at the loop rate, returns the number of still windows completed
+static int feed(gyroBias_t *bias, timeUs_t *timeUs, timeDelta_t durationUs, const float offset[XYZ_AXIS_COUNT], float amplitude)
+{
+    int stillWindows = 0;
+
+    for (timeDelta_t t = 0; t < durationUs; t += LOOPTIME_US) {
+        int16_t raw[XYZ_AXIS_COUNT];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            raw[axis] = lrintf(offset[axis] + noise(amplitude));
+        }
+        *timeUs += LOOPTIME_US;
+        stillWindows += gyroBiasPush(bias, raw, *timeUs);
+    }
+
+    return stillWindows;
+}
+
+TEST(GyroBiasUnittest, TestStillWindowGivesBiasAndNoise)
+{
+    gyroBias_t bias;
+    gyroBiasInit(&bias, LOOPTIME_US, WINDOW_US, THRESHOLD);
+    EXPECT_EQ(8, bias.decimation);
+    EXPECT_EQ(1250u, bias.windowSamples);
+
+    const float offset[XYZ_AXIS_COUNT] = { 12.3f, -40.0f, 3.0f };
+    timeUs_t timeUs = 0;
+    EXPECT_EQ(0, feed(&bias, &timeUs, WINDOW_US - 10000, offset, 40));
+    EXPECT_FALSE(bias.valid);
+    EXPECT_EQ(1, feed(&bias, &timeUs, 20000, offset, 40));
+
+    ASSERT_TRUE(bias.valid);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        EXPECT_NEAR(offset[axis], bias.zero[axis], 1.0f);
+        EXPECT_NEAR(40 / sqrtf(12), bias.stdDev[axis], 1.0f);
+    }
+    EXPECT_TRUE(gyroBiasIsFresh(&bias, timeUs, 1000000));
+    EXPECT_FALSE(gyroBiasIsFresh(&bias, timeUs + 2000000, 1000000));
+}
+
+TEST(GyroBiasUnittest, TestMovementRestartsWindowAndKeepsLastEstimate)
+{
+    gyroBias_t bias;
+    gyroBiasInit(&bias, LOOPTIME_US, WINDOW_US, THRESHOLD);
+
+    const float still[XYZ_AXIS_COUNT] = { 5.0f, 5.0f, 5.0f };
+    timeUs_t timeUs = 0;
+    EXPECT_EQ(1, feed(&bias, &timeUs, WINDOW_US + 10000, still, 20));
+    const timeUs_t stillUs = bias.stillUs;
+
+    // being carried around
+    EXPECT_EQ(0, feed(&bias, &timeUs, 5 * WINDOW_US, still, 20 * THRESHOLD));
+    EXPECT_EQ(stillUs, bias.stillUs);
+    EXPECT_NEAR(5.0f, bias.zero[X], 1.0f);
+
+    // put down again, a full window after the movement stopped gives a new estimate
+    const float drifted[XYZ_AXIS_COUNT] = { 9.0f, 5.0f, 5.0f };
+    EXPECT_EQ(0, feed(&bias, &timeUs, WINDOW_US - 20000, drifted, 20));
+    EXPECT_EQ(1, feed(&bias, &timeUs, 40000, drifted, 20));
+    EXPECT_NEAR(9.0f, bias.zero[X], 1.0f);
+}
+
+TEST(GyroBiasUnittest, TestSlowRotationIsNotStill)
+{
+    gyroBias_t bias;
+    gyroBiasInit(&bias, LOOPTIME_US, WINDOW_US, THRESHOLD);
+
+    // a steady turn over the window ramps the rate, quiet but not still
+    timeUs_t timeUs = 0;
+    int stillWindows = 0;
+    for (int i = 0; i < 4 * WINDOW_US / LOOPTIME_US; i++) {
+        const int16_t raw[XYZ_AXIS_COUNT] = { 0, (int16_t)(i / 20), 0 };
+        timeUs += LOOPTIME_US;
+        stillWindows += gyroBiasPush(&bias, raw, timeUs);
+    }
+    EXPECT_EQ(0, stillWindows);
+    EXPECT_FALSE(bias.valid);
+}
+
+TEST(GyroBiasUnittest, TestNoThresholdNoEstimate)
+{
+    gyroBias_t bias;
+    gyroBiasInit(&bias, LOOPTIME_US, WINDOW_US, 0);
+
+    const float offset[XYZ_AXIS_COUNT] = { 0.0f, 0.0f, 0.0f };
+    timeUs_t timeUs = 0;
+    EXPECT_EQ(0, feed(&bias, &timeUs, 3 * WINDOW_US, offset, 1));
+    EXPECT_FALSE(bias.valid);
+}
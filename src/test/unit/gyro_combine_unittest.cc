@@ -0,0 +1,127 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/axis.h"
+    #include "common/maths.h"
+
+    #include "sensors/gyro_combine.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define LOOPTIME_US     125
+
+static uint32_t noiseState;
+
+// deterministic noise with a standard deviation of about amplitude / 3.5
+static float noise(float amplitude)
+{
+    noiseState = noiseState * 1664525u + 1013904223u;
+    return amplitude * ((float)(noiseState >> 8) / (1 << 24) - 0.5f);
+}
+
+// a slow manoeuvre, the same for both gyros
+static float motion(int sample)
+{
+    return 300.0f * sinf(2.0f * M_PIf * 2.0f * sample * LOOPTIME_US * 1e-6f);
+}
+
+TEST(GyroCombineUnittest, TestWeight)
+{
+    EXPECT_FLOAT_EQ(0.5f, gyroCombineWeight(0.0f, 0.0f));
+    EXPECT_FLOAT_EQ(0.5f, gyroCombineWeight(4.0f, 4.0f));
+    EXPECT_FLOAT_EQ(0.75f, gyroCombineWeight(1.0f, 3.0f));
+    EXPECT_FLOAT_EQ(0.25f, gyroCombineWeight(3.0f, 1.0f));
+
+    // a gyro that goes quiet, e.g. because it is stuck, can't take over
+    EXPECT_FLOAT_EQ(1.0f - GYRO_COMBINE_WEIGHT_MIN, gyroCombineWeight(0.0f, 5.0f));
+    EXPECT_FLOAT_EQ(GYRO_COMBINE_WEIGHT_MIN, gyroCombineWeight(5.0f, 0.0f));
+}
+
+TEST(GyroCombineUnittest, TestNoiseFollowsSensorNotMotion)
+{
+    gyroNoise_t quiet;
+    gyroNoise_t noisy;
+    gyroNoiseInit(&quiet, LOOPTIME_US);
+    gyroNoiseInit(&noisy, LOOPTIME_US);
+    noiseState = 1;
+
+    for (int i = 0; i < 8000 * 5; i++) {
+        const float rate = motion(i);
+        const float a[XYZ_AXIS_COUNT] = { rate + noise(2.0f), rate, rate + noise(2.0f) };
+        const float b[XYZ_AXIS_COUNT] = { rate + noise(6.0f), rate, rate + noise(2.0f) };
+        gyroNoiseUpdate(&quiet, a);
+        gyroNoiseUpdate(&noisy, b);
+    }
+
+    // three times the amplitude is nine times the variance
+    EXPECT_NEAR(9.0f, gyroNoiseVariance(&noisy, X) / gyroNoiseVariance(&quiet, X), 1.0f);
+    EXPECT_NEAR(1.0f, gyroNoiseVariance(&noisy, Z) / gyroNoiseVariance(&quiet, Z), 0.15f);
+
+    // without noise the manoeuvre alone hardly registers
+    EXPECT_LT(gyroNoiseVariance(&quiet, Y), 0.01f * gyroNoiseVariance(&quiet, X));
+}
+
+TEST(GyroCombineUnittest, TestWeightedBeatsAverage)
+{
+    gyroNoise_t noise1;
+    gyroNoise_t noise2;
+    gyroNoiseInit(&noise1, LOOPTIME_US);
+    gyroNoiseInit(&noise2, LOOPTIME_US);
+    noiseState = 7;
+
+    float errorWeighted = 0.0f;
+    float errorAverage = 0.0f;
+    for (int i = 0; i < 8000 * 5; i++) {
+        const float rate = motion(i);
+        const float a[XYZ_AXIS_COUNT] = { rate + noise(2.0f), 0.0f, 0.0f };
+        const float b[XYZ_AXIS_COUNT] = { rate + noise(6.0f), 0.0f, 0.0f };
+        gyroNoiseUpdate(&noise1, a);
+        gyroNoiseUpdate(&noise2, b);
+
+        if (i >= 8000 * 3) {
+            const float weight = gyroCombineWeight(gyroNoiseVariance(&noise1, X), gyroNoiseVariance(&noise2, X));
+            errorWeighted += sq(weight * a[X] + (1.0f - weight) * b[X] - rate);
+            errorAverage += sq(0.5f * (a[X] + b[X]) - rate);
+        }
+    }
+
+    // inverse variance weights of 0.9 / 0.1 are clamped to 0.8 / 0.2, still well ahead of the plain average
+    EXPECT_LT(errorWeighted, 0.6f * errorAverage);
+}
+
+// STUBS
+
+extern "C" {
+
+volatile bool isSetpointNew;
+
+float getSetpointRate(int) { return 0.0f; }
+
+}
@@ -0,0 +1,195 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/axis.h"
+
+    #include "fc/loop_state.h"
+    #include "fc/rc_controls.h"
+
+    #include "flight/imu.h"
+    #include "flight/mixer.h"
+    #include "flight/pid.h"
+
+    #include "sensors/acceleration.h"
+    #include "sensors/compass.h"
+    #include "sensors/gyro.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static uint8_t simulatedMotorCount = 4;
+
+// sets every value the loop state picks up to something derived from n
+static void simulateLoop(uint32_t n)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyro.gyroADCf[axis] = n + axis;
+        acc.accADC[axis] = n * 2 + axis;
+        mag.magADC[axis] = n * 3 + axis;
+        attitude.raw[axis] = n + axis;
+        pidData[axis].P = n;
+        pidData[axis].I = n + 1;
+        pidData[axis].D = n + 2;
+        pidData[axis].F = n + 3;
+        pidData[axis].Sum = n + 4;
+    }
+    for (int i = 0; i < 4; i++) {
+        rcCommand[i] = n + i;
+        debug[i] = n + i;
+    }
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+        motor[i] = n + i;
+    }
+}
+
+// true if state holds exactly the values of loop n
+static bool isLoop(const loopState_t *state, uint32_t n)
+{
+    bool ok = state->timeUs == n;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        ok &= state->gyroADCf[axis] == n + axis;
+        ok &= state->accADC[axis] == n * 2 + axis;
+        ok &= state->magADC[axis] == n * 3 + axis;
+        ok &= state->attitude.raw[axis] == (int16_t)(n + axis);
+        ok &= state->pidData[axis].P == n && state->pidData[axis].Sum == n + 4;
+    }
+    for (int i = 0; i < 4; i++) {
+        ok &= state->rcCommand[i] == n + i;
+        ok &= state->debug[i] == (int16_t)(n + i);
+    }
+    for (int i = 0; i < state->motorCount; i++) {
+        ok &= state->motor[i] == n + i;
+    }
+    return ok;
+}
+
+TEST(LoopStateUnittest, TestSnapshotOfLastLoop)
+{
+    loopState_t state;
+    memset(&state, 0, sizeof(state));
+
+    simulateLoop(100);
+    loopStatePublish(100);
+    EXPECT_TRUE(loopStateRead(&state));
+    EXPECT_GT(state.iteration, 0u);
+    EXPECT_TRUE(isLoop(&state, 100));
+    EXPECT_EQ(4, state.motorCount);
+
+    // the live values moving on doesn't change the snapshot until the next publish
+    simulateLoop(101);
+    EXPECT_TRUE(loopStateRead(&state));
+    EXPECT_TRUE(isLoop(&state, 100));
+
+    loopStatePublish(101);
+    const uint32_t previous = state.iteration;
+    EXPECT_TRUE(loopStateRead(&state));
+    EXPECT_EQ(previous + 1, state.iteration);
+    EXPECT_TRUE(isLoop(&state, 101));
+}
+
+// threaded test: one thread publishes as fast as it can, another checks every snapshot it gets is whole
+
+#define STRESS_LOOPS 200000
+
+static volatile bool writerDone;
+
+static void *stressWriter(void *)
+{
+    for (uint32_t n = 1000; n < 1000 + STRESS_LOOPS; n++) {
+        simulateLoop(n);
+        loopStatePublish(n);
+    }
+    writerDone = true;
+    return NULL;
+}
+
+typedef struct stressResult_s {
+    uint32_t reads;
+    uint32_t torn;
+    uint32_t backwards;
+} stressResult_t;
+
+static void *stressReader(void *arg)
+{
+    stressResult_t *result = (stressResult_t *)arg;
+    loopState_t state;
+    memset(&state, 0, sizeof(state));
+    uint32_t lastIteration = 0;
+
+    while (!writerDone) {
+        if (!loopStateRead(&state)) {
+            sched_yield();
+            continue;
+        }
+        result->reads++;
+        result->torn += !isLoop(&state, state.timeUs);
+        result->backwards += state.iteration < lastIteration;
+        lastIteration = state.iteration;
+    }
+    return NULL;
+}
+
+TEST(LoopStateUnittest, TestThreadedReadsAreNeverTorn)
+{
+    static stressResult_t result;
+    memset(&result, 0, sizeof(result));
+    writerDone = false;
+
+    pthread_t writer;
+    pthread_t reader;
+    ASSERT_EQ(0, pthread_create(&reader, NULL, stressReader, &result));
+    ASSERT_EQ(0, pthread_create(&writer, NULL, stressWriter, NULL));
+    pthread_join(writer, NULL);
+    pthread_join(reader, NULL);
+
+    EXPECT_GT(result.reads, 0u);
+    EXPECT_EQ(0u, result.torn);
+    EXPECT_EQ(0u, result.backwards);
+}
+
+extern "C" {
+
+int16_t debug[DEBUG16_VALUE_COUNT];
+uint8_t debugMode;
+
+gyro_t gyro;
+acc_t acc;
+mag_t mag;
+attitudeEulerAngles_t attitude;
+float rcCommand[4];
+pidAxisData_t pidData[XYZ_AXIS_COUNT];
+float motor[MAX_SUPPORTED_MOTORS];
+
+uint8_t getMotorCount(void) { return simulatedMotorCount; }
+
+}
@@ -22,6 +22,8 @@
 
 #include <math.h>
 
+#include <chrono>
+
 #define USE_BARO
 
 extern "C" {
@@ -235,7 +237,7 @@ TEST(MathsUnittest, TestFastTrigonometrySinCos)
         sinError = MAX(sinError, fabs(approxResult - libmResult));
     }
     printf("sin_approx maximum absolute error = %e\n", sinError);
-    EXPECT_LE(sinError, 3e-6);
+    EXPECT_LE(sinError, 1.5e-6);
 
     double cosError = 0;
     for (float x = -10 * M_PI; x < 10 * M_PI; x += M_PI / 300) {
@@ -244,7 +246,7 @@ TEST(MathsUnittest, TestFastTrigonometrySinCos)
         cosError = MAX(cosError, fabs(approxResult - libmResult));
     }
     printf("cos_approx maximum absolute error = %e\n", cosError);
-    EXPECT_LE(cosError, 3.5e-6);
+    EXPECT_LE(cosError, 2e-6);
 }
 
 TEST(MathsUnittest, TestFastTrigonometryATan2)
@@ -272,4 +274,94 @@ TEST(MathsUnittest, TestFastTrigonometryACos)
     printf("acos_approx maximum absolute error = %e rads (%e degree)\n", error, error / M_PI * 180.0f);
     EXPECT_LE(error, 1e-4);
 }
+
+TEST(MathsUnittest, TestFastInvSqrt)
+{
+    double error = 0;
+    for (float x = 1e-6f; x < 1e6f; x *= 1.001f) {
+        double approxResult = invSqrt_approx(x);
+        double libmResult = 1.0 / sqrt(x);
+        error = MAX(error, fabs(approxResult / libmResult - 1.0));
+    }
+    printf("invSqrt_approx maximum relative error = %e\n", error);
+    EXPECT_LE(error, 5e-6);
+}
+
+TEST(MathsUnittest, TestFastExpLog)
+{
+    double expError = 0;
+    for (float x = -80.0f; x < 80.0f; x += 0.01f) {
+        double approxResult = exp_approx(x);
+        double libmResult = expf(x);
+        expError = MAX(expError, fabs(approxResult / libmResult - 1.0));
+    }
+    printf("exp_approx maximum relative error = %e\n", expError);
+    EXPECT_LE(expError, 1.3e-5);
+
+    double logError = 0;
+    for (float x = 1e-30f; x < 1e30f; x *= 1.001f) {
+        double approxResult = log_approx(x);
+        double libmResult = log(x);
+        logError = MAX(logError, fabs(approxResult - libmResult));
+    }
+    printf("log_approx maximum absolute error = %e\n", logError);
+    EXPECT_LE(logError, 2.5e-5);
+
+    EXPECT_NEAR(powf(0.9f, 0.190295f), pow_approx(0.9f, 0.190295f), 1e-5);
+}
+
+TEST(MathsUnittest, TestQuaternionNormalize)
+{
+    quaternion q = { .w = 3.0f, .x = -1.0f, .y = 0.5f, .z = 7.0f };
+    const float modulus = sqrtf(9.0f + 1.0f + 0.25f + 49.0f);
+    quaternionNormalize(&q);
+    EXPECT_NEAR(3.0f / modulus, q.w, 5e-6);
+    EXPECT_NEAR(-1.0f / modulus, q.x, 5e-6);
+    EXPECT_NEAR(0.5f / modulus, q.y, 5e-6);
+    EXPECT_NEAR(7.0f / modulus, q.z, 5e-6);
+    EXPECT_NEAR(1.0f, quaternionModulus(&q), 1e-5);
+
+    quaternion zero = VECTOR_INITIALIZE;
+    quaternionNormalize(&zero);
+    EXPECT_EQ(0.0f, zero.x);
+}
+
+#define BENCHMARK_VALUES    4096
+#define BENCHMARK_ROUNDS    256
+
+template <typename F>
+static void benchmarkNs(const char *name, F fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < BENCHMARK_ROUNDS; round++) {
+        fn();
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    printf("    %-22s %6.2f ns per value\n", name, elapsed.count() / (BENCHMARK_ROUNDS * BENCHMARK_VALUES));
+}
+
+TEST(MathsUnittest, Benchmark)
+{
+    static float in[BENCHMARK_VALUES];
+    static float in2[BENCHMARK_VALUES];
+    static float out[BENCHMARK_VALUES];
+    for (int i = 0; i < BENCHMARK_VALUES; i++) {
+        in[i] = (i - BENCHMARK_VALUES / 2) * (20.0f / BENCHMARK_VALUES);
+        in2[i] = 0.01f + i * (100.0f / BENCHMARK_VALUES);
+    }
+
+    benchmarkNs("sinf", [&]{ for (int i = 0; i < BENCHMARK_VALUES; i++) out[i] = sinf(in[i]); });
+    benchmarkNs("sin_approx", [&]{ for (int i = 0; i < BENCHMARK_VALUES; i++) out[i] = sin_approx(in[i]); });
+    benchmarkNs("atan2f", [&]{ for (int i = 0; i < BENCHMARK_VALUES; i++) out[i] = atan2f(in[i], in2[i]); });
+    benchmarkNs("atan2_approx", [&]{ for (int i = 0; i < BENCHMARK_VALUES; i++) out[i] = atan2_approx(in[i], in2[i]); });
+    benchmarkNs("1 / sqrtf", [&]{ for (int i = 0; i < BENCHMARK_VALUES; i++) out[i] = 1.0f / sqrtf(in2[i]); });
+    benchmarkNs("invSqrt_approx", [&]{ for (int i = 0; i < BENCHMARK_VALUES; i++) out[i] = invSqrt_approx(in2[i]); });
+    benchmarkNs("expf", [&]{ for (int i = 0; i < BENCHMARK_VALUES; i++) out[i] = expf(in[i]); });
+    benchmarkNs("exp_approx", [&]{ for (int i = 0; i < BENCHMARK_VALUES; i++) out[i] = exp_approx(in[i]); });
+    benchmarkNs("logf", [&]{ for (int i = 0; i < BENCHMARK_VALUES; i++) out[i] = logf(in2[i]); });
+    benchmarkNs("log_approx", [&]{ for (int i = 0; i < BENCHMARK_VALUES; i++) out[i] = log_approx(in2[i]); });
+
+    // read the last results back
+    EXPECT_NEAR(logf(in2[7]), out[7], 2.5e-5);
+}
 #endif
@@ -0,0 +1,301 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Runs the PID controller with the flight controller feature set over a deterministic flight and
+ * compares the result with the output of the original per axis controller, recorded below.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/axis.h"
+    #include "common/maths.h"
+    #include "common/filter.h"
+
+    #include "pg/pg.h"
+
+    #include "fc/fc_rc.h"
+    #include "fc/rc_controls.h"
+    #include "fc/runtime_config.h"
+
+    #include "flight/pid.h"
+    #include "flight/imu.h"
+
+    #include "sensors/acceleration.h"
+    #include "sensors/gyro.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static float simulatedSetpointRate[XYZ_AXIS_COUNT];
+static float simulatedMotorMixRange;
+static bool simulatedYawSpin;
+static float simulatedItermAttenuation = 0.95f;
+
+#define SCENARIO_LOOPS      1600
+#define SAMPLE_COUNT        4
+#define SAMPLE_VALUES       (SAMPLE_COUNT * XYZ_AXIS_COUNT * 4 + XYZ_AXIS_COUNT)
+
+static const int sampleLoops[SAMPLE_COUNT] = { 100, 400, 900, SCENARIO_LOOPS - 1 };
+
+typedef enum {
+    SCENARIO_CLASSIC,
+    SCENARIO_CLASSIC_RELAX_SETPOINT,
+    SCENARIO_BUTTERED,
+    SCENARIO_ANGLE,
+    SCENARIO_COUNT
+} scenario_e;
+
+// deterministic noise so the recorded output is repeatable
+static uint32_t noiseState;
+
+static float noise(float amplitude)
+{
+    noiseState = noiseState * 1664525u + 1013904223u;
+    return amplitude * ((float)(noiseState >> 8) / (1 << 24) - 0.5f);
+}
+
+static void setupScenario(pidProfile_t *pidProfile, scenario_e scenario)
+{
+    pidProfile->iterm_rotation = false;
+    pidProfile->feedForwardTransition = 50;
+    pidProfile->smart_feedforward = true;
+    pidProfile->iterm_relax = ITERM_RELAX_RP;
+    pidProfile->iterm_relax_type = ITERM_RELAX_GYRO;
+
+    switch (scenario) {
+    case SCENARIO_CLASSIC:
+        break;
+    case SCENARIO_CLASSIC_RELAX_SETPOINT:
+        pidProfile->iterm_relax = ITERM_RELAX_RPY_INC;
+        pidProfile->iterm_relax_type = ITERM_RELAX_SETPOINT;
+        pidProfile->dterm_filter_type = FILTER_BIQUAD;
+        pidProfile->dterm_lowpass_hz = 100;
+        pidProfile->dterm_notch_hz = 260;
+        pidProfile->dterm_notch_cutoff = 160;
+        pidProfile->smart_feedforward = false;
+        break;
+    case SCENARIO_BUTTERED:
+        pidProfile->buttered_pids = true;
+        break;
+    case SCENARIO_ANGLE:
+        break;
+    default:
+        break;
+    }
+}
+
+static void runScenario(scenario_e scenario, float *out)
+{
+    pidProfile_t *pidProfile = pidProfilesMutable(0);
+
+    pgResetAll();   // profiles start from their defaults
+    setupScenario(pidProfile, scenario);
+    pidConfigMutable()->pid_process_denom = 1;
+    gyro.targetLooptime = 125;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        pidData[axis].P = pidData[axis].I = pidData[axis].D = pidData[axis].F = pidData[axis].Sum = 0;
+        gyro.gyroADCf[axis] = 0;
+        simulatedSetpointRate[axis] = 0;
+    }
+    pidInit(pidProfile);
+    pidResetITerm();
+    pidInitSetpointDerivativeLpf(50, 0, RC_SMOOTHING_DERIVATIVE_PT1);
+    pidStabilisationState(PID_STABILISATION_ON);
+    pidSetAntiGravityState(true);
+    flightModeFlags = scenario == SCENARIO_ANGLE ? ANGLE_MODE : 0;
+    simulatedYawSpin = false;
+    noiseState = 12345;
+
+    const rollAndPitchTrims_t trims = { { 0, 0 } };
+    const float amplitude[XYZ_AXIS_COUNT] = { 500, 350, 200 };
+    const float frequency[XYZ_AXIS_COUNT] = { 3, 5, 2 };
+    float absSum[XYZ_AXIS_COUNT] = { 0, 0, 0 };
+    int sample = 0;
+
+    for (int loop = 0; loop < SCENARIO_LOOPS; loop++) {
+        const float t = loop * 125e-6f;
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            simulatedSetpointRate[axis] = amplitude[axis] * sinf(2 * M_PIf * frequency[axis] * t);
+            if (loop > 600 && loop < 700) {
+                simulatedSetpointRate[axis] = amplitude[axis];    // stick step
+            }
+            // first order plant following the pid sum, with noise on top
+            gyro.gyroADCf[axis] += (simulatedSetpointRate[axis] * 0.9f - gyro.gyroADCf[axis]) * 0.05f + pidData[axis].Sum * 0.01f + noise(8.0f);
+        }
+        attitude.values.roll = lrintf(gyro.gyroADCf[FD_ROLL] / 2);
+        attitude.values.pitch = lrintf(-gyro.gyroADCf[FD_PITCH] / 3);
+
+        // the mixer saturates for a while and the throttle moves for anti gravity
+        simulatedMotorMixRange = (loop > 1000 && loop < 1200) ? 1.2f : 0.4f + 0.3f * sinf(2 * M_PIf * t);
+        pidUpdateAntiGravityThrottleFilter(0.5f + 0.4f * sinf(2 * M_PIf * 7 * t));
+
+        pidController(pidProfile, &trims, loop * 125);
+
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            absSum[axis] += fabsf(pidData[axis].Sum);
+        }
+        if (sample < SAMPLE_COUNT && loop == sampleLoops[sample]) {
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                *out++ = pidData[axis].P;
+                *out++ = pidData[axis].I;
+                *out++ = pidData[axis].D;
+                *out++ = pidData[axis].F;
+            }
+            sample++;
+        }
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        *out++ = absSum[axis];
+    }
+}
+
+// output of the per axis controller for each scenario: P, I, D and F of every axis at the sample
+// loops, then the sum of the absolute PID sums over the whole flight
+static const float referenceOutput[SCENARIO_COUNT][SAMPLE_VALUES] = {
+    {
+        53.3592224f, 4.72904212e-05f, -79.6680222f, 0.0f, 69.9632339f, 4.37271847e-05f,
+        -117.29464f, 0.0f, 15.3501673f, 0.188241348f, -3.01621032f, 0.0f,
+        62.440033f, 9.81415903e-12f, -108.257774f, 0.0f, 54.7416534f, 9.07468892e-12f,
+        -35.8810806f, 0.0f, 26.3816586f, 0.36788559f, -2.22254896f, 0.0f,
+        41.4966431f, 7.13926187e-23f, 72.6916199f, -15.5531244f, -40.6012306f, -0.0135497535f,
+        179.830048f, 0.0f, 15.2575903f, 0.233542755f, -2.18419147f, 0.0f,
+        -53.4586143f, -1.65448319e-06f, 114.061073f, 0.0f, 69.6502838f, 0.824557126f,
+        -116.270996f, 0.0f, -8.27950668f, -0.0899287164f, 4.30044985f, 0.0f,
+        72862.3594f, 78884.7422f, 28411.5449f,
+    },
+    {
+        55.8986092f, 0.0253166445f, -115.086266f, 10.5539646f, 67.3478699f, 0.00865996908f,
+        -120.184647f, 11.3479242f, 12.9508667f, 0.11779514f, -0.858882368f, -0.515470266f,
+        54.3993645f, 5.25394972e-09f, -110.849876f, 19.9950504f, 53.2757683f, 1.79719972e-09f,
+        -17.4972954f, 3.20813799f, 26.035799f, 0.00573463039f, -6.77019262f, 2.02960706f,
+        43.6630325f, 0.0418486409f, 61.3685417f, -15.5531244f, -31.8012486f, -4.03181411e-06f,
+        143.784683f, -11.621438f, 14.5471497f, 0.156993687f, -1.83832669f, 0.798336864f,
+        -49.9465218f, -2.64157771e-12f, 96.7220688f, -19.2280827f, 68.4428101f, 1.69841684e-07f,
+        -119.063744f, 0.123493686f, -7.72504234f, -0.016935572f, 3.7944386f, -1.91457546f,
+        103924.031f, 89063.4531f, 34416.3945f,
+    },
+    {
+        53.1809311f, 1.15225172f, -79.8027802f, 0.0f, 69.7084045f, 1.36525953f,
+        -117.478653f, 0.0f, 13.1636667f, 0.242101863f, -0.139629796f, -0.515470266f,
+        62.0658875f, 1.81362426f, -108.286659f, 0.0f, 54.3845482f, 1.29676104f,
+        -35.8294868f, 0.0f, 26.3816452f, 0.367884457f, -2.22251964f, 0.0f,
+        41.3488617f, 0.749159753f, 72.703125f, -15.5531244f, -40.3808403f, -0.945943654f,
+        179.909714f, 0.0f, 15.2575665f, 0.23354274f, -2.1841507f, 0.0f,
+        -53.2655792f, -0.933471084f, 114.059586f, 0.0f, 69.6506805f, 0.824563682f,
+        -116.272087f, 0.0f, -8.27950668f, -0.0899287835f, 4.30031729f, 0.0f,
+        72933.5625f, 78838.875f, 32684.0293f,
+    },
+    {
+        -64.3867111f, -1.02872896f, -79.0865326f, 0.0f, -68.1034927f, -0.991845667f,
+        -101.512985f, 0.0f, 12.7906504f, 0.224806979f, 0.181488574f, 0.0f,
+        -365.766479f, -8.2525444f, -91.3165512f, 0.0f, -271.096283f, -5.48465586f,
+        -31.3556499f, 0.0f, 26.382021f, 0.367909253f, -2.22319484f, 0.0f,
+        -403.253204f, -8.64539146f, 61.247036f, 0.0f, 96.9916763f, 1.06381547f,
+        155.181564f, 0.0f, 15.2569866f, 0.233509153f, -2.18315816f, 0.0f,
+        259.873688f, 3.46296692f, 92.842598f, 0.0f, 51.0709763f, 0.0247769188f,
+        -90.694191f, 0.0f, -8.3027916f, -0.0905134454f, 4.33015442f, 0.0f,
+        496234.25f, 340764.781f, 35007.8594f,
+    },
+};
+
+TEST(PidCoreUnittest, TestMatchesPerAxisController)
+{
+    for (int scenario = 0; scenario < SCENARIO_COUNT; scenario++) {
+        float out[SAMPLE_VALUES];
+        runScenario((scenario_e)scenario, out);
+        for (int i = 0; i < SAMPLE_VALUES; i++) {
+            const float expected = referenceOutput[scenario][i];
+            EXPECT_NEAR(expected, out[i], 1e-3f + fabsf(expected) * 1e-4f) << "scenario " << scenario << " value " << i;
+        }
+    }
+}
+
+TEST(PidCoreUnittest, TestItermRotatedOncePerLoop)
+{
+    pidProfile_t *pidProfile = pidProfilesMutable(0);
+
+    pgResetAll();
+    pidConfigMutable()->pid_process_denom = 1;
+    gyro.targetLooptime = 125;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        pidProfile->pid[axis].I = 0;    // keep the I terms where the rotation puts them
+        gyro.gyroADCf[axis] = 0;
+        simulatedSetpointRate[axis] = 0;
+    }
+    pidProfile->iterm_rotation = true;
+    pidInit(pidProfile);
+    pidStabilisationState(PID_STABILISATION_ON);
+    flightModeFlags = 0;
+    simulatedMotorMixRange = 0.5f;
+    simulatedItermAttenuation = 1.0f;
+
+    pidData[FD_ROLL].I = 10.0f;
+    pidData[FD_PITCH].I = 0.0f;
+    pidData[FD_YAW].I = 0.0f;
+    gyro.gyroADCf[FD_YAW] = 1000.0f;
+    simulatedSetpointRate[FD_YAW] = 1000.0f;
+
+    const rollAndPitchTrims_t trims = { { 0, 0 } };
+    pidController(pidProfile, &trims, 0);
+
+    // a yaw rotation of gyro rate * dT moves the roll I term onto pitch
+    const float rotation = 1000.0f * 125e-6f * RAD;
+    EXPECT_NEAR(-10.0f * rotation, pidData[FD_PITCH].I, 1e-5f);
+    EXPECT_NEAR(10.0f, pidData[FD_ROLL].I, 1e-3f);
+
+    simulatedItermAttenuation = 0.95f;
+}
+
+// STUBS
+
+extern "C" {
+
+int16_t debug[DEBUG16_VALUE_COUNT];
+uint8_t debugMode;
+
+gyro_t gyro;
+attitudeEulerAngles_t attitude;
+volatile bool isSetpointNew;
+
+float getThrottlePIDAttenuation(void) { return 0.9f; }
+float getThrottlePIDAttenuationKp(void) { return 0.9f; }
+float getThrottlePIDAttenuationKi(void) { return simulatedItermAttenuation; }
+float getThrottlePIDAttenuationKd(void) { return 0.8f; }
+float getMotorMixRange(void) { return simulatedMotorMixRange; }
+float getSetpointRate(int axis) { return simulatedSetpointRate[axis]; }
+bool mixerIsOutputSaturated(int, float) { return simulatedMotorMixRange >= 1.0f; }
+float getRcDeflectionAbs(int axis) { return fabsf(simulatedSetpointRate[axis] / 1998.0f); }
+float getRcDeflection(int axis) { return simulatedSetpointRate[axis] / 1998.0f; }
+void systemBeep(bool) { }
+bool gyroOverflowDetected(void) { return false; }
+bool gyroYawSpinDetected(void) { return simulatedYawSpin; }
+bool isAirmodeActivated(void) { return true; }
+void beeperConfirmationBeeps(uint8_t) { }
+
+}
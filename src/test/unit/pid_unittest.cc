@@ -63,6 +63,7 @@ extern "C" {
 
     gyro_t gyro;
     attitudeEulerAngles_t attitude;
+    volatile bool isSetpointNew;
 
     float getThrottlePIDAttenuation(void) { return simulatedThrottlePIDAttenuation; }
     float getMotorMixRange(void) { return simulatedMotorMixRange; }
@@ -0,0 +1,266 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+extern "C" {
+    #include "common/maths.h"
+    #include "common/ring_buffer.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+TEST(RingBufferUnittest, TestInitRejectsNonPowerOfTwo)
+{
+    ringBuffer_t rb;
+    uint8_t buffer[64];
+
+    EXPECT_FALSE(ringBufferInit(&rb, buffer, 0));
+    EXPECT_FALSE(ringBufferInit(&rb, buffer, 48));
+    EXPECT_TRUE(ringBufferInit(&rb, buffer, 64));
+    EXPECT_EQ(64u, ringBufferSize(&rb));
+    EXPECT_TRUE(ringBufferIsEmpty(&rb));
+    EXPECT_EQ(64u, ringBufferFree(&rb));
+}
+
+TEST(RingBufferUnittest, TestBytesUseWholeBuffer)
+{
+    ringBuffer_t rb;
+    uint8_t buffer[16];
+    ringBufferInit(&rb, buffer, sizeof(buffer));
+
+    for (int i = 0; i < 16; i++) {
+        EXPECT_TRUE(ringBufferPushByte(&rb, i));
+    }
+    EXPECT_FALSE(ringBufferPushByte(&rb, 0xff));
+    EXPECT_EQ(16u, ringBufferUsed(&rb));
+    EXPECT_EQ(0u, ringBufferFree(&rb));
+
+    uint8_t byte;
+    for (int i = 0; i < 16; i++) {
+        EXPECT_TRUE(ringBufferPopByte(&rb, &byte));
+        EXPECT_EQ(i, byte);
+    }
+    EXPECT_FALSE(ringBufferPopByte(&rb, &byte));
+}
+
+TEST(RingBufferUnittest, TestBulkWrapsAndTruncates)
+{
+    ringBuffer_t rb;
+    uint8_t buffer[16];
+    ringBufferInit(&rb, buffer, sizeof(buffer));
+
+    uint8_t in[32];
+    uint8_t out[32];
+    for (unsigned i = 0; i < sizeof(in); i++) {
+        in[i] = i;
+    }
+
+    // move the indices so the next push wraps
+    EXPECT_EQ(10u, ringBufferPush(&rb, in, 10));
+    EXPECT_EQ(10u, ringBufferPop(&rb, out, 10));
+
+    EXPECT_EQ(12u, ringBufferPush(&rb, in, 12));
+    EXPECT_EQ(4u, ringBufferPush(&rb, in + 12, 20));   // only 4 bytes of space left
+    EXPECT_EQ(16u, ringBufferPop(&rb, out, sizeof(out)));
+    EXPECT_EQ(0, memcmp(in, out, 16));
+    EXPECT_EQ(0u, ringBufferPop(&rb, out, sizeof(out)));
+}
+
+TEST(RingBufferUnittest, TestPeekAndReserveSpans)
+{
+    ringBuffer_t rb;
+    uint8_t buffer[16];
+    ringBufferInit(&rb, buffer, sizeof(buffer));
+
+    uint8_t in[16];
+    for (unsigned i = 0; i < sizeof(in); i++) {
+        in[i] = 100 + i;
+    }
+    ringBufferPush(&rb, in, 12);
+    ringBufferConsume(&rb, 12);
+
+    // free space is split 4 at the end + 12 at the start, reserve only hands out the first run
+    uint8_t *wr;
+    EXPECT_EQ(4u, ringBufferReserve(&rb, &wr));
+    EXPECT_EQ(buffer + 12, wr);
+    memcpy(wr, in, 4);
+    ringBufferCommit(&rb, 4);
+    EXPECT_EQ(12u, ringBufferReserve(&rb, &wr));
+    EXPECT_EQ(buffer, wr);
+    memcpy(wr, in + 4, 6);
+    ringBufferCommit(&rb, 6);
+
+    const uint8_t *rd;
+    EXPECT_EQ(4u, ringBufferPeek(&rb, &rd));
+    EXPECT_EQ(0, memcmp(rd, in, 4));
+
+    const uint8_t *spans[2];
+    uint32_t lens[2];
+    EXPECT_EQ(10u, ringBufferPeekSpans(&rb, spans, lens));
+    EXPECT_EQ(4u, lens[0]);
+    EXPECT_EQ(6u, lens[1]);
+    EXPECT_EQ(0, memcmp(spans[1], in + 4, 6));
+
+    ringBufferConsume(&rb, 4);
+    EXPECT_EQ(6u, ringBufferPeek(&rb, &rd));
+    EXPECT_EQ(buffer, rd);
+    ringBufferConsume(&rb, 6);
+    EXPECT_TRUE(ringBufferIsEmpty(&rb));
+}
+
+TEST(RingBufferUnittest, TestIndicesSurviveCounterWrap)
+{
+    ringBuffer_t rb;
+    uint8_t buffer[8];
+    ringBufferInit(&rb, buffer, sizeof(buffer));
+    rb.head = rb.tail = UINT32_MAX - 2;
+
+    const uint8_t in[6] = { 1, 2, 3, 4, 5, 6 };
+    uint8_t out[6];
+    EXPECT_EQ(6u, ringBufferPush(&rb, in, sizeof(in)));
+    EXPECT_EQ(6u, ringBufferUsed(&rb));
+    EXPECT_EQ(2u, ringBufferFree(&rb));
+    EXPECT_EQ(6u, ringBufferPop(&rb, out, sizeof(out)));
+    EXPECT_EQ(0, memcmp(in, out, sizeof(in)));
+}
+
+// threaded stress test: one producer and one consumer hammer the ring with a known byte sequence
+
+#define STRESS_BYTES (1024 * 1024)
+
+typedef struct stressContext_s {
+    ringBuffer_t rb;
+    uint8_t buffer[256];
+    uint32_t errors;
+} stressContext_t;
+
+static uint8_t stressPattern(uint32_t n)
+{
+    return (uint8_t)(n * 2654435761u >> 24);
+}
+
+static void *stressProducer(void *arg)
+{
+    stressContext_t *ctx = (stressContext_t *)arg;
+    uint32_t sent = 0;
+    uint32_t round = 0;
+
+    while (sent < STRESS_BYTES) {
+        if (!ringBufferFree(&ctx->rb)) {
+            sched_yield();
+        }
+        // alternate between the three ways of producing so they all see contention
+        switch (round++ % 3) {
+        case 0:
+            if (ringBufferPushByte(&ctx->rb, stressPattern(sent))) {
+                sent++;
+            }
+            break;
+        case 1: {
+            uint8_t chunk[37];
+            const uint32_t len = MIN(sizeof(chunk), (uint32_t)(STRESS_BYTES - sent));
+            for (uint32_t i = 0; i < len; i++) {
+                chunk[i] = stressPattern(sent + i);
+            }
+            sent += ringBufferPush(&ctx->rb, chunk, len);
+            break;
+        }
+        default: {
+            uint8_t *data;
+            uint32_t len = ringBufferReserve(&ctx->rb, &data);
+            len = MIN(len, (uint32_t)(STRESS_BYTES - sent));
+            for (uint32_t i = 0; i < len; i++) {
+                data[i] = stressPattern(sent + i);
+            }
+            ringBufferCommit(&ctx->rb, len);
+            sent += len;
+            break;
+        }
+        }
+    }
+    return NULL;
+}
+
+static void *stressConsumer(void *arg)
+{
+    stressContext_t *ctx = (stressContext_t *)arg;
+    uint32_t received = 0;
+    uint32_t round = 0;
+
+    while (received < STRESS_BYTES) {
+        if (ringBufferIsEmpty(&ctx->rb)) {
+            sched_yield();
+        }
+        switch (round++ % 3) {
+        case 0: {
+            uint8_t byte;
+            if (ringBufferPopByte(&ctx->rb, &byte)) {
+                ctx->errors += byte != stressPattern(received);
+                received++;
+            }
+            break;
+        }
+        case 1: {
+            uint8_t chunk[53];
+            const uint32_t len = ringBufferPop(&ctx->rb, chunk, sizeof(chunk));
+            for (uint32_t i = 0; i < len; i++) {
+                ctx->errors += chunk[i] != stressPattern(received + i);
+            }
+            received += len;
+            break;
+        }
+        default: {
+            const uint8_t *data;
+            const uint32_t len = ringBufferPeek(&ctx->rb, &data);
+            for (uint32_t i = 0; i < len; i++) {
+                ctx->errors += data[i] != stressPattern(received + i);
+            }
+            ringBufferConsume(&ctx->rb, len);
+            received += len;
+            break;
+        }
+        }
+    }
+    return NULL;
+}
+
+TEST(RingBufferUnittest, TestThreadedProducerConsumer)
+{
+    static stressContext_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ringBufferInit(&ctx.rb, ctx.buffer, sizeof(ctx.buffer));
+
+    pthread_t producer;
+    pthread_t consumer;
+    ASSERT_EQ(0, pthread_create(&consumer, NULL, stressConsumer, &ctx));
+    ASSERT_EQ(0, pthread_create(&producer, NULL, stressProducer, &ctx));
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    EXPECT_EQ(0u, ctx.errors);
+    EXPECT_TRUE(ringBufferIsEmpty(&ctx.rb));
+}
@@ -0,0 +1,181 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/axis.h"
+    #include "common/maths.h"
+
+    #include "drivers/pwm_output.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    #include "flight/mixer.h"
+    #include "flight/pid.h"
+    #include "flight/rpm_filter.h"
+
+    #include "sensors/gyro.h"
+
+    PG_REGISTER(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 0);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define LOOPTIME_US     125
+#define POLE_COUNT      14
+
+static uint16_t simulatedTelemetry[MAX_SUPPORTED_MOTORS];
+
+static void setMotorHz(int motor, float hz)
+{
+    // eRPM / 100
+    simulatedTelemetry[motor] = lrintf(hz * 60 * (POLE_COUNT / 2) / 100);
+}
+
+static void setup(bool telemetry)
+{
+    useDshotTelemetry = telemetry;
+    gyro.targetLooptime = LOOPTIME_US;
+    targetPidLooptime = LOOPTIME_US;
+    pgResetAll();
+    motorConfigMutable()->motorPoleCount = POLE_COUNT;
+
+    setMotorHz(0, 200);
+    setMotorHz(1, 230);
+    setMotorHz(2, 260);
+    setMotorHz(3, 290);
+
+    rpmFilterInit(rpmFilterConfig());
+}
+
+// amplitude of a sine on the roll gyro after the filter has settled
+static float filteredAmplitude(float hz)
+{
+    float peak = 0;
+
+    for (int i = 0; i < 16000; i++) {
+        rpmFilterUpdate();
+        const float in = 100.0f * sinf(2 * M_PIf * hz * i * LOOPTIME_US * 1e-6f);
+        const float out = rpmFilterGyro(0, FD_ROLL, in);
+        if (i >= 12000) {
+            peak = MAX(peak, fabsf(out));
+        }
+    }
+
+    return peak / 100.0f;
+}
+
+TEST(RpmFilterUnittest, TestOffWithoutTelemetry)
+{
+    setup(false);
+
+    EXPECT_FALSE(isRpmFilterEnabled());
+    EXPECT_FLOAT_EQ(12.5f, rpmFilterGyro(0, FD_ROLL, 12.5f));
+}
+
+TEST(RpmFilterUnittest, TestMotorFrequencies)
+{
+    setup(true);
+
+    EXPECT_TRUE(isRpmFilterEnabled());
+    for (int i = 0; i < 1000; i++) {
+        rpmFilterUpdate();
+    }
+    EXPECT_NEAR(200.0f, rpmFilterGetMotorFrequencyHz(0), 1.0f);
+    EXPECT_NEAR(290.0f, rpmFilterGetMotorFrequencyHz(3), 1.0f);
+}
+
+TEST(RpmFilterUnittest, TestNotchesFollowMotors)
+{
+    setup(true);
+
+    // fundamentals and harmonics are taken out, what lies between the motor lines gets through
+    EXPECT_LT(filteredAmplitude(230), 0.05f);
+    EXPECT_LT(filteredAmplitude(400), 0.05f);
+    EXPECT_LT(filteredAmplitude(870), 0.05f);
+    EXPECT_GT(filteredAmplitude(90), 0.8f);
+
+    // the notches move along when a motor speeds up
+    setMotorHz(1, 330);
+    EXPECT_LT(filteredAmplitude(330), 0.05f);
+}
+
+TEST(RpmFilterUnittest, TestGyrosFilteredSeparately)
+{
+    setup(true);
+
+    // both gyros get the same notches, but each keeps its own filter state
+    float peak[2] = { 0, 0 };
+    for (int i = 0; i < 16000; i++) {
+        rpmFilterUpdate();
+        const float t = i * LOOPTIME_US * 1e-6f;
+        const float out0 = rpmFilterGyro(0, FD_ROLL, 100.0f * sinf(2 * M_PIf * 230 * t));
+        const float out1 = rpmFilterGyro(1, FD_ROLL, 100.0f * sinf(2 * M_PIf * 90 * t));
+        if (i >= 12000) {
+            peak[0] = MAX(peak[0], fabsf(out0));
+            peak[1] = MAX(peak[1], fabsf(out1));
+        }
+    }
+
+    EXPECT_LT(peak[0] / 100.0f, 0.05f);
+    EXPECT_GT(peak[1] / 100.0f, 0.8f);
+}
+
+TEST(RpmFilterUnittest, TestMinimumFrequency)
+{
+    setup(true);
+
+    // a stopped motor, or one whose telemetry timed out and reads 0, has no notch at all rather than
+    // one parked at the minimum frequency
+    setMotorHz(0, 0);
+    EXPECT_GT(filteredAmplitude(rpmFilterConfig()->gyro_rpm_notch_min), 0.9f);
+    EXPECT_GT(filteredAmplitude(20), 0.9f);
+
+    // the same goes for a motor turning below the minimum, while its harmonics above it are notched
+    setMotorHz(0, 80);
+    EXPECT_GT(filteredAmplitude(80), 0.9f);
+    EXPECT_LT(filteredAmplitude(160), 0.05f);
+}
+
+extern "C" {
+
+int16_t debug[DEBUG16_VALUE_COUNT];
+uint8_t debugMode;
+
+gyro_t gyro;
+uint32_t targetPidLooptime;
+bool useDshotTelemetry;
+volatile bool isSetpointNew;
+
+float getSetpointRate(int) { return 0.0f; }
+
+uint8_t getMotorCount(void) { return 4; }
+uint16_t getDshotTelemetry(uint8_t index) { return simulatedTelemetry[index]; }
+
+}
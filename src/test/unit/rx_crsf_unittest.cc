@@ -17,6 +17,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include <limits.h>
 #include <algorithm>
@@ -42,6 +43,7 @@ extern "C" {
     #include "telemetry/msp_shared.h"
 
     void crsfDataReceive(uint16_t c);
+    void crsfDataReceiveSpan(const uint8_t *data, int len, void *callbackData);
     uint8_t crsfFrameCRC(void);
     uint8_t crsfFrameStatus(void);
     uint16_t crsfReadRawRC(const rxRuntimeConfig_t *rxRuntimeConfig, uint8_t chan);
@@ -277,6 +279,28 @@ TEST(CrossFireTest, TestCrsfDataReceive)
     EXPECT_EQ(crc, crsfFrame.frame.payload[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE]);
 }
 
+TEST(CrossFireTest, TestCrsfDataReceiveSpan)
+{
+    // a whole frame delivered at once, as the UART RX DMA idle interrupt does
+    memset(&crsfFrame, 0, sizeof(crsfFrame));
+    crsfFrameDone = false;
+    dummyTimeUs += 10000;
+    crsfDataReceiveSpan(capturedData, sizeof(crsfRcChannelsFrame_t), NULL);
+    EXPECT_EQ(true, crsfFrameDone);
+    EXPECT_EQ(0, memcmp(capturedData, crsfFrame.bytes, sizeof(crsfRcChannelsFrame_t)));
+
+    // a frame split over two spans is reassembled byte by byte
+    memset(&crsfFrame, 0, sizeof(crsfFrame));
+    crsfFrameDone = false;
+    dummyTimeUs += 10000;
+    const uint8_t *secondFrame = capturedData + sizeof(crsfRcChannelsFrame_t);
+    crsfDataReceiveSpan(secondFrame, 10, NULL);
+    EXPECT_EQ(false, crsfFrameDone);
+    crsfDataReceiveSpan(secondFrame + 10, sizeof(crsfRcChannelsFrame_t) - 10, NULL);
+    EXPECT_EQ(true, crsfFrameDone);
+    EXPECT_EQ(0, memcmp(secondFrame, crsfFrame.bytes, sizeof(crsfRcChannelsFrame_t)));
+}
+
 // STUBS
 
 extern "C" {
@@ -161,4 +161,7 @@ timeDelta_t getGyroUpdateRate(void) {return gyro.targetLooptime;}
 void sensorsSet(uint32_t) {}
 void schedulerResetTaskStatistics(cfTaskId_e) {}
 int getArmingDisableFlags(void) {return 0;}
+uint8_t armingFlags = 0;
+volatile bool isSetpointNew;
+float getSetpointRate(int) {return 0.0f;}
 }
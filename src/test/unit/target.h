@@ -51,6 +51,8 @@
 #define USE_LED_STRIP
 #define USE_TRANSPONDER
 #define USE_VCP
+#define USE_CRC_TABLE
+#define USE_CRC_SLICE_BY_4
 #define USE_UART1
 #define USE_UART2
 #define USE_UART3
@@ -67,6 +67,15 @@ extern "C" {
     int32_t testAmperage = 0;
     int32_t testmAhDrawn = 0;
 
+    int serialWriteBufCount;
+    int serialWriteBufLen;
+    int attitudeFramesWritten;
+    uint32_t dummyTimeUs;
+
+    void crsfDataReceiveSpan(const uint8_t *data, int len, void *callbackData);
+    serialPort_t *openSerialPortResult;
+    serialPortConfig_t *findSerialPortConfigResult;
+
     serialPort_t *telemetrySharedPort;
     PG_REGISTER(batteryConfig_t, batteryConfig, PG_BATTERY_CONFIG, 0);
     PG_REGISTER(telemetryConfig_t, telemetryConfig, PG_TELEMETRY_CONFIG, 0);
@@ -273,6 +282,115 @@ TEST(TelemetryCrsfTest, TestFlightMode)
     EXPECT_EQ(crfsCrc(frame, frameLen), frame[7]);
 }
 
+static serialPortConfig_t crsfPortConfig;
+static serialPort_t crsfPort;
+
+static void initCrsfLink(bool batch)
+{
+    rxRuntimeConfig_t rxRuntimeConfig;
+    findSerialPortConfigResult = &crsfPortConfig;
+    openSerialPortResult = &crsfPort;
+    sensorsSet(SENSOR_ACC);
+    telemetryConfigMutable()->crsf_telemetry_batch = batch;
+    EXPECT_TRUE(crsfRxInit(rxConfig(), &rxRuntimeConfig));
+    initCrsfTelemetry();
+    serialWriteBufCount = 0;
+    serialWriteBufLen = 0;
+}
+
+TEST(TelemetryCrsfTest, TestOneFramePerWindow)
+{
+    uint8_t frame[CRSF_FRAME_SIZE_MAX];
+    initCrsfLink(false);
+
+    // the battery frame has the highest priority
+    handleCrsfTelemetry(100000);
+    crsfRxSendTelemetryData();
+    EXPECT_EQ(1, serialWriteBufCount);
+    EXPECT_EQ(getCrsfFrame(frame, CRSF_FRAMETYPE_BATTERY_SENSOR), serialWriteBufLen);
+}
+
+#define RC_FRAME_INTERVAL_US 6667 // 150Hz
+
+static void receiveRcFrame(uint32_t timeUs)
+{
+    uint8_t rcFrame[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + 4] = { CRSF_ADDRESS_FLIGHT_CONTROLLER, CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + 2, CRSF_FRAMETYPE_RC_CHANNELS_PACKED };
+    dummyTimeUs = timeUs;
+    crsfDataReceiveSpan(rcFrame, sizeof(rcFrame), NULL);
+}
+
+static void runTelemetry(uint32_t timeUs)
+{
+    dummyTimeUs = timeUs;
+    handleCrsfTelemetry(timeUs);
+}
+
+TEST(TelemetryCrsfTest, TestBatchedWindow)
+{
+    uint8_t frame[CRSF_FRAME_SIZE_MAX];
+    initCrsfLink(true);
+
+    const int expectedLen = getCrsfFrame(frame, CRSF_FRAMETYPE_ATTITUDE)
+        + getCrsfFrame(frame, CRSF_FRAMETYPE_BATTERY_SENSOR)
+        + getCrsfFrame(frame, CRSF_FRAMETYPE_FLIGHT_MODE)
+        + getCrsfFrame(frame, CRSF_FRAMETYPE_GPS);
+
+    // the window is sized from the gap between two RC frames: 6667us less the 26 byte RC frame
+    // and the margin leaves 241 bytes
+    receiveRcFrame(1000000);
+    receiveRcFrame(1000000 + RC_FRAME_INTERVAL_US);
+    EXPECT_EQ(241, crsfRxTelemetryBytesFree());
+
+    // all four frames are due and go out back to back in a single write
+    runTelemetry(1000000 + RC_FRAME_INTERVAL_US + 100);
+    EXPECT_EQ(241 - expectedLen, crsfRxTelemetryBytesFree());
+    runTelemetry(1000000 + RC_FRAME_INTERVAL_US + 200);
+    EXPECT_EQ(1, serialWriteBufCount);
+    EXPECT_EQ(expectedLen, serialWriteBufLen);
+
+    // nothing more until the next RC frame
+    runTelemetry(1000000 + RC_FRAME_INTERVAL_US + 300);
+    EXPECT_EQ(1, serialWriteBufCount);
+}
+
+TEST(TelemetryCrsfTest, TestBatchedWindowMissed)
+{
+    initCrsfLink(true);
+
+    receiveRcFrame(2000000);
+    receiveRcFrame(2000000 + RC_FRAME_INTERVAL_US);
+    attitude.values.roll++;
+    runTelemetry(2000000 + RC_FRAME_INTERVAL_US + 100);
+    EXPECT_EQ(0, serialWriteBufCount);
+
+    // too late to fit in before the next RC frame, the frames stay queued
+    runTelemetry(2000000 + 2 * RC_FRAME_INTERVAL_US - 500);
+    EXPECT_EQ(0, serialWriteBufCount);
+
+    receiveRcFrame(2000000 + 2 * RC_FRAME_INTERVAL_US);
+    runTelemetry(2000000 + 2 * RC_FRAME_INTERVAL_US + 100);
+    EXPECT_EQ(1, serialWriteBufCount);
+}
+
+TEST(TelemetryCrsfTest, TestBatchedAttitudeRate)
+{
+    initCrsfLink(true);
+    attitudeFramesWritten = 0;
+
+    // one second of RC frames, the attitude goes out at its batched rate rather than at the 20Hz it
+    // gets without batching
+    uint32_t timeUs = 3000000;
+    for (int i = 0; i < 150; i++) {
+        timeUs += RC_FRAME_INTERVAL_US;
+        receiveRcFrame(timeUs);
+        attitude.values.roll = i;
+        runTelemetry(timeUs + 100);
+        runTelemetry(timeUs + 200);
+    }
+    EXPECT_LE(49, attitudeFramesWritten);
+    EXPECT_GE(51, attitudeFramesWritten);
+}
+
 // STUBS
 
 extern "C" {
@@ -291,7 +409,7 @@ gpsSolutionData_t gpsSol;
 
 void beeperConfirmationBeeps(uint8_t beepCount) {UNUSED(beepCount);}
 
-uint32_t micros(void) {return 0;}
+uint32_t micros(void) {return dummyTimeUs;}
 
 bool feature(uint32_t) {return true;}
 
@@ -299,13 +417,23 @@ uint32_t serialRxBytesWaiting(const serialPort_t *) {return 0;}
 uint32_t serialTxBytesFree(const serialPort_t *) {return 0;}
 uint8_t serialRead(serialPort_t *) {return 0;}
 void serialWrite(serialPort_t *, uint8_t) {}
-void serialWriteBuf(serialPort_t *, const uint8_t *, int) {}
+void serialWriteBuf(serialPort_t *, const uint8_t *data, int count)
+{
+    serialWriteBufCount++;
+    serialWriteBufLen = count;
+    for (int i = 0; i < count; i += data[i + 1] + 2) {
+        if (data[i + 2] == CRSF_FRAMETYPE_ATTITUDE) {
+            attitudeFramesWritten++;
+        }
+    }
+}
 void serialSetMode(serialPort_t *, portMode_e) {}
-serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) {return NULL;}
+void serialSetRxSpanCallback(serialPort_t *, serialReceiveSpanCallbackPtr) {}
+serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) {return openSerialPortResult;}
 void closeSerialPort(serialPort_t *) {}
 bool isSerialTransmitBufferEmpty(const serialPort_t *) { return true; }
 
-serialPortConfig_t *findSerialPortConfig(serialPortFunction_e) {return NULL;}
+serialPortConfig_t *findSerialPortConfig(serialPortFunction_e) {return findSerialPortConfigResult;}
 
 bool telemetryDetermineEnabledState(portSharing_e) {return true;}
 bool telemetryCheckRxPortShared(const serialPortConfig_t *) {return true;}
@@ -0,0 +1,183 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "telemetry/telemetry_scheduler.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define ITEM_COUNT 4
+
+static telemetrySchedulerItem_t items[ITEM_COUNT];
+static telemetryScheduler_t scheduler;
+
+// run the scheduler with one slot every slotUs and count how often each item gets it
+static void runSlots(timeUs_t startUs, timeUs_t durationUs, timeUs_t slotUs, int sent[ITEM_COUNT])
+{
+    timeUs_t t = startUs;
+    for (timeUs_t slot = 0; slot < durationUs / slotUs; slot++, t += slotUs) {
+        const int index = telemetrySchedulerNext(&scheduler, t, 255);
+        if (index >= 0) {
+            telemetrySchedulerMarkSent(&scheduler, index, t);
+            sent[index]++;
+        }
+    }
+}
+
+TEST(TelemetrySchedulerUnittest, TestAddLimits)
+{
+    telemetrySchedulerInit(&scheduler, items, 2, false);
+
+    EXPECT_FALSE(telemetrySchedulerAdd(&scheduler, 1, 0, TELEMETRY_PRIORITY_LOW, 1));
+    EXPECT_TRUE(telemetrySchedulerAdd(&scheduler, 1, 10, TELEMETRY_PRIORITY_LOW, 1));
+    EXPECT_TRUE(telemetrySchedulerAdd(&scheduler, 2, 10, TELEMETRY_PRIORITY_LOW, 1));
+    EXPECT_FALSE(telemetrySchedulerAdd(&scheduler, 3, 10, TELEMETRY_PRIORITY_LOW, 1));
+    EXPECT_EQ(2, scheduler.count);
+    EXPECT_EQ(100000, items[0].intervalUs);
+}
+
+TEST(TelemetrySchedulerUnittest, TestPriorityAndBudget)
+{
+    telemetrySchedulerInit(&scheduler, items, ITEM_COUNT, false);
+    telemetrySchedulerAdd(&scheduler, 10, 10, TELEMETRY_PRIORITY_LOW, 4);
+    telemetrySchedulerAdd(&scheduler, 20, 10, TELEMETRY_PRIORITY_HIGH, 12);
+    telemetrySchedulerAdd(&scheduler, 30, 10, TELEMETRY_PRIORITY_MEDIUM, 8);
+
+    const timeUs_t now = 1000;
+    EXPECT_EQ(1, telemetrySchedulerNext(&scheduler, now, 255));
+    // the high priority item doesn't fit, medium is next best
+    EXPECT_EQ(2, telemetrySchedulerNext(&scheduler, now, 10));
+    EXPECT_EQ(0, telemetrySchedulerNext(&scheduler, now, 4));
+    EXPECT_EQ(-1, telemetrySchedulerNext(&scheduler, now, 3));
+
+    for (int i = 0; i < 3; i++) {
+        telemetrySchedulerMarkSent(&scheduler, i, now);
+    }
+    // nothing is due, and idle slots are not filled
+    EXPECT_EQ(-1, telemetrySchedulerNext(&scheduler, now + 50000, 255));
+    EXPECT_EQ(1, telemetrySchedulerNext(&scheduler, now + 100000, 255));
+}
+
+TEST(TelemetrySchedulerUnittest, TestRatesWithSpareBandwidth)
+{
+    telemetrySchedulerInit(&scheduler, items, ITEM_COUNT, false);
+    telemetrySchedulerAdd(&scheduler, 1, 10, TELEMETRY_PRIORITY_HIGH, 1);
+    telemetrySchedulerAdd(&scheduler, 2, 5, TELEMETRY_PRIORITY_MEDIUM, 1);
+    telemetrySchedulerAdd(&scheduler, 3, 2, TELEMETRY_PRIORITY_LOW, 1);
+    telemetrySchedulerAdd(&scheduler, 4, 1, TELEMETRY_PRIORITY_LOW, 1);
+
+    int sent[ITEM_COUNT] = { 0 };
+    runSlots(0, 10000000, 5000, sent);  // 200 slots per second, far more than needed
+
+    EXPECT_NEAR(100, sent[0], 2);
+    EXPECT_NEAR(50, sent[1], 2);
+    EXPECT_NEAR(20, sent[2], 2);
+    EXPECT_NEAR(10, sent[3], 2);
+}
+
+TEST(TelemetrySchedulerUnittest, TestCongestedLinkFavoursPriorityWithoutStarving)
+{
+    telemetrySchedulerInit(&scheduler, items, ITEM_COUNT, false);
+    telemetrySchedulerAdd(&scheduler, 1, 20, TELEMETRY_PRIORITY_HIGH, 1);
+    telemetrySchedulerAdd(&scheduler, 2, 20, TELEMETRY_PRIORITY_MEDIUM, 1);
+    telemetrySchedulerAdd(&scheduler, 3, 20, TELEMETRY_PRIORITY_LOW, 1);
+    telemetrySchedulerAdd(&scheduler, 4, 20, TELEMETRY_PRIORITY_LOW, 1);
+
+    int sent[ITEM_COUNT] = { 0 };
+    runSlots(0, 10000000, 40000, sent);  // 25 slots per second for 80 requested
+
+    // the high priority item keeps most of its rate, nothing is starved
+    EXPECT_GT(sent[0], 150);
+    EXPECT_GT(sent[1], sent[2]);
+    EXPECT_GT(sent[2], 0);
+    EXPECT_GT(sent[3], 0);
+    EXPECT_EQ(250, sent[0] + sent[1] + sent[2] + sent[3]);
+}
+
+TEST(TelemetrySchedulerUnittest, TestSetInterval)
+{
+    telemetrySchedulerInit(&scheduler, items, ITEM_COUNT, true);
+    telemetrySchedulerAdd(&scheduler, 1, 10, TELEMETRY_PRIORITY_HIGH, 1);
+    telemetrySchedulerAdd(&scheduler, 2, 10, TELEMETRY_PRIORITY_LOW, 1);
+
+    // a switched off item isn't handed out, not even to fill idle slots
+    telemetrySchedulerSetInterval(&scheduler, 0, 0);
+    int sent[ITEM_COUNT] = { 0 };
+    runSlots(0, 1000000, 10000, sent);
+    EXPECT_EQ(0, sent[0]);
+    EXPECT_EQ(100, sent[1]);
+
+    // back on at a different rate
+    scheduler.fillIdle = false;
+    telemetrySchedulerSetInterval(&scheduler, 0, 20000);
+    sent[0] = sent[1] = 0;
+    runSlots(1000000, 1000000, 5000, sent);
+    EXPECT_NEAR(50, sent[0], 1);
+    EXPECT_NEAR(10, sent[1], 1);
+}
+
+TEST(TelemetrySchedulerUnittest, TestFillIdleSlots)
+{
+    telemetrySchedulerInit(&scheduler, items, ITEM_COUNT, true);
+    telemetrySchedulerAdd(&scheduler, 1, 10, TELEMETRY_PRIORITY_HIGH, 1);
+    telemetrySchedulerAdd(&scheduler, 2, 2, TELEMETRY_PRIORITY_LOW, 1);
+
+    int sent[ITEM_COUNT] = { 0 };
+    runSlots(0, 10000000, 10000, sent);
+
+    // every slot is used, shared out in proportion to the requested rates
+    EXPECT_EQ(1000, sent[0] + sent[1]);
+    EXPECT_NEAR(5.0f, (float)sent[0] / sent[1], 0.5f);
+}
+
+TEST(TelemetrySchedulerUnittest, TestSkipUnchangedWithKeepalive)
+{
+    telemetrySchedulerInit(&scheduler, items, ITEM_COUNT, false);
+    telemetrySchedulerAdd(&scheduler, 1, 10, TELEMETRY_PRIORITY_HIGH, 1);
+
+    EXPECT_TRUE(telemetrySchedulerValueChanged(&scheduler, 0, 42, 1000));
+    EXPECT_FALSE(telemetrySchedulerValueChanged(&scheduler, 0, 42, 100000));
+    EXPECT_TRUE(telemetrySchedulerValueChanged(&scheduler, 0, 43, 200000));
+    EXPECT_FALSE(telemetrySchedulerValueChanged(&scheduler, 0, 43, 200000 + TELEMETRY_SCHEDULER_KEEPALIVE_US - 1));
+    EXPECT_TRUE(telemetrySchedulerValueChanged(&scheduler, 0, 43, 200000 + TELEMETRY_SCHEDULER_KEEPALIVE_US));
+}
+
+TEST(TelemetrySchedulerUnittest, TestTimerWrap)
+{
+    telemetrySchedulerInit(&scheduler, items, ITEM_COUNT, false);
+    telemetrySchedulerAdd(&scheduler, 1, 10, TELEMETRY_PRIORITY_LOW, 1);
+
+    // an item that was never sent is due even once the timer is far from zero
+    const timeUs_t now = (timeUs_t)0x90000000;
+    EXPECT_EQ(0, telemetrySchedulerNext(&scheduler, now, 255));
+    telemetrySchedulerMarkSent(&scheduler, 0, now);
+    EXPECT_EQ(-1, telemetrySchedulerNext(&scheduler, now + 1, 255));
+
+    int sent[ITEM_COUNT] = { 0 };
+    runSlots(UINT32_MAX - 500000, 1000000, 10000, sent);
+    EXPECT_NEAR(10, sent[0], 1);
+}